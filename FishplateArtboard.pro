@@ -1,78 +1,28 @@
-QT       += core gui svg
-
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets sql network
-
-CONFIG += c++17
-
-# You can make your code fail to compile if it uses deprecated APIs.
-# In order to do so, uncomment the following line.
-#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
-
-
-
-RC_ICON = app_icon.ico
-
-
-
-SOURCES += \
-    abstractshape.cpp \
-    addmultipleshapescommand.cpp \
-    addshapecommand.cpp \
-    aipromptdialog.cpp \
-    artboardview.cpp \
-    clearallcommand.cpp \
-    deletemultipleshapescommand.cpp \
-    deleteshapecommand.cpp \
-    ellipseshape.cpp \
-    eraserpathshape.cpp \
-    freehandpathshape.cpp \
-    groupcommand.cpp \
-    groupshape.cpp \
-    lineshape.cpp \
-    main.cpp \
-    mainwindow.cpp \
-    movemultipleshapescommand.cpp \
-    moveshapecommand.cpp \
-    rectangleshape.cpp \
-    resizecommand.cpp \
-    rotatecommand.cpp \
-    starshape.cpp \
-    ungroupcommand.cpp
-
-HEADERS += \
-    abstractcommand.h \
-    abstractshape.h \
-    addmultipleshapescommand.h \
-    addshapecommand.h \
-    aipromptdialog.h \
-    artboardview.h \
-    clearallcommand.h \
-    deletemultipleshapescommand.h \
-    deleteshapecommand.h \
-    ellipseshape.h \
-    eraserpathshape.h \
-    freehandpathshape.h \
-    groupcommand.h \
-    groupshape.h \
-    lineshape.h \
-    mainwindow.h \
-    movemultipleshapescommand.h \
-    moveshapecommand.h \
-    rectangleshape.h \
-    resizecommand.h \
-    rotatecommand.h \
-    shared_types.h \
-    starshape.h \
-    ungroupcommand.h
-
-FORMS += \
-    aipromptdialog.ui \
-    mainwindow.ui
-
-# Default rules for deployment.
-qnx: target.path = /tmp/$${TARGET}/bin
-else: unix:!android: target.path = /opt/$${TARGET}/bin
-!isEmpty(target.path): INSTALLS += target
-
-RESOURCES += \
-    resources.qrc
+# ---------------------------------------------------------------------------
+# 顶层工程：
+#   core              fishplatecore 静态库：图形、命令、文档模型和文件读写，不依赖 QWidget
+#   app               FishplateArtboard 图形界面程序
+#   tools/fparender   不创建任何窗口的 .fpa 批量渲染工具
+#   tests/bench       绘制、点击测试、命令和文件读写的基准测试
+#   tests/unit        单元测试
+# 其余各项都通过 fishplatecore.pri 链接 core。
+# ---------------------------------------------------------------------------
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    core \
+    app \
+    fparender \
+    bench \
+    unit
+
+core.file = core/core.pro
+app.file = app/app.pro
+app.depends = core
+fparender.file = tools/fparender/fparender.pro
+fparender.depends = core
+bench.file = tests/bench/bench.pro
+bench.depends = core
+unit.file = tests/unit/unit.pro
+unit.depends = core
@@ -6,6 +6,10 @@
 //       所有具体的操作（如添加图形、删除图形等）都将作为该类的派生类实现。
 // ---------------------------------------------------------------------------
 
+#include <QSet>
+
+class AbstractShape;
+
 /// @brief AbstractCommand 是所有具体命令的抽象基类。
 /// 它为命令模式定义了核心的执行 (execute) 和撤销 (undo) 接口。
 /// 这个类是抽象的，不能被直接实例化，必须由具体的命令类继承并实现其纯虚函数。
@@ -28,6 +32,10 @@ public:
     /// 将系统状态恢复到执行该命令之前的状态。
     virtual void undo() = 0;
 
+    /// @brief 把命令持有指针的所有图形（无论当前是否在文档中）加入 shapes。
+    /// 分页文档释放图形之前用它排除撤销/重做栈中的命令仍然引用的图形，避免留下悬空指针。
+    virtual void collectShapes(QSet<AbstractShape*> *shapes) const = 0;
+
 protected:
     /// @brief 保护的构造函数。
     /// 由于 AbstractCommand 是一个抽象类，
@@ -16,6 +16,34 @@
 #include "eraserpathshape.h"
 #include "groupshape.h"
 
+// 默认的重绘区域：包围盒外扩一个线宽，再留 2 像素给抗锯齿边缘
+// （方头线帽和斜接的角点可能超出半个线宽，因此直接按整个线宽外扩）
+QRect AbstractShape::getDamageRect() const
+{
+    int margin = shapePenWidth + 2;
+    return getBoundingRect().adjusted(-margin, -margin, margin, margin);
+}
+
+void AbstractShape::invalidateCaches()
+{
+    m_inverseRotationValid = false; // 旋转中心随几何变化
+}
+
+const QTransform &AbstractShape::inverseRotation() const
+{
+    if (!m_inverseRotationValid) {
+        // 与各图形 draw() 中的变换一致：绕中心旋转
+        QPointF center = getCenter();
+        QTransform transform;
+        transform.translate(center.x(), center.y());
+        transform.rotate(m_rotationAngle);
+        transform.translate(-center.x(), -center.y());
+        m_inverseRotation = transform.inverted();
+        m_inverseRotationValid = true;
+    }
+    return m_inverseRotation;
+}
+
 // 工厂方法的完整实现
 AbstractShape* AbstractShape::fromJsonObject(const QJsonObject &json)
 {
@@ -56,13 +84,36 @@ AbstractShape* AbstractShape::fromJsonObject(const QJsonObject &json)
         shape = new LineShape(p1, p2, borderColor, penWidth);
     }
     else if (type == "Freehand") {
-        QVector<QPoint> points;
-        QJsonArray pointsArray = geometry["points"].toArray();
-        for (const QJsonValue &val : pointsArray) {
-            QJsonArray pointArray = val.toArray();
-            points.append(QPoint(pointArray[0].toInt(), pointArray[1].toInt()));
+        if (geometry.contains("curves")) {
+            // 曲线模式: [x0, y0, 然后每段 c1x, c1y, c2x, c2y, p3x, p3y]
+            QJsonArray curvesArray = geometry["curves"].toArray();
+            QVector<CubicSegment> curves;
+            if (curvesArray.size() >= 8) {
+                QPointF start(curvesArray[0].toDouble(), curvesArray[1].toDouble());
+                for (int i = 2; i + 6 <= curvesArray.size(); i += 6) {
+                    CubicSegment segment;
+                    segment.p0 = start;
+                    segment.c1 = QPointF(curvesArray[i].toDouble(), curvesArray[i + 1].toDouble());
+                    segment.c2 = QPointF(curvesArray[i + 2].toDouble(), curvesArray[i + 3].toDouble());
+                    segment.p3 = QPointF(curvesArray[i + 4].toDouble(), curvesArray[i + 5].toDouble());
+                    curves.append(segment);
+                    start = segment.p3;
+                }
+            }
+            FreehandPathShape *freehand = new FreehandPathShape(QVector<QPoint>(), borderColor, penWidth);
+            if (!curves.isEmpty()) {
+                freehand->setCurves(curves);
+            }
+            shape = freehand;
+        } else {
+            QVector<QPoint> points;
+            QJsonArray pointsArray = geometry["points"].toArray();
+            for (const QJsonValue &val : pointsArray) {
+                QJsonArray pointArray = val.toArray();
+                points.append(QPoint(pointArray[0].toInt(), pointArray[1].toInt()));
+            }
+            shape = new FreehandPathShape(points, borderColor, penWidth);
         }
-        shape = new FreehandPathShape(points, borderColor, penWidth);
     }
     else if (type == "NormalEraser") {
         QVector<QPoint> points;
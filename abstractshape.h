@@ -2,6 +2,7 @@
 #define ABSTRACTSHAPE_H
 
 #include <QPainter>
+#include <QTransform>
 #include <QColor>
 #include <QPoint>
 #include <QRect>
@@ -22,13 +23,24 @@ public:
         shapePenWidth(penWidth),
         m_isFilled(filled),
         m_shapeFillColor(fillColor),
-        m_rotationAngle(0.0)
+        m_rotationAngle(0.0),
+        m_id(0),
+        m_inverseRotationValid(false)
     {
     }
     virtual ~AbstractShape() {}
 
+    /// @brief 复制一个独立的图形（包括 ID），调用方获得所有权。
+    /// 后台保存在主线程中复制需要写入的图形，编码在工作线程中对副本进行。
+    /// 点集等数据是隐式共享的，复制不会拷贝它们。
+    virtual AbstractShape *clone() const = 0;
+
     virtual void draw(QPainter *painter) = 0;
     virtual QRect getBoundingRect() const = 0;
+
+    /// @brief 获取图形在屏幕上实际会影响到的区域，即按线宽和抗锯齿余量外扩后的包围盒。
+    /// 视图用它来计算局部重绘 (dirty region) 的范围。
+    virtual QRect getDamageRect() const;
     virtual bool containsPoint(const QPoint &point) const = 0;
     virtual void moveBy(const QPoint &offset) = 0;
     virtual void updateShape(const QPoint &point) { Q_UNUSED(point); }
@@ -52,19 +64,42 @@ public:
     bool isFilled() const { return m_isFilled; }
     QColor getFillColor() const { return m_shapeFillColor; }
     void setBorderColor(const QColor &color) { shapeColor = color; }
-    void setPenWidth(int width) { if (width > 0) shapePenWidth = width; }
+    void setPenWidth(int width) { if (width > 0 && width != shapePenWidth) { shapePenWidth = width; invalidateCaches(); } }
     void setFilled(bool filled) { m_isFilled = filled; }
     void setFillColor(const QColor &color) { m_shapeFillColor = color; }
     qreal getRotationAngle() const { return m_rotationAngle; }
-    virtual void setRotationAngle(qreal angle) { m_rotationAngle = angle; }
+    virtual void setRotationAngle(qreal angle) { m_rotationAngle = angle; m_inverseRotationValid = false; }
+
+    /// @brief 图形的持久 ID，也是它在 .fpa 文件 shapes 表中的行号。0 表示尚未分配。
+    /// 由 ArtboardDocument 在图形第一次加入画布时分配，之后一直不变（撤销、重做、编组都保留原 ID），
+    /// 增量保存据此只改写发生变化的行。
+    quint64 getId() const { return m_id; }
+    void setId(quint64 id) { m_id = id; }
 
 protected:
+    /// @brief 几何或线宽改变后调用，丢弃点击测试的缓存。
+    /// 子类的每个几何修改函数都要调用它；重写时必须调用基类版本。
+    virtual void invalidateCaches();
+
+    /// @brief 点击测试的容差半径：半个线宽再加 2 像素，与旧的“按线宽 + 4 描边”范围一致。
+    qreal hitRadius() const { return shapePenWidth / 2.0 + 2.0; }
+
+    /// @brief 缓存的逆旋转变换：把屏幕坐标映射回以 getCenter() 为中心、未旋转的图形坐标。
+    const QTransform &inverseRotation() const;
+
     ShapeType shapeType;
     QColor shapeColor;
     int shapePenWidth;
     bool m_isFilled;
     QColor m_shapeFillColor;
     qreal m_rotationAngle; // 用于存储图形的旋转角度（单位：度）
+    quint64 m_id;
+
+private:
+    // 点击测试缓存。拖动笔画橡皮擦时每次鼠标移动都会对候选图形做点击测试，
+    // 逆矩阵只在几何或旋转角度变化后才重新计算。
+    mutable QTransform m_inverseRotation;
+    mutable bool m_inverseRotationValid;
 };
 
 #endif // ABSTRACTSHAPE_H
@@ -1,9 +1,9 @@
 #include "addmultipleshapescommand.h"
-#include "artboardview.h"
+#include "artboarddocument.h"
 #include "abstractshape.h"
 
-AddMultipleShapesCommand::AddMultipleShapesCommand(const QList<AbstractShape*> &shapes, ArtboardView *view)
-    : m_shapesToAdd(shapes), m_view(view), m_isOwnedByView(false)
+AddMultipleShapesCommand::AddMultipleShapesCommand(const QList<AbstractShape*> &shapes, ArtboardDocument *document)
+    : m_shapesToAdd(shapes), m_document(document), m_isOwnedByView(false)
 {
 }
 
@@ -16,20 +16,29 @@ AddMultipleShapesCommand::~AddMultipleShapesCommand()
 
 void AddMultipleShapesCommand::execute()
 {
-    if (m_view) {
-        m_view->shapesList.append(m_shapesToAdd);
+    if (m_document) {
         m_isOwnedByView = true;
-        m_view->update();
+        for (AbstractShape* shape : m_shapesToAdd) {
+            m_document->appendShape(shape);
+            m_document->updateShapeArea(shape);
+        }
     }
 }
 
 void AddMultipleShapesCommand::undo()
 {
-    if (m_view) {
+    if (m_document) {
         for(AbstractShape* shape : m_shapesToAdd) {
-            m_view->shapesList.removeOne(shape);
+            m_document->updateShapeArea(shape);
+            m_document->removeShape(shape);
         }
         m_isOwnedByView = false;
-        m_view->update();
+    }
+}
+
+void AddMultipleShapesCommand::collectShapes(QSet<AbstractShape*> *shapes) const
+{
+    for (AbstractShape *shape : m_shapesToAdd) {
+        shapes->insert(shape);
     }
 }
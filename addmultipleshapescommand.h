@@ -5,20 +5,21 @@
 #include <QList>
 
 class AbstractShape;
-class ArtboardView;
+class ArtboardDocument;
 
 class AddMultipleShapesCommand : public AbstractCommand
 {
 public:
-    AddMultipleShapesCommand(const QList<AbstractShape*> &shapes, ArtboardView *view);
+    AddMultipleShapesCommand(const QList<AbstractShape*> &shapes, ArtboardDocument *document);
     ~AddMultipleShapesCommand() override;
 
     void execute() override;
     void undo() override;
+    void collectShapes(QSet<AbstractShape*> *shapes) const override;
 
 private:
     QList<AbstractShape*> m_shapesToAdd;
-    ArtboardView *m_view;
+    ArtboardDocument *m_document;
     bool m_isOwnedByView;
 };
 
@@ -0,0 +1,44 @@
+QT       += core gui svg concurrent
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets sql network
+
+CONFIG += c++17
+
+TARGET = FishplateArtboard
+
+# You can make your code fail to compile if it uses deprecated APIs.
+# In order to do so, uncomment the following line.
+#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
+
+include(../fishplatecore.pri)
+
+RC_ICON = ../app_icon.ico
+
+
+
+SOURCES += \
+    ../aipromptdialog.cpp \
+    ../artboardview.cpp \
+    ../inputrecorder.cpp \
+    ../inputreplayer.cpp \
+    ../main.cpp \
+    ../mainwindow.cpp
+
+HEADERS += \
+    ../aipromptdialog.h \
+    ../artboardview.h \
+    ../inputrecorder.h \
+    ../inputreplayer.h \
+    ../mainwindow.h
+
+FORMS += \
+    ../aipromptdialog.ui \
+    ../mainwindow.ui
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
+
+RESOURCES += \
+    ../resources.qrc
@@ -0,0 +1,1274 @@
+#include "artboarddocument.h"
+#include <QDebug>
+#include <QFileInfo>
+#include <QRandomGenerator>
+#include <algorithm>
+#include <climits>
+
+#include "abstractshape.h"
+#include "abstractcommand.h"
+#include "backgroundpyramid.h"
+#include "documentsaver.h"
+#include "fpadatabase.h"
+#include "shapecodec.h"
+
+ArtboardDocument::ArtboardDocument(QObject *parent)
+    : QObject{parent},
+    m_zOrderDirty(false),
+    m_paperColor(Qt::white),
+    m_nextShapeId(1),
+    m_firstReorderedIndex(0),
+    m_documentLoader(new DocumentLoader(this)),
+    m_loadInsertIndex(0),
+    m_documentSaver(new DocumentSaver(this)),
+    m_saveInFlight(false),
+    m_savingJournalToken(0),
+    m_savingJournalSeq(0),
+    m_checkpointInterval(200),
+    m_pagedMode(false),
+    m_pagedDocument(nullptr),
+    m_topZOrder(0),
+    m_background(nullptr),
+    m_backgroundRevision(0),
+    m_savedBackgroundRevision(0),
+    m_savingBackgroundRevision(0)
+{
+    connect(m_documentLoader, &DocumentLoader::shapesLoaded, this, &ArtboardDocument::insertLoadedShapes);
+    connect(m_documentLoader, &DocumentLoader::progress, this, &ArtboardDocument::loadProgress);
+    connect(m_documentSaver, &DocumentSaver::finished, this, [this](bool ok, const QString &filePath) {
+        // waitForPendingSave 已经处理并通知过这次的结果时，这里什么都不做
+        if (!m_saveInFlight) {
+            return;
+        }
+        m_saveInFlight = false;
+        finishSave(filePath, ok);
+        emit saveFinished(ok, filePath);
+        startQueuedSave();
+    });
+    connect(m_documentLoader, &DocumentLoader::finished, this, [this](bool ok) {
+        if (ok) {
+            // 载入期间所做的修改仍然记录在案，下次保存时写入
+            m_documentPath = m_loadingPath;
+        }
+        m_loadingPath.clear();
+        // 载入期间画布可能变大了
+        ensureResident(pagedArea());
+        emit loadFinished(ok);
+        // 文件全部载入之后才能在它上面重放日志
+        if (ok) {
+            resumeJournal(m_documentPath);
+        } else {
+            closePagedDocument();
+            startJournal(m_recoveryJournalPath, 0, 0);
+        }
+    });
+}
+
+ArtboardDocument::~ArtboardDocument()
+{
+    m_documentLoader->cancel();
+    // 正常退出时日志保留，下次打开文件时重放尚未保存的修改；没有记录的日志不必留下
+    closeJournal();
+    clearAllShapes();
+    closePagedDocument();
+    delete m_background;
+}
+
+void ArtboardDocument::clearAllShapes()
+{
+    // 选择装饰要在图形释放之前擦掉
+    setSelectedShapes(QList<AbstractShape*>());
+    const QVector<AbstractShape*> oldShapes = shapesList;
+    replaceAllShapes(QVector<AbstractShape*>());
+    qDeleteAll(oldShapes);
+    clearCommandStacks();
+    invalidateScene();
+}
+
+void ArtboardDocument::updateShapeArea(const AbstractShape *shape)
+{
+    if (!shape) {
+        return;
+    }
+    if (m_spatialIndex.contains(shape)) {
+        // 修改图形之后的这次调用让索引记录新位置
+        m_spatialIndex.insert(const_cast<AbstractShape*>(shape), shape->getDamageRect());
+    }
+    emit shapeAreaChanged(shape);
+}
+
+void ArtboardDocument::invalidateScene()
+{
+    emit sceneChanged();
+}
+
+void ArtboardDocument::setSelectedShapes(const QList<AbstractShape*> &shapes)
+{
+    if (shapes == m_selectedShapes) {
+        return;
+    }
+    const QList<AbstractShape*> previous = m_selectedShapes;
+    m_selectedShapes = shapes;
+    emit selectionChanged(previous);
+}
+
+void ArtboardDocument::deselect(AbstractShape *shape)
+{
+    if (m_selectedShapes.contains(shape)) {
+        QList<AbstractShape*> selection = m_selectedShapes;
+        selection.removeAll(shape);
+        setSelectedShapes(selection);
+    }
+}
+
+QVector<AbstractShape*> ArtboardDocument::shapesInArea(const QRect &area) const
+{
+    QVector<AbstractShape*> result = m_spatialIndex.query(area);
+    std::sort(result.begin(), result.end(), [this](const AbstractShape *a, const AbstractShape *b) {
+        return zOrderOf(a) < zOrderOf(b);
+    });
+    return result;
+}
+
+AbstractShape *ArtboardDocument::shapeAt(const QPoint &point) const
+{
+    QVector<AbstractShape*> candidates = m_spatialIndex.query(point);
+    std::sort(candidates.begin(), candidates.end(), [this](const AbstractShape *a, const AbstractShape *b) {
+        return zOrderOf(a) > zOrderOf(b);
+    });
+    for (AbstractShape *shape : candidates) {
+        if (shape->getType() != ShapeType::NormalEraser && shape->containsPoint(point)) {
+            return shape;
+        }
+    }
+    return nullptr;
+}
+
+QRect ArtboardDocument::contentBounds() const
+{
+    QRect bounds;
+    for (AbstractShape *shape : shapesList) {
+        if (shape) bounds |= shape->getDamageRect();
+    }
+    return bounds;
+}
+
+int ArtboardDocument::zOrderOf(const AbstractShape *shape) const
+{
+    if (m_zOrderDirty) {
+        m_zOrder.clear();
+        m_zOrder.reserve(shapesList.size());
+        for (int i = 0; i < shapesList.size(); ++i) {
+            m_zOrder.insert(shapesList.at(i), i);
+        }
+        m_zOrderDirty = false;
+    }
+    return m_zOrder.value(shape, -1);
+}
+
+void ArtboardDocument::insertShape(int index, AbstractShape *shape)
+{
+    if (!shape) {
+        return;
+    }
+    index = qBound(0, index, int(shapesList.size()));
+    const bool atEnd = (index == shapesList.size());
+    shapesList.insert(index, shape);
+    m_spatialIndex.insert(shape, shape->getDamageRect());
+    trackInsertedShape(shape, index);
+    if (atEnd && !m_zOrderDirty) {
+        m_zOrder.insert(shape, index); // 追加是最常见的情况，不必重新编号
+    } else {
+        m_zOrderDirty = true;
+    }
+}
+
+bool ArtboardDocument::removeShape(AbstractShape *shape)
+{
+    int index = shapesList.indexOf(shape);
+    if (index < 0) {
+        return false;
+    }
+    const bool atEnd = (index == shapesList.size() - 1);
+    shapesList.remove(index);
+    m_spatialIndex.remove(shape);
+    trackRemovedShape(shape, index);
+    if (atEnd && !m_zOrderDirty) {
+        m_zOrder.remove(shape);
+    } else {
+        m_zOrderDirty = true;
+    }
+    return true;
+}
+
+void ArtboardDocument::replaceAllShapes(const QVector<AbstractShape*> &shapes)
+{
+    for (int i = shapesList.size() - 1; i >= 0; --i) {
+        if (shapesList.at(i)) {
+            trackRemovedShape(shapesList.at(i), i);
+        }
+    }
+    shapesList = shapes;
+    m_spatialIndex.clear();
+    for (int i = 0; i < shapesList.size(); ++i) {
+        AbstractShape *shape = shapesList.at(i);
+        if (shape) {
+            m_spatialIndex.insert(shape, shape->getDamageRect());
+            trackInsertedShape(shape, i);
+        }
+    }
+    m_zOrder.clear();
+    m_zOrderDirty = true;
+}
+
+// 新加入的图形分配持久 ID（撤销后重新加入的图形保留原 ID），下次保存时写入
+void ArtboardDocument::trackInsertedShape(AbstractShape *shape, int index)
+{
+    if (shape->getId() == 0) {
+        shape->setId(m_nextShapeId++);
+    } else {
+        m_nextShapeId = qMax(m_nextShapeId, shape->getId() + 1);
+    }
+    m_deletedShapeIds.remove(shape->getId());
+    m_modifiedShapes.insert(shape);
+    m_pagedShapes.remove(shape);
+    m_firstReorderedIndex = qMin(m_firstReorderedIndex, index);
+    const AbstractShape *below = (index > 0) ? shapesList.at(index - 1) : nullptr;
+    recordJournalOp(CommandJournal::Put, shape, below ? below->getId() : 0);
+    if (index < m_loadInsertIndex) {
+        ++m_loadInsertIndex;
+    }
+}
+
+// 移除的图形如果已经写入文件，下次保存时删除它所在的行。
+// 删除不会改变其余图形的相对顺序，它们的 z_order 不需要改写。
+void ArtboardDocument::trackRemovedShape(AbstractShape *shape, int index)
+{
+    m_modifiedShapes.remove(shape);
+    m_pagedShapes.remove(shape);
+    recordJournalOp(CommandJournal::Remove, shape);
+    if (m_savedZOrder.contains(shape->getId())) {
+        m_deletedShapeIds.insert(shape->getId());
+    }
+    if (index < m_firstReorderedIndex) {
+        --m_firstReorderedIndex;
+    }
+    if (index < m_loadInsertIndex) {
+        --m_loadInsertIndex;
+    }
+}
+
+// 后台载入送来的一批图形。它们按文件中的顺序插在已载入的图形之后、载入期间新加入的图形之前，
+// 并且与文件内容一致，不记为需要保存的修改。
+void ArtboardDocument::insertLoadedShapes(const QVector<DocumentLoader::LoadedShape> &batch)
+{
+    QRect damage;
+    for (const DocumentLoader::LoadedShape &loaded : batch) {
+        const int index = m_loadInsertIndex;
+        const int firstReordered = m_firstReorderedIndex;
+        insertShape(index, loaded.shape);
+        ++m_loadInsertIndex;
+        m_modifiedShapes.remove(loaded.shape);
+        m_savedZOrder.insert(loaded.shape->getId(), loaded.zOrder);
+        if (m_pagedDocument) {
+            m_pagedShapes.insert(loaded.shape);
+        }
+        // 插入点之前全是 z_order 递增的已载入图形，只需让原有的下标随插入后移
+        m_firstReorderedIndex = (firstReordered >= index) ? firstReordered + 1 : firstReordered;
+        damage = damage.united(loaded.shape->getDamageRect());
+    }
+    // 整批只报告一次受影响的区域
+    emit areaChanged(damage);
+}
+
+void ArtboardDocument::markShapeModified(AbstractShape *shape)
+{
+    // 只记录顶层图形；组内的子图形随所在的组一起保存
+    if (shape && m_spatialIndex.contains(shape)) {
+        m_modifiedShapes.insert(shape);
+        m_pagedShapes.remove(shape);
+        recordJournalOp(CommandJournal::Update, shape);
+    }
+}
+
+void ArtboardDocument::markShapeMoved(AbstractShape *shape, const QPoint &offset)
+{
+    if (shape && m_spatialIndex.contains(shape)) {
+        m_modifiedShapes.insert(shape);
+        m_pagedShapes.remove(shape);
+        recordJournalOp(CommandJournal::Translate, shape, 0, offset);
+    }
+}
+
+void ArtboardDocument::undo()
+{
+    if (!undoStack.isEmpty()) {
+        AbstractCommand *commandToUndo = undoStack.pop();
+        commandToUndo->undo();
+        flushJournal();
+        redoStack.push(commandToUndo);
+        updateUndoRedoStatus();
+    }
+}
+
+void ArtboardDocument::redo()
+{
+    if (!redoStack.isEmpty()) {
+        AbstractCommand *commandToRedo = redoStack.pop();
+        commandToRedo->execute();
+        flushJournal();
+        undoStack.push(commandToRedo);
+        updateUndoRedoStatus();
+    }
+}
+
+void ArtboardDocument::clearCommandStacks()
+{
+    qDeleteAll(undoStack);
+    undoStack.clear();
+    qDeleteAll(redoStack);
+    redoStack.clear();
+    updateUndoRedoStatus();
+}
+
+void ArtboardDocument::updateUndoRedoStatus()
+{
+    emit undoAvailabilityChanged(!undoStack.isEmpty());
+    emit redoAvailabilityChanged(!redoStack.isEmpty());
+}
+
+void ArtboardDocument::clearRedoStack()
+{
+    if (!redoStack.isEmpty()) {
+        qDeleteAll(redoStack);
+        redoStack.clear();
+    }
+    updateUndoRedoStatus();
+}
+
+void ArtboardDocument::executeCommand(AbstractCommand *command)
+{
+    if (!command) return;
+    command->execute();
+    // 在清空重做栈（可能释放图形）之前写入日志
+    flushJournal();
+    undoStack.push(command);
+    clearRedoStack();
+}
+
+void ArtboardDocument::setBackgroundImage(const QImage &image)
+{
+    if (image.isNull()) {
+        clearBackgroundImage();
+    } else {
+        ++m_backgroundRevision;
+        setBackground(new BackgroundPyramid(image), false);
+    }
+}
+
+void ArtboardDocument::clearBackgroundImage()
+{
+    if (m_background) {
+        ++m_backgroundRevision;
+        setBackground(nullptr, false);
+    }
+}
+
+// 先通知视图改用新的金字塔，再释放旧的
+void ArtboardDocument::setBackground(BackgroundPyramid *pyramid, bool sameImage)
+{
+    BackgroundPyramid *old = m_background;
+    m_background = pyramid;
+    emit backgroundChanged(sameImage);
+    if (old != pyramid) {
+        delete old;
+    }
+}
+
+// 背景图属于文件：打开时只读取尺寸，瓦片在第一次绘制时按需要的那一级读取。
+// 文件中没有背景图时清除当前的背景图。
+void ArtboardDocument::loadBackground(const QString &filePath)
+{
+    ++m_backgroundRevision;
+    m_savedBackgroundRevision = m_backgroundRevision;
+    setBackground(BackgroundPyramid::open(filePath), false);
+}
+
+void ArtboardDocument::setCanvasSize(const QSize &size)
+{
+    m_canvasSize = size;
+    // 分页模式：新露出的区域在下一次绘制之前载入
+    ensureResident(pagedArea());
+}
+
+// 与画布上看到的一致：背景图按比例适配画布并居中。
+// 没有画布尺寸时从原点延伸到所有图形的右下角，没有图形时取背景图的尺寸。
+SceneExporter::Scene ArtboardDocument::exportScene()
+{
+    SceneExporter::Scene scene;
+    scene.size = m_canvasSize;
+    if (scene.size.isEmpty()) {
+        const QRect bounds = contentBounds();
+        if (!bounds.isEmpty()) {
+            scene.size = QSize(qMax(1, bounds.right() + 1), qMax(1, bounds.bottom() + 1));
+        } else if (m_background) {
+            scene.size = m_background->imageSize();
+        }
+    }
+    ensureResident(QRect(QPoint(0, 0), scene.size));
+    scene.fillColor = m_paperColor;
+    if (m_background && !scene.size.isEmpty()) {
+        scene.background = m_background;
+        const QSizeF fitted = QSizeF(m_background->imageSize()).scaled(QSizeF(scene.size), Qt::KeepAspectRatio);
+        scene.backgroundRect = QRectF(QPointF((scene.size.width() - fitted.width()) / 2.0,
+                                              (scene.size.height() - fitted.height()) / 2.0), fitted);
+    }
+    scene.shapesInArea = [this](const QRect &area) { return shapesInArea(area); };
+    return scene;
+}
+
+QImage ArtboardDocument::renderToImage(qreal scale)
+{
+    SceneExporter::Options options;
+    options.scale = scale;
+    return SceneExporter(exportScene(), options).renderImage();
+}
+
+bool ArtboardDocument::exportImage(const QString &filePath, qreal scale)
+{
+    SceneExporter::Options options;
+    options.scale = scale;
+    return SceneExporter(exportScene(), options).write(filePath);
+}
+
+QImage ArtboardDocument::renderPreview(int maxSize)
+{
+    if (m_previewRenderer) {
+        return m_previewRenderer(maxSize);
+    }
+    const SceneExporter::Scene scene = exportScene();
+    if (scene.size.isEmpty()) {
+        return QImage();
+    }
+    SceneExporter::Options options;
+    options.scale = qMin<qreal>(1.0, qreal(maxSize) / qMax(scene.size.width(), scene.size.height()));
+    return SceneExporter(scene, options).renderImage();
+}
+
+namespace {
+// 分页模式在画布四周预先载入的边距（像素），画布稍微变大时不必立即读取文件
+const int PagingMargin = 256;
+}
+
+bool ArtboardDocument::openPagedDocument(const QString &filePath)
+{
+    closePagedDocument();
+    if (!m_pagedMode) {
+        return false;
+    }
+    FpaDatabase *db = new FpaDatabase("paged_connection");
+    if (!db->open(filePath) || !db->hasSpatialIndex()) {
+        qWarning() << "Document" << filePath << "has no spatial index; loading all shapes. Save it once to enable paged loading.";
+        delete db;
+        return false;
+    }
+    m_pagedDocument = db;
+    m_topZOrder = db->maxZOrder();
+    m_residentRegion = QRegion(pagedArea());
+    return true;
+}
+
+void ArtboardDocument::closePagedDocument()
+{
+    delete m_pagedDocument;
+    m_pagedDocument = nullptr;
+    m_residentRegion = QRegion();
+    m_pagedShapes.clear();
+    m_topZOrder = 0;
+}
+
+QRect ArtboardDocument::pagedArea() const
+{
+    return QRect(QPoint(0, 0), m_canvasSize).adjusted(-PagingMargin, -PagingMargin, PagingMargin, PagingMargin);
+}
+
+void ArtboardDocument::ensureResident(const QRect &area)
+{
+    if (!m_pagedDocument || isLoading()) {
+        return; // 载入过程中的区域由载入线程负责
+    }
+    const QRegion missing = QRegion(area).subtracted(m_residentRegion);
+    if (missing.isEmpty()) {
+        return;
+    }
+    // 正在写入的保存完成之前，文件中可能还有已经删除的行
+    waitForPendingSave();
+
+    QSet<quint64> residentIds;
+    for (AbstractShape *shape : shapesList) {
+        if (shape) residentIds.insert(shape->getId());
+    }
+    QVector<DocumentLoader::LoadedShape> incoming;
+    for (const QRect &rect : missing) {
+        m_pagedDocument->readShapesInArea(rect, [&](const FpaDatabase::ShapeRow &row) {
+            if (residentIds.contains(row.id) || m_deletedShapeIds.contains(row.id)) {
+                return true;
+            }
+            AbstractShape *shape = DocumentLoader::decodeShape(row);
+            if (shape) {
+                incoming.append(DocumentLoader::LoadedShape{ shape, row.zOrder });
+                residentIds.insert(row.id);
+            }
+            return true;
+        });
+    }
+    m_residentRegion += missing;
+    mergePagedShapes(incoming);
+}
+
+void ArtboardDocument::pageInAll()
+{
+    ensureResident(QRect(QPoint(INT_MIN / 4, INT_MIN / 4), QPoint(INT_MAX / 4, INT_MAX / 4)));
+}
+
+AbstractShape *ArtboardDocument::pageInShape(quint64 id)
+{
+    FpaDatabase::ShapeRow row;
+    if (!m_pagedDocument || m_deletedShapeIds.contains(id) || !m_pagedDocument->readShape(id, &row)) {
+        return nullptr;
+    }
+    AbstractShape *shape = DocumentLoader::decodeShape(row);
+    if (shape) {
+        mergePagedShapes({ DocumentLoader::LoadedShape{ shape, row.zOrder } });
+    }
+    return shape;
+}
+
+// 把从文件补充载入的图形按 z_order 合并进 shapesList。
+// 尚未保存的新图形没有 z_order，跟在它下方的图形之后；最上方连续的新图形保持在所有文件图形之上。
+// 补充载入不是编辑，不经过 insertShape，不记入变化记录和命令日志。
+void ArtboardDocument::mergePagedShapes(QVector<DocumentLoader::LoadedShape> shapes)
+{
+    if (shapes.isEmpty()) {
+        return;
+    }
+    std::sort(shapes.begin(), shapes.end(), [](const DocumentLoader::LoadedShape &a, const DocumentLoader::LoadedShape &b) {
+        return a.zOrder < b.zOrder;
+    });
+
+    int lastSavedIndex = -1;
+    for (int i = 0; i < shapesList.size(); ++i) {
+        if (shapesList.at(i) && m_savedZOrder.contains(shapesList.at(i)->getId())) lastSavedIndex = i;
+    }
+
+    QVector<AbstractShape*> merged;
+    merged.reserve(shapesList.size() + shapes.size());
+    int next = 0;
+    int firstReordered = -1;
+    for (int i = 0; i < shapesList.size(); ++i) {
+        AbstractShape *shape = shapesList.at(i);
+        auto it = shape ? m_savedZOrder.constFind(shape->getId()) : m_savedZOrder.constEnd();
+        if (it != m_savedZOrder.constEnd()) {
+            while (next < shapes.size() && shapes.at(next).zOrder < it.value()) {
+                merged.append(shapes.at(next++).shape);
+            }
+        } else if (i > lastSavedIndex) {
+            while (next < shapes.size()) {
+                merged.append(shapes.at(next++).shape);
+            }
+        }
+        if (i == m_firstReorderedIndex) {
+            firstReordered = merged.size();
+        }
+        merged.append(shape);
+    }
+    while (next < shapes.size()) {
+        merged.append(shapes.at(next++).shape);
+    }
+
+    QRect damage;
+    for (const DocumentLoader::LoadedShape &loaded : shapes) {
+        const QRect bounds = loaded.shape->getDamageRect();
+        m_spatialIndex.insert(loaded.shape, bounds);
+        m_savedZOrder.insert(loaded.shape->getId(), loaded.zOrder);
+        m_pagedShapes.insert(loaded.shape);
+        m_nextShapeId = qMax(m_nextShapeId, loaded.shape->getId() + 1);
+        damage = damage.united(bounds);
+    }
+    shapesList = merged;
+    m_zOrder.clear();
+    m_zOrderDirty = true;
+    // 合并进来的图形 z_order 有效且按顺序排列，不影响“之前的图形都有效”这一性质
+    m_firstReorderedIndex = (firstReordered >= 0) ? firstReordered : shapesList.size();
+    emit areaChanged(damage);
+}
+
+// 释放与 keepArea 不相交、与文件内容一致的图形。被选中的图形、keep 中的图形和命令引用的图形保留。
+// 释放之后 keepArea 仍然完整地在内存中。
+void ArtboardDocument::evictPagedShapes(const QRect &keepArea, const QSet<AbstractShape*> &keep)
+{
+    if (!m_pagedDocument || isLoading() || m_pagedShapes.isEmpty()) {
+        return;
+    }
+    // 撤销/重做栈中的命令持有图形指针，它们引用的图形不能释放
+    QSet<AbstractShape*> referenced;
+    for (const AbstractCommand *command : undoStack) {
+        command->collectShapes(&referenced);
+    }
+    for (const AbstractCommand *command : redoStack) {
+        command->collectShapes(&referenced);
+    }
+    QVector<AbstractShape*> kept;
+    kept.reserve(shapesList.size());
+    int evictedBeforeReordered = 0;
+    int evicted = 0;
+    for (int i = 0; i < shapesList.size(); ++i) {
+        AbstractShape *shape = shapesList.at(i);
+        if (m_pagedShapes.contains(shape) && !m_modifiedShapes.contains(shape)
+            && !m_selectedShapes.contains(shape) && !keep.contains(shape) && !referenced.contains(shape)
+            && !shape->getDamageRect().intersects(keepArea)) {
+            m_spatialIndex.remove(shape);
+            m_savedZOrder.remove(shape->getId());
+            m_pagedShapes.remove(shape);
+            if (i < m_firstReorderedIndex) {
+                ++evictedBeforeReordered;
+            }
+            ++evicted;
+            delete shape;
+            continue;
+        }
+        kept.append(shape);
+    }
+    m_residentRegion &= QRegion(keepArea);
+    if (evicted == 0) {
+        return;
+    }
+    shapesList = kept;
+    m_zOrder.clear();
+    m_zOrderDirty = true;
+    m_firstReorderedIndex -= evictedBeforeReordered;
+}
+
+bool ArtboardDocument::saveToDatabase(const QString &filePath)
+{
+    SaveSnapshot snapshot;
+    if (!captureSaveSnapshot(filePath, &snapshot)) {
+        return false;
+    }
+    DocumentSaver::encode(&snapshot);
+    const bool ok = DocumentSaver::write(snapshot, "saver_connection");
+    finishSave(filePath, ok);
+    if (ok) {
+        qDebug() << "Canvas saved successfully!";
+    }
+    return ok;
+}
+
+bool ArtboardDocument::saveToDatabaseAsync(const QString &filePath)
+{
+    if (m_saveInFlight) {
+        // 下一次快照依赖上一次写入的结果（失败时要恢复变化记录），不在主线程中等待，
+        // 而是排在它之后开始。连续多次请求只保留最后一次。
+        m_queuedSavePath = filePath;
+        return true;
+    }
+    SaveSnapshot snapshot;
+    if (!captureSaveSnapshot(filePath, &snapshot)) {
+        return false;
+    }
+    m_saveInFlight = true;
+    m_documentSaver->start(snapshot);
+    return true;
+}
+
+bool ArtboardDocument::isSaving() const
+{
+    return m_saveInFlight || !m_queuedSavePath.isEmpty();
+}
+
+void ArtboardDocument::startQueuedSave()
+{
+    if (m_queuedSavePath.isEmpty()) {
+        return;
+    }
+    const QString filePath = m_queuedSavePath;
+    m_queuedSavePath.clear();
+    // 请求时已经返回了 true，无法开始时也要报告结果
+    if (!saveToDatabaseAsync(filePath)) {
+        emit saveFinished(false, filePath);
+    }
+}
+
+// 在主线程中生成保存快照：计算需要改写的 z_order，并复制新增或修改过的图形，
+// 全量保存时是全部图形。复制只增加点集等数据的引用计数，编码由 DocumentSaver 对副本进行，
+// 异步保存时在工作线程中，不占用主线程。
+//
+// 缩略图仍在主线程中生成：有视图时由视图缩小它的场景瓦片缓存（只重画脏瓦片，下一次绘制本来也要重画），
+// 没有视图时重新绘制图形，这需要读取文档中的图形本身。
+//
+// 快照生成后立即按“保存成功”更新变化记录，之后的编辑从零开始记录；
+// 如果写入失败，finishSave 会让下一次保存改为全量写入。
+bool ArtboardDocument::captureSaveSnapshot(const QString &filePath, SaveSnapshot *snapshot)
+{
+    if (isLoading()) {
+        // 文件中尚未载入的部分与内存中的 z 顺序无法对应，载入完成或取消之后才能保存
+        qWarning() << "Error: Cannot save while a document is still loading.";
+        return false;
+    }
+    // 下一次快照依赖上一次保存的结果。异步保存在前一次写入完成之后才会走到这里（见 saveToDatabaseAsync），
+    // 只有同步保存需要在这里等待
+    waitForPendingSave();
+
+    // 只有保存到上次载入或保存的同一个文件、且该文件仍然存在时才能增量写入
+    const bool samePath = !m_documentPath.isEmpty() && QFileInfo(filePath) == QFileInfo(m_documentPath);
+    bool incremental = samePath && QFileInfo::exists(filePath);
+    if (m_pagedDocument && !incremental) {
+        // 分页模式下内存中只有一部分图形，只能在原文件或它的副本上增量写入
+        if (samePath) {
+            qWarning() << "Error: The paged document" << filePath << "no longer exists.";
+            return false;
+        }
+        snapshot->copyFrom = m_documentPath;
+        incremental = true;
+    }
+    snapshot->filePath = filePath;
+    snapshot->incremental = incremental;
+    m_savingPath = filePath;
+
+    // 这次保存同时是命令日志的检查点：文件记下它已经包含的最后一条记录。
+    // 保存到另一个文件或全量写入时换用新的 token，旧日志不会被误用到新文件上。
+    flushJournal();
+    m_savingJournalToken = (incremental && m_journal.token() != 0) ? m_journal.token()
+                                                                    : (QRandomGenerator::global()->generate64() | 1);
+    m_savingJournalSeq = m_journal.isOpen() ? m_journal.lastSeq() : 0;
+    snapshot->journalToken = m_savingJournalToken;
+    snapshot->journalSeq = m_savingJournalSeq;
+    if (incremental) {
+        snapshot->deletedIds = QVector<quint64>(m_deletedShapeIds.cbegin(), m_deletedShapeIds.cend());
+    }
+
+    // 背景图只在更换过或全量写入时改写。已经保存在文件中的背景图直接复制瓦片，不需要原图。
+    snapshot->writeBackground = !incremental || m_backgroundRevision != m_savedBackgroundRevision;
+    if (snapshot->writeBackground && m_background) {
+        const BackgroundPyramid *pyramid = m_background;
+        if (pyramid->filePath().isEmpty()) {
+            snapshot->backgroundImage = pyramid->sourceImage();
+        } else {
+            snapshot->backgroundFrom = pyramid->filePath();
+        }
+    }
+    m_savingBackgroundRevision = m_backgroundRevision;
+    snapshot->preview = renderPreview(FpaDatabase::PreviewSize);
+
+    auto savedZOrderOf = [this, incremental](int index, qint64 *zOrder) {
+        if (!incremental) return false;
+        auto it = m_savedZOrder.constFind(shapesList.at(index)->getId());
+        if (it == m_savedZOrder.constEnd()) return false;
+        *zOrder = it.value();
+        return true;
+    };
+    auto needsFullWrite = [this, incremental](AbstractShape *shape) {
+        return !incremental || m_modifiedShapes.contains(shape);
+    };
+
+    // 1. z 顺序。m_firstReorderedIndex 之前的图形的 z_order 都有效且递增，
+    //    只需从这里开始检查：仍然比前一个大的保留，否则取与下一个之间的中点，没有空隙时向后顺延。
+    //    追加图形时只检查新图形本身。
+    const int count = shapesList.size();
+    const int first = incremental ? qMin(m_firstReorderedIndex, count) : 0;
+    QHash<quint64, qint64> assignedZOrder;
+    qint64 previousZ = 0;
+    if (first > 0) {
+        savedZOrderOf(first - 1, &previousZ);
+    }
+    // 分页模式下文件中可能还有没有载入的、更靠上的图形，最上方连续的新图形要排在它们之上
+    int lastSavedIndex = -1;
+    if (m_pagedDocument) {
+        for (int i = count - 1; i >= first && lastSavedIndex < 0; --i) {
+            qint64 z = 0;
+            if (savedZOrderOf(i, &z)) lastSavedIndex = i;
+        }
+        lastSavedIndex = qMax(lastSavedIndex, first - 1);
+    }
+    for (int i = first; i < count; ++i) {
+        AbstractShape *shape = shapesList.at(i);
+        qint64 z = 0;
+        if (!savedZOrderOf(i, &z) || z <= previousZ) {
+            qint64 nextZ = 0;
+            if (i + 1 < count && savedZOrderOf(i + 1, &nextZ) && nextZ - previousZ > 1) {
+                z = previousZ + (nextZ - previousZ) / 2;
+            } else if (m_pagedDocument && i > lastSavedIndex) {
+                z = qMax(previousZ, m_topZOrder) + FpaDatabase::ZOrderGap;
+                m_topZOrder = z;
+            } else {
+                z = previousZ + FpaDatabase::ZOrderGap;
+            }
+            assignedZOrder.insert(shape->getId(), z);
+            // 只是顺序变化的图形只改写 z_order，需要整行重写的在下一步编码
+            if (!needsFullWrite(shape)) {
+                snapshot->zOrderUpdates.append(qMakePair(shape->getId(), z));
+            }
+        }
+        previousZ = z;
+    }
+
+    // 2. 变化记录更新为保存之后的状态
+    QVector<AbstractShape*> shapesToWrite;
+    if (incremental) {
+        shapesToWrite = QVector<AbstractShape*>(m_modifiedShapes.cbegin(), m_modifiedShapes.cend());
+    } else {
+        shapesToWrite.reserve(count);
+        for (AbstractShape *shape : shapesList) {
+            if (shape) shapesToWrite.append(shape);
+        }
+        m_savedZOrder.clear();
+    }
+    for (quint64 id : snapshot->deletedIds) {
+        m_savedZOrder.remove(id);
+    }
+    for (auto it = assignedZOrder.constBegin(); it != assignedZOrder.constEnd(); ++it) {
+        m_savedZOrder.insert(it.key(), it.value());
+    }
+    if (m_pagedDocument) {
+        // 写入失败时无法退回全量保存，记下这次写入涉及的图形以便恢复
+        m_savingDeletedIds = snapshot->deletedIds;
+        m_savingWrittenIds.clear();
+        for (AbstractShape *shape : shapesToWrite) {
+            m_savingWrittenIds.insert(shape->getId());
+        }
+        for (const QPair<quint64, qint64> &update : snapshot->zOrderUpdates) {
+            m_savingWrittenIds.insert(update.first);
+        }
+    }
+    m_modifiedShapes.clear();
+    m_deletedShapeIds.clear();
+    m_firstReorderedIndex = count;
+
+    // 3. 复制需要整行写入的图形，之后对原图形的编辑不影响副本
+    snapshot->pendingShapes.reserve(shapesToWrite.size());
+    for (AbstractShape *shape : shapesToWrite) {
+        snapshot->pendingShapes.append(SaveSnapshot::PendingShape{ shape->getId(), m_savedZOrder.value(shape->getId()), shape->clone() });
+    }
+    return true;
+}
+
+// 等待正在进行的后台保存完成并处理它的结果，在这里发出 saveFinished。
+// 排队的保存随后同步完成：调用方（载入另一个文件、分页读取）之后看到的文件
+// 就是用户最后一次要求保存的内容。
+void ArtboardDocument::waitForPendingSave()
+{
+    if (!m_saveInFlight) {
+        return;
+    }
+    m_documentSaver->waitForFinished();
+    m_saveInFlight = false;
+    const bool ok = m_documentSaver->result();
+    finishSave(m_savingPath, ok);
+    emit saveFinished(ok, m_savingPath);
+
+    if (!m_queuedSavePath.isEmpty()) {
+        const QString filePath = m_queuedSavePath;
+        m_queuedSavePath.clear();
+        emit saveFinished(saveToDatabase(filePath), filePath);
+    }
+}
+
+void ArtboardDocument::finishSave(const QString &filePath, bool ok)
+{
+    if (ok) {
+        if (m_pagedDocument && filePath != m_documentPath) {
+            m_pagedDocument->open(filePath); // 另存为之后从副本补充载入
+        }
+        m_documentPath = filePath;
+        if (m_pagedDocument) {
+            // 写入的图形又与文件一致了，可以再次释放；保存期间又被修改的除外
+            for (AbstractShape *shape : shapesList) {
+                if (shape && m_savingWrittenIds.contains(shape->getId()) && !m_modifiedShapes.contains(shape)) {
+                    m_pagedShapes.insert(shape);
+                }
+            }
+        }
+        m_savedBackgroundRevision = m_savingBackgroundRevision;
+        BackgroundPyramid *pyramid = m_background;
+        if (pyramid && m_backgroundRevision == m_savingBackgroundRevision && pyramid->filePath() != filePath) {
+            // 背景图已经在文件中：改为按需读取瓦片，释放内存中的原图
+            if (BackgroundPyramid *saved = BackgroundPyramid::open(filePath)) {
+                setBackground(saved, true);
+            }
+        }
+        // 文件已经包含检查点之前的全部记录，日志只需保留保存期间新增的记录
+        const QString journalPath = journalPathFor(filePath);
+        if (m_journal.isOpen()) {
+            m_journal.compact(journalPath, m_savingJournalToken, m_savingJournalSeq);
+        } else {
+            startJournal(journalPath, m_savingJournalToken, m_savingJournalSeq);
+        }
+    } else if (m_pagedDocument) {
+        // 分页模式不能全量写入。事务已经回滚，文件保持原样：恢复这次写入涉及的变化记录，
+        // 并从头检查 z 顺序
+        for (quint64 id : m_savingDeletedIds) {
+            m_deletedShapeIds.insert(id);
+        }
+        for (AbstractShape *shape : shapesList) {
+            if (shape && m_savingWrittenIds.contains(shape->getId())) {
+                m_modifiedShapes.insert(shape);
+            }
+        }
+        m_firstReorderedIndex = 0;
+    } else {
+        // 快照生成时已按成功更新了变化记录，文件内容现在无法确定，下一次保存全量写入。
+        // 日志仍然基于上一个检查点，其中的记录都保留着。
+        m_documentPath.clear();
+    }
+}
+
+QString ArtboardDocument::journalPathFor(const QString &documentPath)
+{
+    return documentPath + "-journal";
+}
+
+int ArtboardDocument::setRecoveryJournalPath(const QString &path, bool recover)
+{
+    m_recoveryJournalPath = path;
+    if (!m_documentPath.isEmpty() || isLoading() || path.isEmpty()) {
+        return 0;
+    }
+    closeJournal();
+    quint64 lastSeq = 0;
+    const int replayed = recover ? replayJournal(path, 0, &lastSeq) : 0;
+    // 重放的内容作为新日志的第一条记录写回
+    startJournal(path, 0, 0);
+    if (replayed > 0) {
+        emit journalReplayed(replayed);
+    }
+    return replayed;
+}
+
+// 每个图形的增删改都经过这里。只记录顶层图形，并且只在日志打开时（不在载入或重放期间）记录。
+void ArtboardDocument::recordJournalOp(CommandJournal::OpType type, AbstractShape *shape, quint64 belowId, const QPoint &offset)
+{
+    if (!m_journal.isOpen()) {
+        return;
+    }
+    m_journalOps.append(PendingJournalOp{ type, shape, shape->getId(), belowId, offset });
+}
+
+// 把当前命令产生的操作合成一条日志记录写入。
+// 图形的编码在这里才生成，反映命令完成之后的状态：同一个图形在一条记录中最多编码一次，
+// 有了完整编码的图形不再需要 Update 和 Translate。
+void ArtboardDocument::flushJournal()
+{
+    if (m_journalOps.isEmpty()) {
+        return;
+    }
+    QSet<AbstractShape*> putShapes;
+    QSet<AbstractShape*> encodedShapes;
+    for (const PendingJournalOp &pending : m_journalOps) {
+        if (pending.type == CommandJournal::Put) {
+            putShapes.insert(pending.shape);
+        }
+        if (pending.type == CommandJournal::Put || pending.type == CommandJournal::Update) {
+            encodedShapes.insert(pending.shape);
+        }
+    }
+
+    QHash<AbstractShape*, QByteArray> bodies;
+    auto bodyOf = [&bodies](AbstractShape *shape) {
+        auto it = bodies.find(shape);
+        if (it == bodies.end()) {
+            it = bodies.insert(shape, ShapeCodec::encode(shape->toJsonObject()));
+        }
+        return it.value();
+    };
+
+    QVector<CommandJournal::Op> ops;
+    ops.reserve(m_journalOps.size());
+    QSet<AbstractShape*> updated;
+    for (const PendingJournalOp &pending : m_journalOps) {
+        CommandJournal::Op op{ pending.type, pending.id, pending.belowId, QByteArray(), pending.offset };
+        switch (pending.type) {
+        case CommandJournal::Put:
+            op.body = bodyOf(pending.shape);
+            break;
+        case CommandJournal::Update:
+            if (putShapes.contains(pending.shape) || updated.contains(pending.shape)) {
+                continue;
+            }
+            updated.insert(pending.shape);
+            op.body = bodyOf(pending.shape);
+            break;
+        case CommandJournal::Translate:
+            if (encodedShapes.contains(pending.shape)) {
+                continue;
+            }
+            break;
+        case CommandJournal::Remove:
+            break;
+        }
+        ops.append(op);
+    }
+    m_journalOps.clear();
+    m_journal.append(ops);
+
+    // 定期检查点：把上次保存之后的变化增量写入文件，保存成功后日志被压缩。
+    // 只在文件仍然存在时进行，这时保存一定是增量的（只写入变化的图形）；
+    // 文件被删除或上次保存失败时（m_documentPath 被清空）不会因为检查点而全量写入整个画布。
+    if (m_checkpointInterval > 0 && m_journal.recordCount() >= m_checkpointInterval
+        && !m_documentPath.isEmpty() && QFileInfo::exists(m_documentPath) && !isSaving() && !isLoading()) {
+        saveToDatabaseAsync(m_documentPath);
+    }
+}
+
+// 打开文件之后调用：如果文件旁边的日志基于文件当前的检查点，重放检查点之后的记录，
+// 然后以文件的检查点为基准重新开始记录。
+int ArtboardDocument::resumeJournal(const QString &documentPath)
+{
+    quint64 token = 0;
+    quint64 seq = 0;
+    {
+        FpaDatabase db("journal_connection");
+        if (db.open(documentPath)) {
+            token = quint64(db.metaValue("journal_token").toLongLong());
+            seq = quint64(db.metaValue("journal_seq").toLongLong());
+        }
+    }
+
+    const QString journalPath = journalPathFor(documentPath);
+    CommandJournal::Header header;
+    int replayed = 0;
+    if (CommandJournal::readHeader(journalPath, &header)) {
+        if (header.token == token && header.baseSeq <= seq) {
+            quint64 lastSeq = seq;
+            replayed = replayJournal(journalPath, seq, &lastSeq);
+        } else {
+            qWarning() << "Ignoring journal" << journalPath << "written for a different version of the document.";
+        }
+    }
+    startJournal(journalPath, token, seq);
+    if (replayed > 0) {
+        emit journalReplayed(replayed);
+    }
+    return replayed;
+}
+
+// 在当前画布上重放日志中序号大于 afterSeq 的记录。重放经过 insertShape/removeShape，
+// 重放出的内容与文件的差别照常记为需要保存的修改。
+int ArtboardDocument::replayJournal(const QString &journalPath, quint64 afterSeq, quint64 *lastSeq)
+{
+    QHash<quint64, AbstractShape*> shapesById;
+    for (AbstractShape *shape : shapesList) {
+        if (shape) shapesById.insert(shape->getId(), shape);
+    }
+
+    int replayed = 0;
+    CommandJournal::Header header;
+    CommandJournal::read(journalPath, &header, [&](quint64 seq, const QVector<CommandJournal::Op> &ops) {
+        if (seq <= afterSeq) {
+            return true;
+        }
+        if (replayed == 0) {
+            // 命令栈和选择中的图形可能被重放替换，不能再使用
+            clearCommandStacks();
+            setSelectedShapes(QList<AbstractShape*>());
+        }
+        for (const CommandJournal::Op &op : ops) {
+            AbstractShape *existing = shapesById.value(op.id);
+            if (!existing && m_pagedDocument) {
+                // 记录涉及的图形可能不在可见区域内
+                existing = pageInShape(op.id);
+                if (existing) shapesById.insert(op.id, existing);
+            }
+            switch (op.type) {
+            case CommandJournal::Put:
+            case CommandJournal::Update: {
+                if (op.type == CommandJournal::Update && !existing) {
+                    break;
+                }
+                AbstractShape *shape = AbstractShape::fromJsonObject(ShapeCodec::decode(op.body));
+                if (!shape) {
+                    qWarning() << "Warning: Skipping undecodable shape" << op.id << "in journal record" << seq;
+                    break;
+                }
+                shape->setId(op.id);
+                int index = existing ? zOrderOf(existing) : shapesList.size();
+                if (existing) {
+                    removeShape(existing);
+                    delete existing;
+                }
+                if (op.type == CommandJournal::Put) {
+                    AbstractShape *below = shapesById.value(op.belowId);
+                    index = (op.belowId == 0) ? 0 : (below ? zOrderOf(below) + 1 : shapesList.size());
+                }
+                insertShape(index, shape);
+                shapesById.insert(op.id, shape);
+                break;
+            }
+            case CommandJournal::Remove:
+                if (existing) {
+                    removeShape(existing);
+                    shapesById.remove(op.id);
+                    delete existing;
+                }
+                break;
+            case CommandJournal::Translate:
+                if (existing) {
+                    existing->moveBy(op.offset);
+                    m_spatialIndex.insert(existing, existing->getDamageRect());
+                    markShapeModified(existing);
+                }
+                break;
+            }
+        }
+        *lastSeq = seq;
+        ++replayed;
+        return true;
+    });
+    if (replayed > 0) {
+        invalidateScene();
+        qDebug() << "Replayed" << replayed << "journal records from" << journalPath;
+    }
+    return replayed;
+}
+
+// 在 journalPath 创建新日志，以 (token, baseSeq) 为基准。当前画布与基准之间的差别
+// （没有文件的画布就是全部图形）作为第一条记录写入，之后的命令接着追加。
+bool ArtboardDocument::startJournal(const QString &journalPath, quint64 token, quint64 baseSeq)
+{
+    closeJournal();
+    if (journalPath.isEmpty()) {
+        return false;
+    }
+    const bool untitled = m_documentPath.isEmpty();
+    QVector<CommandJournal::Op> ops;
+    if (!untitled) {
+        for (quint64 id : m_deletedShapeIds) {
+            ops.append(CommandJournal::Op{ CommandJournal::Remove, id, 0, QByteArray(), QPoint() });
+        }
+    }
+    quint64 belowId = 0;
+    for (AbstractShape *shape : shapesList) {
+        if (!shape) continue;
+        if (untitled || m_modifiedShapes.contains(shape)) {
+            ops.append(CommandJournal::Op{ CommandJournal::Put, shape->getId(), belowId,
+                                           ShapeCodec::encode(shape->toJsonObject()), QPoint() });
+        }
+        belowId = shape->getId();
+    }
+    return m_journal.create(journalPath, token, baseSeq, ops);
+}
+
+void ArtboardDocument::closeJournal()
+{
+    m_journalOps.clear();
+    m_journal.close(true);
+}
+
+// 后台载入期间用户新画的图形不能占用文件或日志中已有的 ID
+quint64 ArtboardDocument::firstFreeShapeId(const QString &documentPath) const
+{
+    quint64 maxId = 0;
+    {
+        FpaDatabase db("journal_connection");
+        if (db.open(documentPath)) {
+            maxId = db.maxShapeId();
+        }
+    }
+    CommandJournal::Header header;
+    CommandJournal::read(journalPathFor(documentPath), &header, [&maxId](quint64, const QVector<CommandJournal::Op> &ops) {
+        for (const CommandJournal::Op &op : ops) {
+            maxId = qMax(maxId, op.id);
+        }
+        return true;
+    });
+    return maxId + 1;
+}
+
+void ArtboardDocument::loadFromDatabaseAsync(const QString &filePath)
+{
+    waitForPendingSave();
+    m_documentLoader->cancel();
+    // 清空画布不是编辑，不写入日志；新文件的日志在载入完成后打开
+    closeJournal();
+    clearAllShapes();
+    closePagedDocument();
+    m_documentPath.clear();
+    m_savedZOrder.clear();
+    m_modifiedShapes.clear();
+    m_deletedShapeIds.clear();
+    m_firstReorderedIndex = 0;
+    m_loadInsertIndex = 0;
+    m_nextShapeId = firstFreeShapeId(filePath);
+    loadBackground(filePath);
+    m_loadingPath = filePath;
+    m_documentLoader->start(filePath, openPagedDocument(filePath) ? pagedArea() : QRect());
+}
+
+void ArtboardDocument::cancelLoading()
+{
+    if (m_documentLoader->isRunning()) {
+        m_documentLoader->cancel();
+        m_loadingPath.clear();
+        // 已经载入的部分当作未保存的画布
+        startJournal(m_recoveryJournalPath, 0, 0);
+    }
+}
+
+bool ArtboardDocument::isLoading() const
+{
+    return m_documentLoader->isRunning();
+}
+
+bool ArtboardDocument::loadFromDatabase(const QString &filePath)
+{
+    m_documentLoader->cancel();
+    m_loadingPath.clear();
+    waitForPendingSave();
+    FpaDatabase db("loader_connection");
+    if (!db.open(filePath)) {
+        return false;
+    }
+    if (!FpaDatabase::isSupportedVersion(db.schemaVersion())) {
+        qWarning() << "Error:" << filePath << "was written by a newer version (schema" << db.schemaVersion() << ").";
+        return false;
+    }
+
+    closeJournal();
+    clearAllShapes();
+    closePagedDocument();
+    loadBackground(filePath);
+    m_documentPath.clear();
+    m_savedZOrder.clear();
+    // 分页模式下只读取一部分行，新图形的 ID 必须避开文件和日志中已经使用的全部 ID
+    m_nextShapeId = firstFreeShapeId(filePath);
+    auto visitor = [this](const FpaDatabase::ShapeRow &row) {
+        AbstractShape *shape = DocumentLoader::decodeShape(row);
+        if (shape) {
+            m_savedZOrder.insert(row.id, row.zOrder);
+            appendShape(shape);
+        }
+        return true;
+    };
+    const bool paged = openPagedDocument(filePath);
+    const bool ok = paged ? db.readShapesInArea(pagedArea(), visitor) : db.readShapes(visitor);
+    if (paged) {
+        for (AbstractShape *shape : shapesList) {
+            m_pagedShapes.insert(shape);
+        }
+    }
+    invalidateScene();
+    db.close();
+    if (!ok) {
+        closePagedDocument();
+        startJournal(m_recoveryJournalPath, 0, 0);
+        return false;
+    }
+
+    // 内存中的内容与文件一致，之后的保存只需写入变化
+    m_modifiedShapes.clear();
+    m_deletedShapeIds.clear();
+    m_firstReorderedIndex = shapesList.size();
+    m_documentPath = filePath;
+    resumeJournal(filePath);
+    qDebug() << "Canvas loaded successfully!";
+    return true;
+}
@@ -0,0 +1,291 @@
+#ifndef ARTBOARDDOCUMENT_H
+#define ARTBOARDDOCUMENT_H
+
+// ---------------------------------------------------------------------------
+// 描述: 定义了 ArtboardDocument 类，画板的文档模型。
+//       它拥有全部已提交的图形（按 z 顺序）、选择、撤销/重做栈和背景图，
+//       负责 .fpa 文件的载入与保存（同步、后台、增量和分页）以及命令日志。
+//       文档不依赖 QWidget：命令只操作文档，ArtboardView 只负责显示和把鼠标操作转换为命令。
+//       基准测试、批处理工具和测试可以不创建窗口、不运行事件循环，直接用同步接口驱动文档。
+//
+//       内容的变化通过信号报告，视图据此使缓存失效并重绘。
+//       修改图形的代码在修改之前和之后各调用一次 updateShapeArea()，旧位置和新位置都会被报告。
+// ---------------------------------------------------------------------------
+
+#include <QObject>
+#include <QColor>
+#include <QStack>
+#include <QVector>
+#include <QSet>
+#include <QHash>
+#include <QImage>
+#include <QRegion>
+#include <functional>
+
+#include "shapespatialindex.h"
+#include "sceneexporter.h"
+#include "documentloader.h"
+#include "commandjournal.h"
+
+class AbstractShape;
+class AbstractCommand;
+class BackgroundPyramid;
+class DocumentSaver;
+class FpaDatabase;
+struct SaveSnapshot;
+
+class ArtboardDocument : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ArtboardDocument(QObject *parent = nullptr);
+    ~ArtboardDocument() override;
+
+    // --- 图形 ---
+
+    /// 按 z 顺序（先画的在前）排列的顶层图形。
+    const QVector<AbstractShape*> &shapes() const { return shapesList; }
+    /// shape 在 shapes() 中的下标；不在文档中时返回 -1。
+    int zOrderOf(const AbstractShape *shape) const;
+    /// @brief 按 z 顺序（先画的在前）返回包围区域与 area 相交的图形。
+    /// 基于空间索引，供框选、视口裁剪、导出等需要区域查询的功能复用。
+    QVector<AbstractShape*> shapesInArea(const QRect &area) const;
+    /// 返回 point 处最上层的可选中图形（橡皮擦路径不可选中）。
+    AbstractShape *shapeAt(const QPoint &point) const;
+    const ShapeSpatialIndex &spatialIndex() const { return m_spatialIndex; }
+    /// 所有图形重绘区域的并集。
+    QRect contentBounds() const;
+
+    /// @brief 修改图形列表。shapes() 的所有增删都经过这几个函数，以便同步维护空间索引、z 顺序、
+    /// 增量保存的变化记录和命令日志。它们供命令使用：不经过命令的修改不能撤销。
+    void insertShape(int index, AbstractShape *shape);
+    void appendShape(AbstractShape *shape) { insertShape(shapesList.size(), shape); }
+    bool removeShape(AbstractShape *shape);
+    void replaceAllShapes(const QVector<AbstractShape*> &shapes);
+    /// @brief 释放全部图形并清空命令栈和选择。这不是编辑，不能撤销。
+    void clearAllShapes();
+
+    /// @brief 报告 shape 当前占据的区域需要重绘。在修改图形之前和之后各调用一次，
+    /// 旧位置和新位置都会被报告；修改之后的这次调用让空间索引记录新位置。
+    void updateShapeArea(const AbstractShape *shape);
+    /// @brief 报告全部内容都变化了。用于清空画布、载入文件等影响全部内容的操作。
+    void invalidateScene();
+
+    /// @brief 记录 shape 在上次保存之后被修改过，下次增量保存时重写它所在的行。
+    /// 修改图形几何或样式的命令在 execute() 和 undo() 中调用；新增和移除由文档自动记录。
+    void markShapeModified(AbstractShape *shape);
+    /// @brief 与 markShapeModified 相同，但告诉命令日志这只是一次平移，日志只记录偏移量而不重新编码整个图形。
+    /// 移动图形的命令使用它。
+    void markShapeMoved(AbstractShape *shape, const QPoint &offset);
+
+    // --- 选择 ---
+
+    const QList<AbstractShape*> &selectedShapes() const { return m_selectedShapes; }
+    void setSelectedShapes(const QList<AbstractShape*> &shapes);
+    void deselect(AbstractShape *shape);
+
+    // --- 撤销/重做 ---
+
+    /// @brief 执行命令并把它压入撤销栈，重做栈被清空。文档获得命令的所有权。
+    void executeCommand(AbstractCommand *command);
+    bool canUndo() const { return !undoStack.isEmpty(); }
+    bool canRedo() const { return !redoStack.isEmpty(); }
+
+    // --- 背景图 ---
+
+    void setBackgroundImage(const QImage &image);
+    void clearBackgroundImage();
+    /// 背景图的金字塔；没有背景图时为 nullptr。属于文档，更换背景图后失效。
+    BackgroundPyramid *background() const { return m_background; }
+
+    // --- 画布 ---
+
+    /// @brief 画布的尺寸（逻辑像素）。决定导出的范围和分页模式的常驻区域；视图在大小变化时设置。
+    /// 为空时（没有视图的文档）导出范围从原点延伸到所有图形的右下角。
+    void setCanvasSize(const QSize &size);
+    QSize canvasSize() const { return m_canvasSize; }
+    /// 画布的底色，橡皮擦也用它作为颜色。
+    QColor paperColor() const { return m_paperColor; }
+    /// @brief 把整个画布按 scale 倍画到一张图上。
+    QImage renderToImage(qreal scale = 1.0);
+    /// @brief 以 scale 倍分辨率把画布导出为图像文件，格式由后缀决定（见 SceneExporter）。
+    /// 输出按条带栅格化；.tif/.tiff 逐条带写入文件，可以导出远大于内存的图像。
+    bool exportImage(const QString &filePath, qreal scale);
+    /// @brief 画布的缩略图，最长边不超过 maxSize，保存时写入文件摘要。
+    /// 设置了 previewRenderer（例如视图直接缩小屏幕缓存）时由它生成，否则重新绘制。
+    QImage renderPreview(int maxSize);
+    void setPreviewRenderer(const std::function<QImage(int maxSize)> &renderer) { m_previewRenderer = renderer; }
+
+    // --- 文件 ---
+
+    bool saveToDatabase(const QString &filePath);
+    /// @brief 在后台线程中保存。主线程只负责生成快照（复制发生变化的图形），编码和写入都在后台进行，
+    /// 随后立即返回，可以继续编辑；结果通过 saveFinished 报告。
+    /// 上一次保存还在写入时不等待，这次保存排在它之后开始；排队期间再次请求时只保留最后一次。
+    /// @return 无法开始保存（例如正在载入）时返回 false，此时不会发出 saveFinished。
+    bool saveToDatabaseAsync(const QString &filePath);
+    bool isSaving() const;
+    bool loadFromDatabase(const QString &filePath);
+
+    /// @brief 在后台线程中载入 .fpa 文件，图形分批加入文档，载入期间文档可以正常编辑。
+    /// 立即清空文档并返回；通过 loadProgress 和 loadFinished 报告进度和结果。需要事件循环。
+    void loadFromDatabaseAsync(const QString &filePath);
+    /// @brief 取消正在进行的后台载入。已经载入的图形保留。
+    void cancelLoading();
+    bool isLoading() const;
+
+    /// @brief 分页模式：打开 .fpa 文件时只载入与常驻区域（画布加上一圈预取边距）相交的图形，
+    /// 画布变大时补充载入新露出的部分，离开常驻区域且没有被改动过的图形被释放，
+    /// 内存占用取决于可见的内容而不是文件的大小。点击测试、框选和导出只涉及画布范围，总能找到所需的图形。
+    /// 需要文件带有空间索引（用当前版本保存过一次即可），否则仍然载入全部图形。从下一次打开文件开始生效。
+    void setPagedMode(bool enabled) { m_pagedMode = enabled; }
+    bool isPagedMode() const { return m_pagedMode; }
+    /// @brief 当前文件是否以分页模式打开。
+    bool isPagedDocument() const { return m_pagedDocument != nullptr; }
+    /// 分页模式下应当常驻内存的区域：画布加上一圈预取边距。
+    QRect pagedArea() const;
+    /// @brief 分页模式：载入文件中与 area 相交、还不在内存中的图形。
+    void ensureResident(const QRect &area);
+    /// @brief 分页模式：整个文件都载入内存。清空画布这类涉及全部图形的命令在执行前调用。
+    void pageInAll();
+    /// @brief 分页模式：释放与 keepArea 不相交、与文件内容一致（载入后未修改，或修改后已保存）的图形。
+    /// 被选中的图形、keep 中的图形（例如视图正在操作的图形）和撤销/重做栈中的命令引用的图形保留。
+    void evictPagedShapes(const QRect &keepArea, const QSet<AbstractShape*> &keep = QSet<AbstractShape*>());
+
+    /// @brief 命令日志文件的位置：与 .fpa 文件放在一起，名为 "<文件名>-journal"。
+    static QString journalPathFor(const QString &documentPath);
+    /// @brief 设置尚未保存过的文档使用的命令日志。
+    /// 文档当前没有对应的文件时立即开始使用它：recover 为 true 时先重放其中的记录（上次程序意外退出时的画布），
+    /// 否则丢弃其中的内容。
+    /// @return 重放的记录数。
+    int setRecoveryJournalPath(const QString &path, bool recover);
+    /// @brief 日志中积累了多少条记录后自动保存一次（检查点），保存成功后日志被压缩。
+    /// 检查点总是增量保存，只对已经保存为文件、且文件仍然存在的文档生效；0 表示不自动保存。
+    void setCheckpointInterval(int records) { m_checkpointInterval = qMax(0, records); }
+    int checkpointInterval() const { return m_checkpointInterval; }
+
+public slots:
+    void undo();
+    void redo();
+
+signals:
+    void undoAvailabilityChanged(bool available);
+    void redoAvailabilityChanged(bool available);
+    void loadProgress(int loaded, int total);
+    /// 后台载入结束时发出；被 cancelLoading() 取消时不发出。
+    void loadFinished(bool ok);
+    void saveFinished(bool ok, const QString &filePath);
+    /// 打开文件时在它上面重放了命令日志中的 records 条记录（上次未保存的修改）。
+    void journalReplayed(int records);
+
+    /// shape 当前占据的区域需要重绘（见 updateShapeArea）。
+    void shapeAreaChanged(const AbstractShape *shape);
+    /// area 中的内容变化了，例如载入了一批图形。
+    void areaChanged(const QRect &area);
+    /// 全部内容都变化了。
+    void sceneChanged();
+    /// 选择变化了。previous 是变化之前选中的图形，它们的选择装饰需要擦掉。
+    void selectionChanged(const QList<AbstractShape*> &previous);
+    /// 背景图变化了。sameImage 为 true 表示内容不变，只是改为从文件读取（保存之后）。
+    void backgroundChanged(bool sameImage);
+
+private:
+    // --- 图形管理 ---
+    QVector<AbstractShape *> shapesList;
+    QList<AbstractShape*> m_selectedShapes;
+    ShapeSpatialIndex m_spatialIndex;                      // 顶层图形重绘区域的空间索引
+    mutable QHash<const AbstractShape*, int> m_zOrder;    // 图形 -> 在 shapesList 中的下标
+    mutable bool m_zOrderDirty;                            // 中间插入/删除后需要重新编号
+
+    // --- 画布 ---
+    QSize m_canvasSize;
+    QColor m_paperColor;
+    std::function<QImage(int)> m_previewRenderer;
+
+    // --- 增量保存 ---
+    // 保存到上次载入或保存的同一个文件时，只写入这里记录的变化
+    quint64 m_nextShapeId;                                 // 下一个分配给新图形的持久 ID
+    QString m_documentPath;                                // 与上次保存状态对应的 .fpa 文件
+    QSet<AbstractShape*> m_modifiedShapes;                 // 上次保存后新增或修改过的顶层图形
+    QSet<quint64> m_deletedShapeIds;                       // 上次保存后移除的、文件中存在的图形
+    QHash<quint64, qint64> m_savedZOrder;                  // 文件中每个图形的 z_order
+    int m_firstReorderedIndex;                             // 这个下标之前的图形的 z_order 仍然有效且递增
+
+    // --- 后台载入 ---
+    DocumentLoader *m_documentLoader;
+    QString m_loadingPath;
+    int m_loadInsertIndex;                                 // 下一批载入的图形插入的位置，用户新画的图形始终在它们之上
+
+    // --- 后台保存 ---
+    DocumentSaver *m_documentSaver;
+    bool m_saveInFlight;                                   // 已开始、但结果尚未交给 finishSave 的保存
+    QString m_savingPath;
+    QString m_queuedSavePath;                              // 写入进行中时又请求的保存，前一次完成后开始
+    quint64 m_savingJournalToken;                          // 正在进行的保存对应的日志检查点
+    quint64 m_savingJournalSeq;
+
+    // --- 命令日志 ---
+    // 命令执行期间图形的增删改先记在 m_journalOps 中，命令完成后合成一条记录写入日志
+    struct PendingJournalOp
+    {
+        CommandJournal::OpType type;
+        AbstractShape *shape;
+        quint64 id;
+        quint64 belowId;
+        QPoint offset;
+    };
+    CommandJournal m_journal;
+    QVector<PendingJournalOp> m_journalOps;
+    QString m_recoveryJournalPath;                         // 没有对应文件的文档使用的日志
+    int m_checkpointInterval;
+
+    // --- 分页模式 ---
+    // 文件中的图形只有与 m_residentRegion 相交的才在 shapesList 中。
+    // 画布始终包含在 m_residentRegion 内，所以点击测试、框选和绘制看到的都是完整的内容。
+    bool m_pagedMode;                                      // 打开文件时是否使用分页模式
+    FpaDatabase *m_pagedDocument;                          // 以分页模式打开的文件，用于补充载入；为空表示全部图形都在内存中
+    QRegion m_residentRegion;                              // 与这个区域相交的文件图形都已载入
+    QSet<AbstractShape*> m_pagedShapes;                    // 与文件内容一致（载入之后未修改，或修改后已保存）、可以释放的图形
+    qint64 m_topZOrder;                                    // 文件中最大的 z_order，最上方的新图形排在它之上
+    QVector<quint64> m_savingDeletedIds;                   // 分页模式：保存失败时恢复变化记录
+    QSet<quint64> m_savingWrittenIds;
+
+    // --- 命令栈 ---
+    QStack<AbstractCommand *> undoStack;
+    QStack<AbstractCommand *> redoStack;
+
+    // --- 背景图 ---
+    BackgroundPyramid *m_background;
+    int m_backgroundRevision;          // 每次更换背景图加一
+    int m_savedBackgroundRevision;     // 文件中的背景图对应的版本，与 m_backgroundRevision 不同时保存会改写背景图
+    int m_savingBackgroundRevision;
+
+private: // 内部辅助函数
+    void setBackground(BackgroundPyramid *pyramid, bool sameImage);
+    void trackInsertedShape(AbstractShape *shape, int index);
+    void trackRemovedShape(AbstractShape *shape, int index);
+    void insertLoadedShapes(const QVector<DocumentLoader::LoadedShape> &batch);
+    void loadBackground(const QString &filePath);
+    bool captureSaveSnapshot(const QString &filePath, SaveSnapshot *snapshot);
+    void waitForPendingSave();
+    void startQueuedSave();
+    void finishSave(const QString &filePath, bool ok);
+    void recordJournalOp(CommandJournal::OpType type, AbstractShape *shape, quint64 belowId = 0, const QPoint &offset = QPoint());
+    void flushJournal();
+    int resumeJournal(const QString &documentPath);
+    int replayJournal(const QString &journalPath, quint64 afterSeq, quint64 *lastSeq);
+    bool startJournal(const QString &journalPath, quint64 token, quint64 baseSeq);
+    void closeJournal();
+    quint64 firstFreeShapeId(const QString &documentPath) const;
+    bool openPagedDocument(const QString &filePath);
+    void closePagedDocument();
+    AbstractShape *pageInShape(quint64 id);
+    void mergePagedShapes(QVector<DocumentLoader::LoadedShape> shapes);
+    void clearCommandStacks();
+    void clearRedoStack();
+    void updateUndoRedoStatus();
+    SceneExporter::Scene exportScene();
+};
+
+#endif // ARTBOARDDOCUMENT_H
@@ -6,12 +6,9 @@
 #include <QPainterPathStroker>
 #include <QImage>
 #include <QPalette>
-#include <QSqlDatabase>
-#include <QSqlQuery>
-#include <QSqlError>
-#include <QJsonDocument>
-#include <QJsonArray>
-#include <stdexcept>
+#include <QResizeEvent>
+#include <QTimer>
+#include <algorithm>
 
 #include "lineshape.h"
 #include "rectangleshape.h"
@@ -19,113 +16,170 @@
 #include "ellipseshape.h"
 #include "starshape.h"
 #include "eraserpathshape.h"
+#include "geometrykernels.h"
 #include "rotatecommand.h"
 #include "abstractcommand.h"
 #include "addshapecommand.h"
 #include "deleteshapecommand.h"
 #include "deletemultipleshapescommand.h"
-#include "clearallcommand.h"
 #include "moveshapecommand.h"
 #include "resizecommand.h"
 #include "movemultipleshapescommand.h"
 
 ArtboardView::ArtboardView(QWidget *parent)
     : QWidget{parent},
+    m_document(new ArtboardDocument),
     currentDrawingColor(Qt::black),
     currentPenWidth(2),
     currentDrawingFillColor(Qt::transparent),
     currentIsFilled(false),
+    m_strokeSimplificationTolerance(1.0),
+    m_curveFittingTolerance(0.0),
     currentShapeType(ShapeType::None),
     isCurrentlyDrawing(false),
     currentShapeInProgressPtr(nullptr),
     m_dragStartPoint_forCommand(0,0),
-    m_backgroundImage(),
-    m_hasBackgroundImage(false),
+    m_resizeSettleTimer(new QTimer(this)),
+    m_inResizeStorm(false),
+    m_sceneCache([this]() { return currentScene(); }),
     m_isResizing(false),
     m_currentHandleIndex(-1),
     m_isRotating(false)
 {
-    setAutoFillBackground(true);
+    // 背景色由场景缓存负责填充，paintEvent 会覆盖整个待重绘区域
+    setAttribute(Qt::WA_OpaquePaintEvent, true);
     QPalette pal = palette();
-    pal.setColor(QPalette::Window, Qt::white);
+    pal.setColor(QPalette::Window, m_document->paperColor());
     setPalette(pal);
-    emit undoAvailabilityChanged(false);
-    emit redoAvailabilityChanged(false);
+
+    // 调整大小停止 150ms 后，才用平滑缩放重建背景缓存
+    m_resizeSettleTimer->setSingleShot(true);
+    m_resizeSettleTimer->setInterval(150);
+    connect(m_resizeSettleTimer, &QTimer::timeout, this, [this]() {
+        // 分页模式：大小稳定之后释放已经不可见的图形，正在拖拽擦除的图形除外
+        m_document->evictPagedShapes(m_document->pagedArea(), shapesToDeleteInCurrentDrag);
+        if (m_inResizeStorm) {
+            m_inResizeStorm = false;
+            invalidateScene();
+        }
+    });
+
+    // 文档只报告哪里变了，缓存失效和重绘由视图决定
+    connect(m_document, &ArtboardDocument::shapeAreaChanged, this, &ArtboardView::updateShapeArea);
+    connect(m_document, &ArtboardDocument::areaChanged, this, &ArtboardView::updateArea);
+    connect(m_document, &ArtboardDocument::sceneChanged, this, &ArtboardView::invalidateScene);
+    connect(m_document, &ArtboardDocument::selectionChanged, this, &ArtboardView::updateSelection);
+    connect(m_document, &ArtboardDocument::backgroundChanged, this, &ArtboardView::updateBackground);
+    // 保存时的缩略图直接取自视图的瓦片缓存
+    m_document->setPreviewRenderer([this](int maxSize) { return renderPreview(maxSize); });
 }
 
 ArtboardView::~ArtboardView()
 {
-    clearAllShapes();
+    delete currentShapeInProgressPtr;
+    // 文档没有父对象：先断开它发往视图的通知，再释放它，
+    // 否则文档析构时清空图形会调用已经开始析构的视图
+    QObject::disconnect(m_document, nullptr, this, nullptr);
+    delete m_document;
 }
 
-void ArtboardView::clearAllShapes()
+void ArtboardView::setCurrentShape(ShapeType shape)
 {
-    qDeleteAll(shapesList);
-    shapesList.clear();
-    clearCommandStacks();
-
-    m_selectedShapes.clear();
+    if (currentShapeType != shape) {
+        currentShapeType = shape;
+        if (currentShapeType != ShapeType::None) {
+            m_document->setSelectedShapes(QList<AbstractShape*>());
+        }
+    }
+}
 
-    if (currentShapeInProgressPtr) {
-        delete currentShapeInProgressPtr;
-        currentShapeInProgressPtr = nullptr;
+void ArtboardView::updateShapeArea(const AbstractShape *shape)
+{
+    if (!shape) {
+        return;
     }
-    isCurrentlyDrawing = false;
+    QRect damage = shape->getDamageRect();
+    m_sceneCache.invalidateRect(damage); // 选择装饰不在缓存中，只需使图形本身的区域失效
+    if (m_document->selectedShapes().contains(const_cast<AbstractShape*>(shape))) {
+        damage = damage.united(selectionDecorationRect(shape));
+    }
+    update(damage);
+}
+
+void ArtboardView::updateArea(const QRect &area)
+{
+    m_sceneCache.invalidateRect(area);
+    update(area);
+}
+
+void ArtboardView::invalidateScene()
+{
+    m_sceneCache.invalidate();
     update();
 }
 
-void ArtboardView::setCurrentShape(ShapeType shape)
+void ArtboardView::updateBackground(bool sameImage)
 {
-    if (currentShapeType != shape) {
-        currentShapeType = shape;
-        if (currentShapeType != ShapeType::None) {
-            if (!m_selectedShapes.isEmpty()) {
-                m_selectedShapes.clear();
-                update();
-            }
-        }
+    m_backgroundCache.setPyramid(m_document->background(), sameImage);
+    if (!sameImage) {
+        invalidateScene();
     }
 }
 
+// 选中图形的选择框、缩放控制点和旋转手柄所覆盖的区域。
+// 与 paintEvent 中绘制选择框的变换保持一致，再向外留出旋转手柄 (20 像素偏移 + 5 像素半径) 的余量。
+QRect ArtboardView::selectionDecorationRect(const AbstractShape *shape) const
+{
+    QRectF coreRect = shape->getCoreGeometry();
+    QTransform transform;
+    transform.translate(shape->getCenter().x(), shape->getCenter().y());
+    transform.rotate(shape->getRotationAngle());
+    transform.translate(-shape->getCenter().x(), -shape->getCenter().y());
+
+    QRect decoration = transform.mapRect(coreRect).toAlignedRect().united(shape->getBoundingRect());
+    const int margin = 27;
+    return decoration.adjusted(-margin, -margin, margin, margin);
+}
+
+// 擦掉旧选择的装饰，画出新选择的装饰。
+void ArtboardView::updateSelection(const QList<AbstractShape*> &previous)
+{
+    for (AbstractShape *shape : previous) {
+        update(selectionDecorationRect(shape));
+    }
+    for (AbstractShape *shape : m_document->selectedShapes()) {
+        update(selectionDecorationRect(shape));
+    }
+}
 
 void ArtboardView::paintEvent(QPaintEvent *event)
 {
-    QWidget::paintEvent(event);
     QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing, true);
+    const QList<AbstractShape*> &selectedShapes = m_document->selectedShapes();
 
-    // 1. 绘制背景图 (逻辑不变)
-    if (m_hasBackgroundImage && !m_backgroundImage.isNull()) {
-        QRectF targetRect = this->rect();
-        QImage scaledImage = m_backgroundImage.scaled(targetRect.size().toSize(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
-        qreal x = targetRect.left() + (targetRect.width() - scaledImage.width()) / 2.0;
-        qreal y = targetRect.top() + (targetRect.height() - scaledImage.height()) / 2.0;
-        painter.drawImage(QPointF(x, y), scaledImage);
-    }
+    // 1+2. 背景与所有已提交的图形：从场景缓存贴图，缓存只会重新栅格化失效的瓦片。
+    //      没有背景图时画布内容与尺寸无关，调整大小可以保留旧像素。
+    m_sceneCache.resize(size(), devicePixelRatioF(), !m_backgroundCache.hasImage());
+    m_sceneCache.paint(&painter, event->region());
 
-    // 2. 绘制所有已完成的图形 (逻辑不变)
-    for (AbstractShape *shape : shapesList) {
-        if (shape) {
-            shape->draw(&painter);
-        }
-    }
+    painter.setRenderHint(QPainter::Antialiasing, true);
 
     // 3. 绘制选中框和控制点 (这是我们修改的核心)
     m_selectionHandles.clear(); // 每一帧都先清空控制点列表
 
-    if (!m_selectedShapes.isEmpty()) {
+    if (!selectedShapes.isEmpty()) {
         // --- 如果选中了多个图形，为每个图形绘制一个普通的、非倾斜的蓝色虚线框 ---
-        if (m_selectedShapes.count() > 1) {
+        if (selectedShapes.count() > 1) {
             QPen selectionPen(Qt::blue, 1, Qt::DashLine);
             painter.setPen(selectionPen);
             painter.setBrush(Qt::NoBrush);
-            for (AbstractShape* shape : m_selectedShapes) {
+            for (AbstractShape* shape : selectedShapes) {
                 painter.drawRect(shape->getBoundingRect().adjusted(-3, -3, 3, 3));
             }
         }
         // --- [ 关键修正 ] 如果只选中了一个图形，绘制倾斜的、精确的选择框和控制点 ---
-        else if (m_selectedShapes.count() == 1) {
-            AbstractShape* theOnlySelectedShape = m_selectedShapes.first();
+        else if (selectedShapes.count() == 1) {
+            AbstractShape* theOnlySelectedShape = selectedShapes.first();
             ShapeType type = theOnlySelectedShape->getType();
 
             // 1. 获取原始几何体并计算旋转后的顶点
@@ -197,10 +251,27 @@ void ArtboardView::paintEvent(QPaintEvent *event)
     }
 }
 
+// 为场景缓存准备栅格化所需的快照。只在主线程上调用：
+// 背景图的缩放结果在这里更新好，瓦片工作线程只读取已缩放的图像。
+SceneRasterCache::Scene ArtboardView::currentScene()
+{
+    SceneRasterCache::Scene scene;
+    scene.fillColor = palette().window().color();
+    if (m_backgroundCache.hasImage()) {
+        scene.background = m_backgroundCache.scaledImage(size(), devicePixelRatioF(),
+                                                         m_inResizeStorm ? Qt::FastTransformation : Qt::SmoothTransformation);
+        if (!scene.background.isNull()) {
+            scene.backgroundOffset = BackgroundCache::centeredOffset(size(), scene.background);
+        }
+    }
+    scene.shapesInArea = [this](const QRect &area) { return m_document->shapesInArea(area); };
+    return scene;
+}
+
 void ArtboardView::performStrokeEraseAtPoint(const QPoint &point)
 {
-    for (AbstractShape* shape : shapesList) {
-        if (shape && shape->getType() != ShapeType::NormalEraser && shape->containsPoint(point)) {
+    for (AbstractShape* shape : m_document->spatialIndex().query(point)) {
+        if (shape->getType() != ShapeType::NormalEraser && shape->containsPoint(point)) {
             if (!shapesToDeleteInCurrentDrag.contains(shape)) {
                 shapesToDeleteInCurrentDrag.insert(shape);
             }
@@ -208,6 +279,47 @@ void ArtboardView::performStrokeEraseAtPoint(const QPoint &point)
     }
 }
 
+// 提交自由曲线或橡皮擦路径之前简化它的点集。
+// 实时绘制时使用全部采样点，所以屏幕上看到的笔画与简化前完全一样。
+// 开启曲线拟合时，自由曲线直接从原始采样点拟合为贝塞尔曲线，不经过折线简化。
+void ArtboardView::simplifyCommittedStroke(AbstractShape *shape)
+{
+    if (m_curveFittingTolerance > 0.0 && shape->getType() == ShapeType::Freehand) {
+        FreehandPathShape *freehand = static_cast<FreehandPathShape*>(shape);
+        const QRect oldDamage = shape->getDamageRect();
+        if (freehand->fitCurves(m_curveFittingTolerance)) {
+            update(oldDamage);
+            return;
+        }
+    }
+
+    if (m_strokeSimplificationTolerance <= 0.0) {
+        return;
+    }
+
+    const QVector<QPoint> *points = nullptr;
+    if (shape->getType() == ShapeType::Freehand) {
+        points = &static_cast<FreehandPathShape*>(shape)->getPoints();
+    } else if (shape->getType() == ShapeType::NormalEraser) {
+        points = &static_cast<EraserPathShape*>(shape)->getPoints();
+    } else {
+        return;
+    }
+
+    QVector<QPoint> simplified = GeometryKernels::simplifyPolyline(*points, m_strokeSimplificationTolerance);
+    if (simplified.size() == points->size()) {
+        return;
+    }
+
+    // 简化后的包围盒可能变小，先让实时绘制的整条笔画所在区域重绘
+    update(shape->getDamageRect());
+    if (shape->getType() == ShapeType::Freehand) {
+        static_cast<FreehandPathShape*>(shape)->setPoints(simplified);
+    } else {
+        static_cast<EraserPathShape*>(shape)->setPoints(simplified);
+    }
+}
+
 void ArtboardView::mousePressEvent(QMouseEvent *event)
 {
     // 仅当按下的是鼠标左键时才处理事件
@@ -225,8 +337,8 @@ void ArtboardView::mousePressEvent(QMouseEvent *event)
             bool selectionHandled = false; // 用于标记事件是否已被控制点处理
 
             // 仅当只选中一个图形时，才检查是否点中了控制点
-            if (m_selectedShapes.count() == 1) {
-                AbstractShape* selectedShape = m_selectedShapes.first();
+            if (m_document->selectedShapes().count() == 1) {
+                AbstractShape* selectedShape = m_document->selectedShapes().first();
 
                 // 1. 最优先检查：是否点中了旋转控制点？
                 if (selectedShape->getType() != ShapeType::NormalEraser) {
@@ -260,39 +372,32 @@ void ArtboardView::mousePressEvent(QMouseEvent *event)
 
             // 3. 如果没有操作控制点，才执行“选择/移动”逻辑
             if (!selectionHandled) {
-                AbstractShape* shapeUnderMouse = nullptr;
-                for (int i = shapesList.size() - 1; i >= 0; --i) {
-                    AbstractShape* shape = shapesList.at(i);
-                    if (shape && shape->getType() != ShapeType::NormalEraser && shape->containsPoint(event->pos())) {
-                        shapeUnderMouse = shape;
-                        break;
-                    }
-                }
+                AbstractShape* shapeUnderMouse = m_document->shapeAt(event->pos());
 
                 // 检查Shift键是否被按下
                 bool isShiftPressed = (event->modifiers() & Qt::ShiftModifier);
 
+                QList<AbstractShape*> selection;
                 if (isShiftPressed) {
                     // --- Shift多选逻辑 ---
+                    selection = m_document->selectedShapes();
                     if (shapeUnderMouse) {
-                        if (m_selectedShapes.contains(shapeUnderMouse)) {
-                            m_selectedShapes.removeOne(shapeUnderMouse);
+                        if (selection.contains(shapeUnderMouse)) {
+                            selection.removeOne(shapeUnderMouse);
                         } else {
-                            m_selectedShapes.append(shapeUnderMouse);
+                            selection.append(shapeUnderMouse);
                         }
                     }
                 } else {
                     // --- 原有的单选逻辑 ---
-                    m_selectedShapes.clear();
                     if (shapeUnderMouse) {
-                        m_selectedShapes.append(shapeUnderMouse);
+                        selection.append(shapeUnderMouse);
                     }
                 }
-
-                update(); // 立即重绘，以显示新的选择状态
+                m_document->setSelectedShapes(selection); // 文档通知视图重绘新旧选择的装饰
 
                 // 如果选中了图形，则进入准备拖动的状态
-                if (!m_selectedShapes.isEmpty()) {
+                if (!selection.isEmpty()) {
                     isCurrentlyDrawing = true;
                     tempStartPoint = event->pos();
                     m_dragStartPoint_forCommand = event->pos();
@@ -305,17 +410,9 @@ void ArtboardView::mousePressEvent(QMouseEvent *event)
         // 分支二至四：所有“绘图/橡皮擦工具”模式
         // ===================================================================
         else if (currentShapeType == ShapeType::StrokeEraser) {
-            AbstractShape *shapeHit = nullptr;
-            int hitIndex = -1;
-            for (int i = shapesList.size() - 1; i >= 0; --i) {
-                if (shapesList.at(i) && shapesList.at(i)->getType() != ShapeType::NormalEraser && shapesList.at(i)->containsPoint(event->pos())) {
-                    shapeHit = shapesList.at(i);
-                    hitIndex = i;
-                    break;
-                }
-            }
+            AbstractShape *shapeHit = m_document->shapeAt(event->pos());
             if (shapeHit) {
-                this->executeCommand(new DeleteShapeCommand(shapeHit, this, hitIndex));
+                m_document->executeCommand(new DeleteShapeCommand(shapeHit, m_document, m_document->zOrderOf(shapeHit)));
             }
         }
         else if (currentShapeType == ShapeType::DraggingStrokeEraser) {
@@ -341,7 +438,7 @@ void ArtboardView::mousePressEvent(QMouseEvent *event)
                 currentShapeInProgressPtr = new FreehandPathShape(QVector<QPoint>() << tempStartPoint, currentDrawingColor, currentPenWidth);
                 break;
             case ShapeType::NormalEraser:
-                currentShapeInProgressPtr = new EraserPathShape(QVector<QPoint>() << tempStartPoint, currentPenWidth, palette().window().color());
+                currentShapeInProgressPtr = new EraserPathShape(QVector<QPoint>() << tempStartPoint, currentPenWidth, m_document->paperColor());
                 break;
             case ShapeType::Ellipse:
                 currentShapeInProgressPtr = new EllipseShape(QRectF(tempStartPoint, tempStartPoint), currentDrawingColor, currentPenWidth, currentIsFilled, currentDrawingFillColor);
@@ -370,8 +467,8 @@ void ArtboardView::mouseMoveEvent(QMouseEvent *event)
     }
 
     if (currentShapeType == ShapeType::None) { // 选择工具模式
-        if (m_selectedShapes.count() == 1) { // 仅当只选中一个图形时，才处理旋转和缩放
-            AbstractShape* selectedShape = m_selectedShapes.first();
+        if (m_document->selectedShapes().count() == 1) { // 仅当只选中一个图形时，才处理旋转和缩放
+            AbstractShape* selectedShape = m_document->selectedShapes().first();
 
             if (m_isRotating) {
                 // (旋转逻辑已正确，保持不变)
@@ -379,8 +476,9 @@ void ArtboardView::mouseMoveEvent(QMouseEvent *event)
                 QLineF currentLine(m_rotationCenter, QPointF(event->pos()));
                 qreal angleDelta = startLine.angleTo(currentLine);
                 qreal newAngle = m_rotationStartAngle - angleDelta;
+                m_document->updateShapeArea(selectedShape);
                 selectedShape->setRotationAngle(newAngle);
-                update();
+                m_document->updateShapeArea(selectedShape);
             }
             else if (m_isResizing) {
                 // [ 最终的、最健壮的缩放逻辑 ]
@@ -407,19 +505,21 @@ void ArtboardView::mouseMoveEvent(QMouseEvent *event)
                 case 7: newLocalRect = m_resizeOriginalRect; newLocalRect.setRight(localCurrentMouse.x()); break;
                 }
                 // 使用 normalized() 来正确处理“翻转”的情况
+                m_document->updateShapeArea(selectedShape);
                 selectedShape->setGeometry(newLocalRect.normalized().toRect()); // <-- 在最后加上 .toRect()
-                update();
+                m_document->updateShapeArea(selectedShape);
             }
         }
 
         // 移动逻辑 (可作用于多选)
-        if (!m_isRotating && !m_isResizing && !m_selectedShapes.isEmpty()) {
+        if (!m_isRotating && !m_isResizing && !m_document->selectedShapes().isEmpty()) {
             QPoint offset = event->pos() - tempStartPoint;
-            for (AbstractShape* shape : m_selectedShapes) {
+            for (AbstractShape* shape : m_document->selectedShapes()) {
+                m_document->updateShapeArea(shape);
                 shape->moveBy(offset);
+                m_document->updateShapeArea(shape);
             }
             tempStartPoint = event->pos();
-            update();
         }
     }
     else if (currentShapeType == ShapeType::DraggingStrokeEraser) {
@@ -428,27 +528,38 @@ void ArtboardView::mouseMoveEvent(QMouseEvent *event)
     }
     // 绘图逻辑
     else if (currentShapeInProgressPtr) {
-        currentShapeInProgressPtr->updateShape(event->pos());
-        update();
+        ShapeType type = currentShapeInProgressPtr->getType();
+        if (type == ShapeType::Freehand || type == ShapeType::NormalEraser) {
+            // 自由曲线和橡皮擦每次只追加一段，只需重绘新线段覆盖的区域
+            QPoint lastPoint = (type == ShapeType::Freehand)
+                                   ? static_cast<FreehandPathShape*>(currentShapeInProgressPtr)->getPoints().last()
+                                   : static_cast<EraserPathShape*>(currentShapeInProgressPtr)->getPoints().last();
+            currentShapeInProgressPtr->updateShape(event->pos());
+            int margin = currentShapeInProgressPtr->getPenWidth() + 2;
+            update(QRect(lastPoint, event->pos()).normalized().adjusted(-margin, -margin, margin, margin));
+        } else {
+            QRect oldDamage = currentShapeInProgressPtr->getDamageRect();
+            currentShapeInProgressPtr->updateShape(event->pos());
+            update(oldDamage.united(currentShapeInProgressPtr->getDamageRect()));
+        }
     }
 }
 
 
-// ----------------- artboardview.cpp (请将此函数完整地添加到文件中) -----------------
 void ArtboardView::mouseReleaseEvent(QMouseEvent *event)
 {
     // 确保是鼠标左键释放，并且之前确实处于一个交互操作中
     if (event->button() == Qt::LeftButton && isCurrentlyDrawing) {
 
         // 仅当只选中一个图形时，才处理旋转和缩放命令
-        if (m_selectedShapes.count() == 1) {
-            AbstractShape* selectedShape = m_selectedShapes.first();
+        if (m_document->selectedShapes().count() == 1) {
+            AbstractShape* selectedShape = m_document->selectedShapes().first();
             // 1. 如果刚刚完成的是一次旋转操作
             if (m_isRotating) {
                 qreal finalAngle = selectedShape->getRotationAngle();
                 if (qAbs(finalAngle - m_rotationStartAngle) > 0.01) {
                     selectedShape->setRotationAngle(m_rotationStartAngle);
-                    executeCommand(new RotateCommand(selectedShape, this, m_rotationStartAngle, finalAngle));
+                    m_document->executeCommand(new RotateCommand(selectedShape, m_document, m_rotationStartAngle, finalAngle));
                 }
             }
             // 2. 如果完成的是一次缩放操作
@@ -456,21 +567,21 @@ void ArtboardView::mouseReleaseEvent(QMouseEvent *event)
                 QRect finalRect = selectedShape->getCoreGeometry().toRect();
                 if (m_resizeOriginalRect.toRect() != finalRect) {
                     selectedShape->setGeometry(m_resizeOriginalRect.toRect());
-                    executeCommand(new ResizeCommand(selectedShape, this, m_resizeOriginalRect.toRect(), finalRect));
+                    m_document->executeCommand(new ResizeCommand(selectedShape, m_document, m_resizeOriginalRect.toRect(), finalRect));
                 }
             }
         }
 
         // 3. 如果完成的是一次移动操作 (可作用于多选)
-        if (currentShapeType == ShapeType::None && !m_isResizing && !m_isRotating && !m_selectedShapes.isEmpty()) {
+        if (currentShapeType == ShapeType::None && !m_isResizing && !m_isRotating && !m_document->selectedShapes().isEmpty()) {
             QPoint totalOffset = event->pos() - m_dragStartPoint_forCommand;
             if(!totalOffset.isNull()){
                 // 先将所有图形移回原位
-                for(AbstractShape* shape : m_selectedShapes) {
+                for(AbstractShape* shape : m_document->selectedShapes()) {
                     shape->moveBy(-totalOffset);
                 }
                 // 然后通过一个宏命令来执行移动，以便一次性撤销
-                executeCommand(new MoveMultipleShapesCommand(m_selectedShapes, totalOffset, this));
+                m_document->executeCommand(new MoveMultipleShapesCommand(m_document->selectedShapes(), totalOffset, m_document));
             }
         }
         // 4. 如果完成的是拖拽橡皮擦
@@ -479,16 +590,16 @@ void ArtboardView::mouseReleaseEvent(QMouseEvent *event)
                 QList<DeleteShapeCommand*> commands;
                 QList<AbstractShape*> sortedShapes = shapesToDeleteInCurrentDrag.values();
                 std::sort(sortedShapes.begin(), sortedShapes.end(), [this](AbstractShape* a, AbstractShape* b){
-                    return shapesList.indexOf(a) > shapesList.indexOf(b);
+                    return m_document->zOrderOf(a) > m_document->zOrderOf(b);
                 });
                 for (AbstractShape* shape : sortedShapes) {
-                    int index = shapesList.indexOf(shape);
+                    int index = m_document->zOrderOf(shape);
                     if (index != -1) {
-                        commands.append(new DeleteShapeCommand(shape, this, index));
+                        commands.append(new DeleteShapeCommand(shape, m_document, index));
                     }
                 }
                 if(!commands.isEmpty()){
-                    this->executeCommand(new DeleteMultipleShapesCommand(commands));
+                    m_document->executeCommand(new DeleteMultipleShapesCommand(commands));
                 }
                 shapesToDeleteInCurrentDrag.clear();
             }
@@ -502,12 +613,13 @@ void ArtboardView::mouseReleaseEvent(QMouseEvent *event)
             }
 
             if (shapeIsValid) {
-                this->executeCommand(new AddShapeCommand(currentShapeInProgressPtr, this));
+                simplifyCommittedStroke(currentShapeInProgressPtr);
+                m_document->executeCommand(new AddShapeCommand(currentShapeInProgressPtr, m_document));
                 currentShapeInProgressPtr = nullptr;
             } else {
+                update(currentShapeInProgressPtr->getDamageRect());
                 delete currentShapeInProgressPtr;
                 currentShapeInProgressPtr = nullptr;
-                update();
             }
         }
 
@@ -555,171 +667,45 @@ void ArtboardView::enableFill(bool enable)
     }
 }
 
-void ArtboardView::undo()
+QImage ArtboardView::renderPreview(int maxSize)
 {
-    if (!undoStack.isEmpty()) {
-        AbstractCommand *commandToUndo = undoStack.pop();
-        commandToUndo->undo();
-        redoStack.push(commandToUndo);
-        updateUndoRedoStatus();
+    if (size().isEmpty()) {
+        return QImage();
     }
-}
-
-void ArtboardView::redo()
-{
-    if (!redoStack.isEmpty()) {
-        AbstractCommand *commandToRedo = redoStack.pop();
-        commandToRedo->execute();
-        undoStack.push(commandToRedo);
-        updateUndoRedoStatus();
+    QSize previewSize = size();
+    if (previewSize.width() > maxSize || previewSize.height() > maxSize) {
+        previewSize.scale(maxSize, maxSize, Qt::KeepAspectRatio);
     }
+    QImage preview(previewSize, QImage::Format_ARGB32_Premultiplied);
+    QPainter painter(&preview);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, true);
+    painter.scale(qreal(previewSize.width()) / width(), qreal(previewSize.height()) / height());
+    // 与 paintEvent 使用同一份瓦片，只有脏瓦片需要重新栅格化
+    m_sceneCache.resize(size(), devicePixelRatioF(), !m_backgroundCache.hasImage());
+    m_sceneCache.paint(&painter, QRegion(rect()));
+    return preview;
 }
 
-void ArtboardView::clearCommandStacks()
+void ArtboardView::resizeEvent(QResizeEvent *event)
 {
-    qDeleteAll(undoStack);
-    undoStack.clear();
-    qDeleteAll(redoStack);
-    redoStack.clear();
-    updateUndoRedoStatus();
-}
-
-void ArtboardView::updateUndoRedoStatus()
-{
-    emit undoAvailabilityChanged(!undoStack.isEmpty());
-    emit redoAvailabilityChanged(!redoStack.isEmpty());
-}
-
-void ArtboardView::clearRedoStack()
-{
-    if (!redoStack.isEmpty()) {
-        qDeleteAll(redoStack);
-        redoStack.clear();
-    }
-    updateUndoRedoStatus();
-}
-
-QImage ArtboardView::renderToImage()
-{
-    QImage imageToRender(this->size(), QImage::Format_ARGB32_Premultiplied);
-    QPainter painter(&imageToRender);
-    painter.setRenderHint(QPainter::Antialiasing, true);
-    painter.fillRect(imageToRender.rect(), palette().window().color());
-    if (m_hasBackgroundImage && !m_backgroundImage.isNull()) {
-        QRectF targetRect = imageToRender.rect();
-        QImage scaledImage = m_backgroundImage.scaled(targetRect.size().toSize(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
-        qreal x = targetRect.left() + (targetRect.width() - scaledImage.width()) / 2.0;
-        qreal y = targetRect.top() + (targetRect.height() - scaledImage.height()) / 2.0;
-        painter.drawImage(QPointF(x, y), scaledImage);
+    QWidget::resizeEvent(event);
+    // 分页模式：新露出的区域在下一次绘制之前载入
+    m_document->setCanvasSize(size());
+    if (m_backgroundCache.hasImage()) {
+        // 连续调整大小时每帧都会触发 resizeEvent，先用快速缩放，停下来后再平滑缩放
+        m_inResizeStorm = true;
+        m_resizeSettleTimer->start();
+    } else if (m_document->isPagedDocument()) {
+        m_resizeSettleTimer->start();
     }
-    for (AbstractShape *shape : shapesList) {
-        if (shape) {
-            shape->draw(&painter);
-        }
-    }
-    return imageToRender;
 }
 
-void ArtboardView::executeCommand(AbstractCommand *command)
-{
-    if (!command) return;
-    command->execute();
-    undoStack.push(command);
-    clearRedoStack();
-}
-
-void ArtboardView::setBackgroundImage(const QImage &image)
-{
-    if (image.isNull()) {
-        if (m_hasBackgroundImage) {
-            m_backgroundImage = QImage();
-            m_hasBackgroundImage = false;
-            update();
-        }
-    } else {
-        m_backgroundImage = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
-        m_hasBackgroundImage = true;
-        update();
-    }
-}
-
-void ArtboardView::clearBackgroundImage()
-{
-    if (m_hasBackgroundImage) {
-        m_backgroundImage = QImage();
-        m_hasBackgroundImage = false;
-        update();
-    }
-}
-
-
-bool ArtboardView::saveToDatabase(const QString &filePath)
-{
-    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "saver_connection");
-    db.setDatabaseName(filePath);
-    if (!db.open()) { qWarning() << "Error: Failed to connect to database." << db.lastError(); return false; }
-
-    QSqlQuery query(db);
-    query.exec("CREATE TABLE IF NOT EXISTS shapes (id INTEGER PRIMARY KEY, type TEXT, json_data TEXT)");
-    db.transaction();
-    try {
-        query.exec("DELETE FROM shapes");
-        for (AbstractShape *shape : shapesList) {
-            if (!shape) continue;
-            QJsonObject jsonObj = shape->toJsonObject();
-            QString type = jsonObj["type"].toString();
-            QString jsonString = QString(QJsonDocument(jsonObj).toJson(QJsonDocument::Compact));
-            query.prepare("INSERT INTO shapes (type, json_data) VALUES (:type, :json)");
-            query.bindValue(":type", type);
-            query.bindValue(":json", jsonString);
-            if(!query.exec()){ throw std::runtime_error(query.lastError().text().toStdString()); }
-        }
-    } catch (const std::exception& e) {
-        qWarning() << "Error during database transaction:" << e.what();
-        db.rollback();
-        db.close();
-        QSqlDatabase::removeDatabase("saver_connection");
-        return false;
-    }
-    db.commit();
-    db.close();
-    QSqlDatabase::removeDatabase("saver_connection");
-    qDebug() << "Canvas saved successfully!";
-    return true;
-}
-
-bool ArtboardView::loadFromDatabase(const QString &filePath)
-{
-    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "loader_connection");
-    db.setDatabaseName(filePath);
-    if (!db.open()) { qWarning() << "Error: Failed to open database." << db.lastError(); return false; }
-
-    clearAllShapes();
-    QSqlQuery query(db);
-    if(!query.exec("SELECT json_data FROM shapes")){ qWarning() << "Error: Failed to query shapes." << query.lastError(); db.close(); QSqlDatabase::removeDatabase("loader_connection"); return false; }
-
-    while (query.next()) {
-        QString jsonString = query.value(0).toString();
-        QJsonObject jsonObj = QJsonDocument::fromJson(jsonString.toUtf8()).object();
-        AbstractShape *shape = AbstractShape::fromJsonObject(jsonObj);
-        if (shape) {
-            shapesList.append(shape);
-        }
-    }
-    db.close();
-    QSqlDatabase::removeDatabase("loader_connection");
-    update();
-    qDebug() << "Canvas loaded successfully!";
-    return true;
-}
-
-
 QPointF ArtboardView::calculateRotationHandlePos() const
 {
-    if (m_selectedShapes.count() != 1) {
+    if (m_document->selectedShapes().count() != 1) {
         return QPointF();
     }
-    AbstractShape* selectedShape = m_selectedShapes.first();
+    AbstractShape* selectedShape = m_document->selectedShapes().first();
 
     // 复用和paintEvent中完全相同的逻辑来计算位置
     QRectF coreRect = selectedShape->getCoreGeometry();
@@ -739,8 +725,3 @@ QPointF ArtboardView::calculateRotationHandlePos() const
 
     return rotationHandlePos;
 }
-
-const QList<AbstractShape*>& ArtboardView::getSelectedShapes() const
-{
-    return m_selectedShapes;
-}
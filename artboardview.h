@@ -1,94 +1,93 @@
 #ifndef ARTBOARDVIEW_H
 #define ARTBOARDVIEW_H
 
+// ---------------------------------------------------------------------------
+// 描述: 定义了 ArtboardView 类，显示和编辑 ArtboardDocument 的画布部件。
+//       视图只负责绘制（场景栅格缓存、背景图缓存、选择装饰和正在绘制的图形），
+//       以及把鼠标操作转换为命令交给文档执行；图形、选择、撤销/重做和文件读写都在文档中。
+// ---------------------------------------------------------------------------
+
 #include <QWidget>
 #include <QColor>
-#include <QStack>
-#include <QVector>
 #include <QSet>
 #include <QImage>
 
 #include "shared_types.h"
+#include "artboarddocument.h"
+#include "backgroundcache.h"
+#include "scenerastercache.h"
 
 class AbstractShape;
-class AbstractCommand;
+class QTimer;
 
 class ArtboardView : public QWidget
 {
     Q_OBJECT
 
 public:
+    static constexpr qreal DefaultCurveFittingTolerance = 1.0; ///< 开启曲线拟合时使用的误差（像素）。
+
     explicit ArtboardView(QWidget *parent = nullptr);
     ~ArtboardView() override;
 
+    /// @brief 视图显示和编辑的文档。文档属于视图，随视图一起释放。
+    ArtboardDocument *document() const { return m_document; }
+
     void setCurrentShape(ShapeType shape);
     void setCurrentDrawingColor(const QColor &color);
     void setCurrentPenWidth(int width);
     void setCurrentDrawingFillColor(const QColor &color);
     void enableFill(bool enable);
-    void setBackgroundImage(const QImage &image);
-    void clearBackgroundImage();
-    void clearAllShapes();
-    QImage renderToImage();
+
+    /// @brief 设置提交自由曲线和橡皮擦路径时的简化容差（像素）。
+    /// 绘制过程中保留全部采样点，松开鼠标时用 Ramer–Douglas–Peucker 算法删除
+    /// 偏差不超过该值的点。传入 0 关闭简化。
+    void setStrokeSimplificationTolerance(qreal pixels) { m_strokeSimplificationTolerance = qMax<qreal>(0.0, pixels); }
+    qreal strokeSimplificationTolerance() const { return m_strokeSimplificationTolerance; }
+    /// 提交自由曲线时把它拟合为三次贝塞尔曲线的最大误差（像素），默认为 0，即不拟合。
+    /// 拟合会丢弃原始采样点，并使文件升级到 SchemaVersion 7，因此只在用户选择时开启（MainWindow 的“平滑曲线”）。
+    /// 开启后自由曲线改为拟合曲线，不再做折线简化；橡皮擦路径仍按折线简化。
+    void setCurveFittingTolerance(qreal pixels) { m_curveFittingTolerance = qMax<qreal>(0.0, pixels); }
+    qreal curveFittingTolerance() const { return m_curveFittingTolerance; }
     int getCurrentPenWidth() const { return currentPenWidth; }
     QColor getCurrentDrawingColor() const { return currentDrawingColor; }
     QColor getCurrentDrawingFillColor() const { return currentDrawingFillColor; }
-    void executeCommand(AbstractCommand *command);
-    bool saveToDatabase(const QString &filePath);
-    bool loadFromDatabase(const QString &filePath);
-    const QList<AbstractShape*>& getSelectedShapes() const;
-
-public slots:
-    void undo();
-    void redo();
-
-signals:
-    void undoAvailabilityChanged(bool available);
-    void redoAvailabilityChanged(bool available);
 
 protected:
     void paintEvent(QPaintEvent *event) override;
     void mousePressEvent(QMouseEvent *event) override;
     void mouseMoveEvent(QMouseEvent *event) override;
     void mouseReleaseEvent(QMouseEvent *event) override;
-
-    friend class AddShapeCommand;
-    friend class DeleteShapeCommand;
-    friend class ClearAllCommand;
-    friend class MoveShapeCommand;
-    friend class ResizeCommand; // 新增对 ResizeCommand 的友元
-    friend class AddMultipleShapesCommand;
-    friend class GroupCommand;     // <-- 添加这一行
-    friend class UngroupCommand;   // <-- 添加这一行
+    void resizeEvent(QResizeEvent *event) override;
 
 private:
+    ArtboardDocument *m_document;
+
     // --- 绘图属性 ---
     QColor currentDrawingColor;
     int currentPenWidth;
     QColor currentDrawingFillColor;
     bool currentIsFilled;
+    qreal m_strokeSimplificationTolerance;
+    qreal m_curveFittingTolerance;
 
     // --- 操作状态和数据 ---
     ShapeType currentShapeType;
     bool isCurrentlyDrawing;
     AbstractShape *currentShapeInProgressPtr;
     QPoint tempStartPoint;
-
-    // --- 图形管理 ---
-    QVector<AbstractShape *> shapesList;
-    QList<AbstractShape*> m_selectedShapes;
     QPoint m_dragStartPoint_forCommand;
 
-    // --- 命令栈 ---
-    QStack<AbstractCommand *> undoStack;
-    QStack<AbstractCommand *> redoStack;
-
     // --- 橡皮擦相关 ---
     QSet<AbstractShape*> shapesToDeleteInCurrentDrag;
 
     // --- 背景图 ---
-    QImage m_backgroundImage;
-    bool m_hasBackgroundImage;
+    BackgroundCache m_backgroundCache; // 文档背景图按当前尺寸缩放好的缓存
+    QTimer *m_resizeSettleTimer;       // 连续调整大小结束后，触发一次高质量重缩放
+    bool m_inResizeStorm;              // 正在连续调整大小，背景图暂用快速缩放
+
+    // --- 已提交场景的栅格缓存 ---
+    SceneRasterCache m_sceneCache;     // 背景 + 文档图形的栅格化瓦片，按文档报告的区域失效
 
     // --- 缩放/调整大小相关 ---
     QList<QRect> m_selectionHandles;
@@ -103,10 +102,19 @@ private:
 
 private: // 内部辅助函数
     void performStrokeEraseAtPoint(const QPoint &point);
-    void clearCommandStacks();
-    void clearRedoStack();
-    void updateUndoRedoStatus();
+    void simplifyCommittedStroke(AbstractShape *shape);
+    SceneRasterCache::Scene currentScene();
+    QImage renderPreview(int maxSize);
+
+    // 文档变化的通知
+    void updateShapeArea(const AbstractShape *shape);
+    void updateArea(const QRect &area);
+    void invalidateScene();
+    void updateSelection(const QList<AbstractShape*> &previous);
+    void updateBackground(bool sameImage);
+
     QPointF calculateRotationHandlePos() const;
+    QRect selectionDecorationRect(const AbstractShape *shape) const;
 };
 
 #endif // ARTBOARDVIEW_H
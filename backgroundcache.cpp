@@ -0,0 +1,68 @@
+#include "backgroundcache.h"
+#include "backgroundpyramid.h"
+
+BackgroundCache::BackgroundCache()
+    : m_pyramid(nullptr),
+    m_scaledForDpr(0.0),
+    m_scaledMode(Qt::FastTransformation)
+{
+}
+
+void BackgroundCache::setPyramid(BackgroundPyramid *pyramid, bool sameImage)
+{
+    if (!pyramid) {
+        clear();
+        return;
+    }
+    m_pyramid = pyramid;
+    if (!sameImage) {
+        m_scaled = QImage();
+        m_scaledForSize = QSize();
+        m_scaledForDpr = 0.0;
+    }
+}
+
+void BackgroundCache::clear()
+{
+    m_pyramid = nullptr;
+    m_scaled = QImage();
+    m_scaledForSize = QSize();
+    m_scaledForDpr = 0.0;
+}
+
+const QImage &BackgroundCache::scaledImage(const QSize &targetSize, qreal devicePixelRatio, Qt::TransformationMode mode)
+{
+    if (!m_pyramid || targetSize.isEmpty()) {
+        m_scaled = QImage();
+        m_scaledForSize = QSize();
+        return m_scaled;
+    }
+
+    // 命中缓存：键相同，且缓存的质量不低于请求的质量
+    bool sameKey = (m_scaledForSize == targetSize && qFuzzyCompare(m_scaledForDpr, devicePixelRatio));
+    bool qualityOk = (m_scaledMode == Qt::SmoothTransformation || mode == Qt::FastTransformation);
+    if (sameKey && qualityOk && !m_scaled.isNull()) {
+        return m_scaled;
+    }
+
+    // 从不小于缩放结果的最小一级开始缩放，不必每次都从原图缩小
+    QSize physicalSize = targetSize * devicePixelRatio;
+    const QSize fitted = m_pyramid->imageSize().scaled(physicalSize, Qt::KeepAspectRatio);
+    const QImage source = m_pyramid->levelImage(m_pyramid->levelFor(fitted));
+    m_scaled = source.scaled(physicalSize, Qt::KeepAspectRatio, mode);
+    m_scaled.setDevicePixelRatio(devicePixelRatio);
+    m_scaledForSize = targetSize;
+    m_scaledForDpr = devicePixelRatio;
+    m_scaledMode = mode;
+    return m_scaled;
+}
+
+QPointF BackgroundCache::centeredOffset(const QSize &targetSize, const QImage &scaled)
+{
+    // 缩放结果带有 devicePixelRatio，这里换算回逻辑尺寸后再居中
+    qreal dpr = scaled.devicePixelRatio();
+    qreal logicalWidth = scaled.width() / dpr;
+    qreal logicalHeight = scaled.height() / dpr;
+    return QPointF((targetSize.width() - logicalWidth) / 2.0,
+                   (targetSize.height() - logicalHeight) / 2.0);
+}
@@ -0,0 +1,60 @@
+#ifndef BACKGROUNDCACHE_H
+#define BACKGROUNDCACHE_H
+
+// ---------------------------------------------------------------------------
+// 描述: 定义了背景图缓存类 BackgroundCache。
+//       它引用文档的背景图金字塔（见 BackgroundPyramid，由 ArtboardDocument 持有），并缓存一份按当前目标尺寸和设备像素比缩放好的结果，
+//       避免 ArtboardView 在每一帧 paintEvent 中都对大图做一次平滑缩放。
+//       缩放总是从不小于目标尺寸的最小一级开始，来自文件的背景图只读取这一级的瓦片。
+// ---------------------------------------------------------------------------
+
+#include <QImage>
+#include <QSize>
+#include <QPointF>
+
+class BackgroundPyramid;
+
+/// @brief BackgroundCache 缓存缩放后的背景图。
+///
+/// 缓存以 (目标逻辑尺寸, 设备像素比) 为键，只有在尺寸、像素比或原图变化时才重新缩放。
+/// 调用方可以请求快速缩放 (Qt::FastTransformation)，用于窗口连续调整大小期间的临时显示；
+/// 一旦再请求平滑缩放，缓存会自动升级为高质量的结果。
+class BackgroundCache
+{
+public:
+    BackgroundCache();
+
+    /// @brief 改用 pyramid 作为背景图。缓存不持有 pyramid，调用方保证它在下一次 setPyramid 之前有效；
+    ///        pyramid 为 nullptr 时等同于 clear()。
+    /// @param sameImage 为 true 表示 pyramid 与当前背景图内容相同（例如保存之后改为从文件读取），
+    ///        已缓存的缩放结果继续有效。
+    void setPyramid(BackgroundPyramid *pyramid, bool sameImage = false);
+
+    /// @brief 清除背景图和缩放缓存。
+    void clear();
+
+    bool hasImage() const { return m_pyramid != nullptr; }
+    BackgroundPyramid *pyramid() const { return m_pyramid; }
+
+    /// @brief 获取按 KeepAspectRatio 适配 targetSize 的缩放结果。
+    /// @param targetSize 目标区域的逻辑尺寸。
+    /// @param devicePixelRatio 设备像素比，结果图会按物理像素生成并设置相应的 devicePixelRatio。
+    /// @param mode 缩放质量。缓存中已有同键的平滑结果时，快速请求也会直接复用它。
+    /// @return 缓存中的缩放结果；没有背景图时返回空图。
+    const QImage &scaledImage(const QSize &targetSize, qreal devicePixelRatio, Qt::TransformationMode mode);
+
+    /// @brief 计算缩放结果在 targetSize 区域内居中绘制时的左上角位置（逻辑坐标）。
+    static QPointF centeredOffset(const QSize &targetSize, const QImage &scaled);
+
+private:
+    BackgroundCache(const BackgroundCache &) = delete;
+    BackgroundCache &operator=(const BackgroundCache &) = delete;
+
+    BackgroundPyramid *m_pyramid;       ///< 背景图的各级缩小版本（不持有）。
+    QImage m_scaled;                    ///< 缓存的缩放结果。
+    QSize m_scaledForSize;              ///< m_scaled 对应的目标逻辑尺寸。
+    qreal m_scaledForDpr;               ///< m_scaled 对应的设备像素比。
+    Qt::TransformationMode m_scaledMode; ///< m_scaled 的缩放质量。
+};
+
+#endif // BACKGROUNDCACHE_H
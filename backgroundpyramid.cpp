@@ -0,0 +1,233 @@
+#include "backgroundpyramid.h"
+#include "fpadatabase.h"
+#include <QBuffer>
+#include <QPainter>
+#include <QThread>
+#include <QtConcurrent>
+#include <QDebug>
+
+namespace {
+
+const char *const TileFormat = "PNG";
+const char *const WidthKey = "background_width";
+const char *const HeightKey = "background_height";
+const char *const TileSizeKey = "background_tile_size";
+const char *const FormatKey = "background_format";
+
+// 不同线程同时读取不同文件（例如批量渲染）时，每个线程使用自己的连接
+QString readerConnectionName()
+{
+    return QString("background_reader_%1").arg(quintptr(QThread::currentThreadId()));
+}
+
+QImage shrink(const QImage &image, const QSize &size)
+{
+    return image.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+}
+
+}
+
+BackgroundPyramid::BackgroundPyramid(const QImage &image)
+    : m_imageSize(image.size()),
+    m_levelCount(levelCountFor(image.size()))
+{
+    m_levels.resize(qMax(1, m_levelCount));
+    // 预先转换为 Premultiplied 格式，缩小和绘制这种格式最快
+    m_levels[0] = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+}
+
+BackgroundPyramid::BackgroundPyramid(const QString &filePath, const QSize &imageSize)
+    : m_filePath(filePath),
+    m_imageSize(imageSize),
+    m_levelCount(levelCountFor(imageSize))
+{
+    m_levels.resize(m_levelCount);
+}
+
+BackgroundPyramid::~BackgroundPyramid()
+{
+}
+
+BackgroundPyramid *BackgroundPyramid::open(const QString &filePath)
+{
+    FpaDatabase db(readerConnectionName());
+    if (!db.open(filePath)) {
+        return nullptr;
+    }
+    const QSize size(db.metaValue(WidthKey).toInt(), db.metaValue(HeightKey).toInt());
+    const int tileSize = db.metaValue(TileSizeKey).toInt();
+    const QString format = db.metaValue(FormatKey).toString();
+    db.close();
+    if (size.isEmpty()) {
+        return nullptr;
+    }
+    if (tileSize != TileSize || format != TileFormat) {
+        qWarning() << "Error: Unsupported background tiles in" << filePath << tileSize << format;
+        return nullptr;
+    }
+    return new BackgroundPyramid(filePath, size);
+}
+
+bool BackgroundPyramid::write(const QImage &image, FpaDatabase *db)
+{
+    if (!db->deleteBackgroundTiles()) {
+        return false;
+    }
+    if (image.isNull()) {
+        return db->removeMetaValue(WidthKey) && db->removeMetaValue(HeightKey)
+               && db->removeMetaValue(TileSizeKey) && db->removeMetaValue(FormatKey);
+    }
+
+    // 逐级由上一级缩小，同一时间只保留一级；每一级的瓦片互不相关，并行编码
+    QImage level = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    const int count = levelCountFor(image.size());
+    for (int l = 0; l < count; ++l) {
+        if (l > 0) {
+            level = shrink(level, levelSize(image.size(), l));
+        }
+        QVector<FpaDatabase::TileRow> tiles;
+        for (int y = 0; y * TileSize < level.height(); ++y) {
+            for (int x = 0; x * TileSize < level.width(); ++x) {
+                tiles.append(FpaDatabase::TileRow{ l, x, y, QByteArray() });
+            }
+        }
+        const QImage source = level;
+        QtConcurrent::blockingMap(tiles, [&source](FpaDatabase::TileRow &tile) {
+            const QRect rect = QRect(tile.x * TileSize, tile.y * TileSize, TileSize, TileSize) & source.rect();
+            QBuffer buffer(&tile.data);
+            buffer.open(QIODevice::WriteOnly);
+            source.copy(rect).save(&buffer, TileFormat);
+        });
+        for (const FpaDatabase::TileRow &tile : tiles) {
+            if (tile.data.isEmpty()) {
+                qWarning() << "Error: Failed to encode background tile" << tile.level << tile.x << tile.y;
+                return false;
+            }
+            if (!db->writeBackgroundTile(tile)) {
+                return false;
+            }
+        }
+    }
+    return db->setMetaValue(WidthKey, image.width()) && db->setMetaValue(HeightKey, image.height())
+           && db->setMetaValue(TileSizeKey, TileSize) && db->setMetaValue(FormatKey, QString(TileFormat));
+}
+
+// 瓦片已经编码好，逐行复制即可，不需要解码
+bool BackgroundPyramid::copy(FpaDatabase *source, FpaDatabase *db)
+{
+    if (!db->deleteBackgroundTiles()) {
+        return false;
+    }
+    bool ok = true;
+    if (!source->readBackgroundTiles(-1, [db, &ok](const FpaDatabase::TileRow &tile) {
+            ok = db->writeBackgroundTile(tile);
+            return ok;
+        }) || !ok) {
+        return false;
+    }
+    for (const char *key : { WidthKey, HeightKey, TileSizeKey, FormatKey }) {
+        const QVariant value = source->metaValue(key);
+        if (!(value.isValid() ? db->setMetaValue(key, value) : db->removeMetaValue(key))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int BackgroundPyramid::levelFor(const QSize &size) const
+{
+    for (int level = m_levelCount - 1; level > 0; --level) {
+        const QSize available = levelSize(m_imageSize, level);
+        if (available.width() >= size.width() && available.height() >= size.height()) {
+            return level;
+        }
+    }
+    return 0;
+}
+
+QImage BackgroundPyramid::levelImage(int level)
+{
+    if (level < 0 || level >= m_levelCount) {
+        return QImage();
+    }
+    if (!m_levels.at(level).isNull()) {
+        return m_levels.at(level);
+    }
+    if (m_filePath.isEmpty()) {
+        m_levels[level] = shrink(levelImage(level - 1), levelSize(m_imageSize, level));
+    } else {
+        // 文件中的背景图可能很大，内存中只保留当前用到的一级
+        m_levels.fill(QImage());
+        m_levels[level] = readTiles(level, QRect(QPoint(0, 0), levelSize(m_imageSize, level)));
+    }
+    return m_levels.at(level);
+}
+
+QImage BackgroundPyramid::region(int level, const QRect &rect)
+{
+    if (level < 0 || level >= m_levelCount) {
+        return QImage();
+    }
+    const QRect area = rect & QRect(QPoint(0, 0), levelSize(m_imageSize, level));
+    if (area.isEmpty()) {
+        return QImage();
+    }
+    if (m_filePath.isEmpty() || !m_levels.at(level).isNull()) {
+        return levelImage(level).copy(area);
+    }
+    return readTiles(level, area);
+}
+
+// 读取并拼合第 level 级中与 rect 相交的瓦片，结果的左上角是 rect 的左上角
+QImage BackgroundPyramid::readTiles(int level, const QRect &rect)
+{
+    const QRect tileRange(QPoint(rect.left() / TileSize, rect.top() / TileSize),
+                          QPoint(rect.right() / TileSize, rect.bottom() / TileSize));
+    QVector<FpaDatabase::TileRow> tiles;
+    {
+        FpaDatabase db(readerConnectionName());
+        if (!db.open(m_filePath) || !db.readBackgroundTiles(level, [&tiles](const FpaDatabase::TileRow &tile) {
+                tiles.append(tile);
+                return true;
+            }, tileRange)) {
+            return QImage();
+        }
+    }
+    const QVector<QImage> decoded = QtConcurrent::blockingMapped<QVector<QImage>>(tiles, [](const FpaDatabase::TileRow &tile) {
+        return QImage::fromData(tile.data, TileFormat);
+    });
+
+    QImage image(rect.size(), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    for (int i = 0; i < tiles.size(); ++i) {
+        if (decoded.at(i).isNull()) {
+            qWarning() << "Error: Failed to decode background tile" << level << tiles.at(i).x << tiles.at(i).y;
+            continue;
+        }
+        painter.drawImage(QPoint(tiles.at(i).x * TileSize, tiles.at(i).y * TileSize) - rect.topLeft(), decoded.at(i));
+    }
+    return image;
+}
+
+QSize BackgroundPyramid::levelSize(const QSize &imageSize, int level)
+{
+    const int scale = 1 << level;
+    return QSize(qMax(1, (imageSize.width() + scale - 1) / scale),
+                 qMax(1, (imageSize.height() + scale - 1) / scale));
+}
+
+int BackgroundPyramid::levelCountFor(const QSize &imageSize)
+{
+    if (imageSize.isEmpty()) {
+        return 0;
+    }
+    int count = 1;
+    QSize size = imageSize;
+    while (size.width() > TileSize || size.height() > TileSize) {
+        size = levelSize(imageSize, count);
+        ++count;
+    }
+    return count;
+}
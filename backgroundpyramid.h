@@ -0,0 +1,71 @@
+#ifndef BACKGROUNDPYRAMID_H
+#define BACKGROUNDPYRAMID_H
+
+// ---------------------------------------------------------------------------
+// 描述: 定义了 BackgroundPyramid 类，背景图的多分辨率金字塔。
+//       第 0 级是原图，之后每一级的宽高都是上一级的一半（向上取整），直到整张图放得进一个瓦片。
+//       显示时只需要取出不小于目标尺寸的最小一级，而不必每次都从原图缩放。
+//
+//       金字塔有两种来源：
+//           内存   用户刚载入、尚未保存的图片，各级在第一次用到时由上一级缩小得到
+//           文件   .fpa 文件的 background_tiles 表，每级切成 TileSize 见方的瓦片，
+//                  每个瓦片是一个 PNG 数据块；打开时只读取 meta 表中的尺寸，
+//                  绘制时只读取并解码所需那一级的瓦片
+// ---------------------------------------------------------------------------
+
+#include <QImage>
+#include <QSize>
+#include <QString>
+#include <QVector>
+
+class FpaDatabase;
+
+class BackgroundPyramid
+{
+public:
+    /// 瓦片边长（像素）。
+    static const int TileSize = 512;
+
+    /// @brief 以内存中的图片为第 0 级。
+    explicit BackgroundPyramid(const QImage &image);
+    ~BackgroundPyramid();
+
+    /// @brief 打开 filePath 中保存的背景图，只读取尺寸信息。
+    /// @return 文件中没有背景图或无法打开时返回 nullptr；否则由调用方负责释放。
+    static BackgroundPyramid *open(const QString &filePath);
+
+    /// @brief 用 image 的各级瓦片替换 db 中的背景图并记下尺寸信息；image 为空时删除背景图。
+    /// 在 db 的写事务中调用，可以在后台线程中调用。
+    static bool write(const QImage &image, FpaDatabase *db);
+    /// @brief 把 source 中的背景图原样复制到 db。在 db 的写事务中调用。
+    static bool copy(FpaDatabase *source, FpaDatabase *db);
+
+    QSize imageSize() const { return m_imageSize; }
+    int levelCount() const { return m_levelCount; }
+    /// 瓦片所在的文件；内存中的金字塔返回空字符串。
+    QString filePath() const { return m_filePath; }
+    /// 内存中的原图；来自文件的金字塔返回空图。
+    QImage sourceImage() const { return m_filePath.isEmpty() ? m_levels.value(0) : QImage(); }
+
+    /// @brief 缩放到 size 时应当使用的一级：不小于 size 的最小一级。
+    int levelFor(const QSize &size) const;
+    /// @brief 第 level 级的完整图像。失败时返回空图。
+    QImage levelImage(int level);
+    /// @brief 第 level 级中 rect 范围内的图像。来自文件的背景图只读取与 rect 相交的瓦片，
+    /// 导出远大于屏幕的图像时不必把整级读入内存。
+    QImage region(int level, const QRect &rect);
+
+    static QSize levelSize(const QSize &imageSize, int level);
+    static int levelCountFor(const QSize &imageSize);
+
+private:
+    BackgroundPyramid(const QString &filePath, const QSize &imageSize);
+    QImage readTiles(int level, const QRect &rect);
+
+    QString m_filePath;
+    QSize m_imageSize;
+    int m_levelCount;
+    QVector<QImage> m_levels;   // 内存：已经生成的各级；文件：只保留最近读取的一级
+};
+
+#endif // BACKGROUNDPYRAMID_H
@@ -4,17 +4,17 @@
 // ---------------------------------------------------------------------------
 
 #include "clearallcommand.h"
-#include "artboardview.h" // 需要 ArtboardView 的完整定义，以便访问其 shapesList (通过友元) 或调用其方法
+#include "artboarddocument.h" // 需要 ArtboardDocument 的完整定义，以便调用其方法
 #include "abstractshape.h" // m_clearedShapes 中存储的是 AbstractShape*
 #include <QDebug>         // 用于调试输出
 
 /// @brief ClearAllCommand 构造函数的实现。
-/// @param view 指向 ArtboardView 实例的指针。
-ClearAllCommand::ClearAllCommand(ArtboardView *view)
-    : m_artboardView(view)
+/// @param document 指向 ArtboardDocument 实例的指针。
+ClearAllCommand::ClearAllCommand(ArtboardDocument *document)
+    : m_document(document)
 // m_clearedShapes (QVector) 会被默认构造为空列表
 {
-    // qDebug() << "ClearAllCommand CONSTRUCTOR: Created for ArtboardView:" << (void*)m_artboardView;
+    // qDebug() << "ClearAllCommand CONSTRUCTOR: Created for ArtboardDocument:" << (void*)m_document;
 }
 
 /// @brief ClearAllCommand 析构函数的实现。
@@ -34,47 +34,50 @@ ClearAllCommand::~ClearAllCommand()
 }
 
 /// @brief 执行“清空所有图形”命令。
-/// 将 ArtboardView 当前 `shapesList` 中的所有图形对象的指针转移到本命令的
-/// `m_clearedShapes` 列表中进行备份，然后清空 ArtboardView 的 `shapesList`，
-/// 最后请求 ArtboardView 更新其显示。
+/// 将 ArtboardDocument 当前 `shapesList` 中的所有图形对象的指针转移到本命令的
+/// `m_clearedShapes` 列表中进行备份，然后清空 ArtboardDocument 的 `shapesList`，
+/// 最后通知视图刷新。
 void ClearAllCommand::execute()
 {
-    if (!m_artboardView) { // 安全检查
-        qWarning("ClearAllCommand::execute() - ArtboardView is null.");
+    if (!m_document) { // 安全检查
+        qWarning("ClearAllCommand::execute() - ArtboardDocument is null.");
         return;
     }
 
+    // 分页模式下先载入文件中不在内存里的图形，否则它们在保存后仍然留在文件中，撤销时也无法恢复
+    m_document->pageInAll();
+
     qDebug() << "ClearAllCommand: Executing - Clearing all shapes from view. Backing up"
-             << m_artboardView->shapesList.size() << "shapes.";
+             << m_document->shapes().size() << "shapes.";
 
-    // 1. 将 ArtboardView 当前的 shapesList 中的内容“转移”到 m_clearedShapes。
+    // 1. 将 ArtboardDocument 当前的 shapesList 中的内容“转移”到 m_clearedShapes。
     //    这里是直接用 QVector 的赋值操作符，它会进行深拷贝（对于指针是拷贝指针值）。
     //    重要的是，ClearAllCommand 现在逻辑上“拥有”了这些被清空的图形对象。
-    //    ArtboardView 的 shapesList 接下来会被清空。
-    m_clearedShapes = m_artboardView->shapesList; // 备份当前的所有图形指针
+    //    ArtboardDocument 的 shapesList 接下来会被清空。
+    m_clearedShapes = m_document->shapes(); // 备份当前的所有图形指针
 
-    // 2. 清空 ArtboardView 的实际图形列表。
+    // 2. 清空 ArtboardDocument 的实际图形列表。
     //    注意：这里只清空了列表中的指针，并没有 delete 图形对象，因为它们已被 m_clearedShapes“接管”。
-    m_artboardView->shapesList.clear();           // 通过友元直接访问并清空
+    m_document->replaceAllShapes(QVector<AbstractShape*>()); // 清空列表和空间索引
 
-    // 3. 请求 ArtboardView 重绘，此时画布上将不再显示任何图形（背景图除外）。
-    m_artboardView->update();
+    // 3. 通知视图重绘，此时画布上将不再显示任何图形（背景图除外）。
+    m_document->invalidateScene();
 }
 
 /// @brief 撤销“清空所有图形”命令（即恢复所有之前被清空的图形）。
 /// 将本命令在 `execute()` 时备份在 `m_clearedShapes` 列表中的所有图形对象的指针
-/// 移回到 ArtboardView 的 `shapesList` 中，然后清空本命令的 `m_clearedShapes` 列表
-/// （因为图形的所有权已交还给 ArtboardView），最后请求 ArtboardView 更新其显示。
+/// 移回到 ArtboardDocument 的 `shapesList` 中，然后清空本命令的 `m_clearedShapes` 列表
+/// （因为图形的所有权已交还给 ArtboardDocument），最后通知视图刷新。
 void ClearAllCommand::undo()
 {
-    if (!m_artboardView) { // 安全检查
-        qWarning("ClearAllCommand::undo() - ArtboardView is null.");
+    if (!m_document) { // 安全检查
+        qWarning("ClearAllCommand::undo() - ArtboardDocument is null.");
         return;
     }
 
     // 检查 m_clearedShapes 是否真的有内容可以恢复。
     // 如果 execute() 时 shapesList 本来就是空的，那么 m_clearedShapes 也会是空的。
-    if (m_clearedShapes.isEmpty() && !m_artboardView->shapesList.isEmpty()) {
+    if (m_clearedShapes.isEmpty() && !m_document->shapes().isEmpty()) {
         // 如果备份列表是空的，但视图列表不是空的，这可能表示一个不一致的状态
         // （例如，在清空后又执行了其他添加操作，然后才撤销清空）。
         // 这种情况下，直接用空列表覆盖视图列表可能不是期望的。
@@ -85,24 +88,24 @@ void ClearAllCommand::undo()
         // 但这可能与更复杂的命令序列交互产生问题。
         // 一个更简单的假设是：undo() 总是将 m_clearedShapes 的内容赋给 shapesList。
         // 如果 m_clearedShapes 为空，shapesList 也会变空。
-        // qDeleteAll(m_artboardView->shapesList); // 如果需要先删除当前内容
-        // m_artboardView->shapesList.clear();
+        // qDeleteAll(m_document->shapes()); // 如果需要先删除当前内容
+        // m_document->shapes().clear();
     } else if (m_clearedShapes.isEmpty()) {
         qDebug() << "ClearAllCommand: Undoing - No shapes in backup to restore.";
-        // ArtboardView的shapesList可能已经是空的，或者我们不改变它。
+        // ArtboardDocument的shapesList可能已经是空的，或者我们不改变它。
         // 无论如何，m_clearedShapes 已空，所有权已转移。
-        m_artboardView->update(); // 确保视图刷新（即使没有内容变化）
+        m_document->invalidateScene(); // 确保视图刷新（即使没有内容变化）
         return;
     }
 
 
     qDebug() << "ClearAllCommand: Undoing - Restoring" << m_clearedShapes.size() << "shapes to view.";
 
-    // 1. 将备份在 m_clearedShapes 中的图形列表内容恢复到 ArtboardView 的 shapesList。
-    //    我们假设在调用 undo() 之前，ArtboardView 的 shapesList 应该是空的（因为 execute() 刚清空了它）。
+    // 1. 将备份在 m_clearedShapes 中的图形列表内容恢复到 ArtboardDocument 的 shapesList。
+    //    我们假设在调用 undo() 之前，ArtboardDocument 的 shapesList 应该是空的（因为 execute() 刚清空了它）。
     //    如果不是，直接赋值会覆盖掉 shapesList 中现有的内容。对于 ClearAllCommand 的 undo 来说，
     //    这通常是期望的行为——恢复到“清空”操作之前的状态。
-    if (!m_artboardView->shapesList.isEmpty()) {
+    if (!m_document->shapes().isEmpty()) {
         // 这是一个警告，表明在撤销“清空”之前，画布上又有了其他图形。
         // 这通常发生在“清空”之后，用户又画了新图形，然后再撤销“清空”。
         // 此时，标准行为应该是“清空”操作之前的图形被恢复，而之后画的新图形应该不受影响（即它们还在）。
@@ -121,19 +124,25 @@ void ClearAllCommand::undo()
         // 这是命令模式中需要仔细考虑的交互问题。
 
         // **当前实现：简单覆盖。**
-        qWarning() << "ClearAllCommand::undo() - ArtboardView's shapesList was not empty before restoring."
-                   << "It contained" << m_artboardView->shapesList.size() << "shapes which will be overwritten by the"
+        qWarning() << "ClearAllCommand::undo() - ArtboardDocument's shapesList was not empty before restoring."
+                   << "It contained" << m_document->shapes().size() << "shapes which will be overwritten by the"
                    << m_clearedShapes.size() << "restored shapes.";
-        qDeleteAll(m_artboardView->shapesList); // 先删除当前列表中的内容，以避免内存泄漏
-        m_artboardView->shapesList.clear();
+        qDeleteAll(m_document->shapes()); // 先删除当前列表中的内容，以避免内存泄漏
     }
 
-    m_artboardView->shapesList = m_clearedShapes; // 将备份的图形列表指针复制回 ArtboardView 的主列表
+    m_document->replaceAllShapes(m_clearedShapes); // 将备份的图形列表指针复制回 ArtboardDocument 的主列表，并重建空间索引
 
-    // 2. 清空本命令内部的 m_clearedShapes 列表，因为这些图形对象的所有权已经交还给了 ArtboardView。
+    // 2. 清空本命令内部的 m_clearedShapes 列表，因为这些图形对象的所有权已经交还给了 ArtboardDocument。
     //    注意：这里只清空指针列表，而不 delete 对象，因为对象已经“还给”了 shapesList。
     m_clearedShapes.clear();
 
-    // 3. 请求 ArtboardView 重绘以显示恢复的图形。
-    m_artboardView->update();
+    // 3. 通知视图重绘以显示恢复的图形。
+    m_document->invalidateScene();
+}
+
+void ClearAllCommand::collectShapes(QSet<AbstractShape*> *shapes) const
+{
+    for (AbstractShape *shape : m_clearedShapes) {
+        shapes->insert(shape);
+    }
 }
@@ -0,0 +1,327 @@
+#include "commandjournal.h"
+#include "shapecodec.h"
+#include <QSaveFile>
+#include <QtEndian>
+#include <QDebug>
+
+namespace {
+
+const char Magic[4] = { 'F', 'P', 'A', 'J' };
+const int HeaderSize = 4 + 1 + 8 + 8;
+const int SeqSize = 8;
+const int LengthSize = 4;
+const int ChecksumSize = 2;
+
+void appendUInt64(QByteArray &out, quint64 value)
+{
+    char bytes[8];
+    qToLittleEndian(value, bytes);
+    out.append(bytes, 8);
+}
+
+void appendBody(QByteArray &out, const QByteArray &body)
+{
+    ShapeCodec::appendVarint(out, body.size());
+    out.append(body);
+}
+
+bool readBody(const QByteArray &in, int *pos, QByteArray *body)
+{
+    qint64 size = 0;
+    if (!ShapeCodec::readVarint(in, pos, &size) || size < 0 || size > in.size() - *pos) {
+        return false;
+    }
+    *body = in.mid(*pos, int(size));
+    *pos += int(size);
+    return true;
+}
+
+}
+
+CommandJournal::CommandJournal()
+    : m_lastSeq(0),
+    m_recordCount(0)
+{
+}
+
+CommandJournal::~CommandJournal()
+{
+    close();
+}
+
+bool CommandJournal::create(const QString &path, quint64 token, quint64 baseSeq, const QVector<Op> &initialOps)
+{
+    close();
+    Header header;
+    header.token = token;
+    header.baseSeq = baseSeq;
+
+    // 先完整写出新文件再替换，旧日志在新日志就绪之前一直有效
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Error: Failed to create journal" << path << file.errorString();
+        return false;
+    }
+    QByteArray data = encodeHeader(header);
+    if (!initialOps.isEmpty()) {
+        data.append(encodeRecord(baseSeq + 1, initialOps));
+    }
+    if (file.write(data) != data.size() || !file.commit()) {
+        qWarning() << "Error: Failed to write journal" << path << file.errorString();
+        return false;
+    }
+
+    if (!openForAppend(path)) {
+        return false;
+    }
+    m_header = header;
+    m_recordCount = initialOps.isEmpty() ? 0 : 1;
+    m_lastSeq = baseSeq + m_recordCount;
+    return true;
+}
+
+void CommandJournal::close(bool removeIfEmpty)
+{
+    if (!m_file.isOpen()) {
+        return;
+    }
+    m_file.close();
+    if (removeIfEmpty && m_recordCount == 0) {
+        m_file.remove();
+    }
+    m_header = Header();
+    m_lastSeq = 0;
+    m_recordCount = 0;
+}
+
+bool CommandJournal::append(const QVector<Op> &ops)
+{
+    if (!m_file.isOpen() || ops.isEmpty()) {
+        return false;
+    }
+    const QByteArray record = encodeRecord(m_lastSeq + 1, ops);
+    // 一次系统调用；返回之后即使进程被结束，记录也已经在操作系统手中
+    if (m_file.write(record) != record.size()) {
+        qWarning() << "Error: Failed to append to journal" << m_file.fileName() << m_file.errorString();
+        return false;
+    }
+    ++m_lastSeq;
+    ++m_recordCount;
+    return true;
+}
+
+bool CommandJournal::compact(const QString &newPath, quint64 token, quint64 baseSeq)
+{
+    const QString oldPath = m_file.fileName();
+    QByteArray kept;
+    int keptCount = 0;
+    if (m_file.isOpen()) {
+        Header oldHeader;
+        readRecords(oldPath, &oldHeader, [&](quint64 seq, const QByteArray &, const QByteArray &record) {
+            if (seq > baseSeq) {
+                kept.append(record);
+                ++keptCount;
+            }
+            return true;
+        });
+    }
+    const quint64 lastSeq = qMax(m_lastSeq, baseSeq);
+    m_file.close();
+
+    Header header;
+    header.token = token;
+    header.baseSeq = baseSeq;
+    QSaveFile file(newPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Error: Failed to create journal" << newPath << file.errorString();
+        return false;
+    }
+    const QByteArray data = encodeHeader(header) + kept;
+    if (file.write(data) != data.size() || !file.commit()) {
+        qWarning() << "Error: Failed to write journal" << newPath << file.errorString();
+        return false;
+    }
+    if (!oldPath.isEmpty() && oldPath != newPath) {
+        QFile::remove(oldPath);
+    }
+
+    if (!openForAppend(newPath)) {
+        return false;
+    }
+    m_header = header;
+    m_lastSeq = lastSeq;
+    m_recordCount = keptCount;
+    return true;
+}
+
+bool CommandJournal::readHeader(const QString &path, Header *header)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QByteArray data = file.read(HeaderSize);
+    if (data.size() != HeaderSize || !data.startsWith(QByteArray(Magic, 4)) || quint8(data.at(4)) != FormatVersion) {
+        return false;
+    }
+    header->token = qFromLittleEndian<quint64>(data.constData() + 5);
+    header->baseSeq = qFromLittleEndian<quint64>(data.constData() + 13);
+    return true;
+}
+
+bool CommandJournal::read(const QString &path, Header *header,
+                          const std::function<bool(quint64, const QVector<Op> &)> &visitor)
+{
+    return readRecords(path, header, [&visitor](quint64 seq, const QByteArray &payload, const QByteArray &) {
+        QVector<Op> ops;
+        if (!decodeOps(payload, &ops)) {
+            qWarning() << "Error: Corrupt journal record" << seq;
+            return false;
+        }
+        return visitor(seq, ops);
+    });
+}
+
+bool CommandJournal::hasRecords(const QString &path)
+{
+    Header header;
+    bool found = false;
+    readRecords(path, &header, [&found](quint64, const QByteArray &, const QByteArray &) {
+        found = true;
+        return false;
+    });
+    return found;
+}
+
+bool CommandJournal::readRecords(const QString &path, Header *header,
+                                 const std::function<bool(quint64, const QByteArray &, const QByteArray &)> &visitor)
+{
+    if (!readHeader(path, header)) {
+        return false;
+    }
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QByteArray data = file.readAll();
+    int pos = HeaderSize;
+    while (data.size() - pos >= LengthSize) {
+        const quint32 length = qFromLittleEndian<quint32>(data.constData() + pos);
+        if (length < quint32(SeqSize) || length > quint32(data.size() - pos - LengthSize - ChecksumSize)) {
+            break; // 写到一半的最后一条记录
+        }
+        const QByteArray payload = data.mid(pos + LengthSize, int(length));
+        const quint16 checksum = qFromLittleEndian<quint16>(data.constData() + pos + LengthSize + length);
+        if (qChecksum(payload) != checksum) {
+            qWarning() << "Journal" << path << "has a damaged record; ignoring it and everything after it.";
+            break;
+        }
+        const int recordSize = LengthSize + int(length) + ChecksumSize;
+        const quint64 seq = qFromLittleEndian<quint64>(payload.constData());
+        if (!visitor(seq, payload, data.mid(pos, recordSize))) {
+            break;
+        }
+        pos += recordSize;
+    }
+    return true;
+}
+
+QByteArray CommandJournal::encodeHeader(const Header &header)
+{
+    QByteArray data(Magic, 4);
+    data.append(char(FormatVersion));
+    appendUInt64(data, header.token);
+    appendUInt64(data, header.baseSeq);
+    return data;
+}
+
+QByteArray CommandJournal::encodeRecord(quint64 seq, const QVector<Op> &ops)
+{
+    QByteArray payload;
+    payload.reserve(SeqSize + ops.size() * 8);
+    appendUInt64(payload, seq);
+    for (const Op &op : ops) {
+        payload.append(char(op.type));
+        ShapeCodec::appendVarint(payload, qint64(op.id));
+        switch (op.type) {
+        case Put:
+            ShapeCodec::appendVarint(payload, qint64(op.belowId));
+            appendBody(payload, op.body);
+            break;
+        case Update:
+            appendBody(payload, op.body);
+            break;
+        case Translate:
+            ShapeCodec::appendVarint(payload, op.offset.x());
+            ShapeCodec::appendVarint(payload, op.offset.y());
+            break;
+        case Remove:
+            break;
+        }
+    }
+
+    QByteArray record;
+    record.reserve(LengthSize + payload.size() + ChecksumSize);
+    char bytes[4];
+    qToLittleEndian(quint32(payload.size()), bytes);
+    record.append(bytes, LengthSize);
+    record.append(payload);
+    qToLittleEndian(qChecksum(payload), bytes);
+    record.append(bytes, ChecksumSize);
+    return record;
+}
+
+bool CommandJournal::decodeOps(const QByteArray &payload, QVector<Op> *ops)
+{
+    int pos = SeqSize;
+    while (pos < payload.size()) {
+        Op op;
+        op.type = OpType(quint8(payload.at(pos++)));
+        qint64 id = 0;
+        if (!ShapeCodec::readVarint(payload, &pos, &id)) {
+            return false;
+        }
+        op.id = quint64(id);
+        op.belowId = 0;
+        switch (op.type) {
+        case Put: {
+            qint64 belowId = 0;
+            if (!ShapeCodec::readVarint(payload, &pos, &belowId) || !readBody(payload, &pos, &op.body)) {
+                return false;
+            }
+            op.belowId = quint64(belowId);
+            break;
+        }
+        case Update:
+            if (!readBody(payload, &pos, &op.body)) {
+                return false;
+            }
+            break;
+        case Translate: {
+            qint64 dx = 0, dy = 0;
+            if (!ShapeCodec::readVarint(payload, &pos, &dx) || !ShapeCodec::readVarint(payload, &pos, &dy)) {
+                return false;
+            }
+            op.offset = QPoint(int(dx), int(dy));
+            break;
+        }
+        case Remove:
+            break;
+        default:
+            return false;
+        }
+        ops->append(op);
+    }
+    return true;
+}
+
+bool CommandJournal::openForAppend(const QString &path)
+{
+    m_file.setFileName(path);
+    // 不使用 QFile 的写缓冲，每次 write() 都直接进入操作系统
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Unbuffered)) {
+        qWarning() << "Error: Failed to open journal" << path << m_file.errorString();
+        return false;
+    }
+    return true;
+}
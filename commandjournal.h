@@ -0,0 +1,109 @@
+#ifndef COMMANDJOURNAL_H
+#define COMMANDJOURNAL_H
+
+// ---------------------------------------------------------------------------
+// 描述: 定义了 CommandJournal 类，防止程序意外退出时丢失工作的只追加命令日志。
+//       每个经过 ArtboardDocument::executeCommand/undo/redo 的命令完成后追加一条记录，
+//       记录它对顶层图形的净效果：
+//           Put        把图形（完整编码）放在 belowId 所指的图形之上；同 ID 的图形已存在时替换它
+//           Remove     移除图形
+//           Update     用新的编码替换图形，位置不变
+//           Translate  平移图形，只记录偏移量
+//       每条记录用一次 write() 直接交给操作系统（不经过用户态缓冲），
+//       程序被强行结束时，已经完成的命令都不会丢失。
+//
+//       日志是 .fpa 文件的补充。文件头记录它所基于的检查点（token 和序号），
+//       .fpa 的 meta 表记录最近一次保存对应的检查点；打开文件时重放序号更大的记录。
+//       每次保存都是一次检查点，保存成功后日志被压缩为只包含保存开始之后的记录。
+//
+//       文件格式（小端）：
+//           文件头  "FPAJ" | u8 格式版本 | u64 token | u64 基准序号
+//           记录    u32 内容长度 | 内容 | u16 内容的 CRC（qChecksum）
+//           内容    u64 序号 | 若干操作，每个操作为 u8 类型加上变长整数字段
+//       最后一条记录不完整或校验失败时（写到一半被中断），读取在它之前停止。
+// ---------------------------------------------------------------------------
+
+#include <QByteArray>
+#include <QFile>
+#include <QPoint>
+#include <QString>
+#include <QVector>
+#include <functional>
+
+class CommandJournal
+{
+public:
+    static const int FormatVersion = 1;
+
+    enum OpType : quint8
+    {
+        Put = 1,
+        Remove = 2,
+        Update = 3,
+        Translate = 4
+    };
+
+    struct Op
+    {
+        OpType type;
+        quint64 id;
+        quint64 belowId;    // Put：下方相邻图形的 ID，0 表示放在最底层
+        QByteArray body;    // Put、Update：ShapeCodec 编码的图形记录
+        QPoint offset;      // Translate
+    };
+
+    struct Header
+    {
+        quint64 token = 0;      // 对应 .fpa 文件 meta 表中的 journal_token；未保存过的画布为 0
+        quint64 baseSeq = 0;    // 基准检查点的序号，日志中的记录都比它大
+    };
+
+    CommandJournal();
+    ~CommandJournal();
+
+    /// @brief 在 path 创建新的日志（已有文件被原子地替换），写入文件头和 initialOps 组成的第一条记录，
+    /// 之后可以继续追加。initialOps 为空时只写文件头。
+    bool create(const QString &path, quint64 token, quint64 baseSeq, const QVector<Op> &initialOps = QVector<Op>());
+
+    /// @brief 关闭日志。removeIfEmpty 为 true 且没有任何记录时删除文件。
+    void close(bool removeIfEmpty = false);
+
+    bool isOpen() const { return m_file.isOpen(); }
+    QString path() const { return m_file.fileName(); }
+    quint64 token() const { return m_header.token; }
+    /// 最后一条记录的序号；没有记录时等于基准序号。
+    quint64 lastSeq() const { return m_lastSeq; }
+    /// 基准检查点之后的记录数。
+    int recordCount() const { return m_recordCount; }
+
+    /// @brief 把 ops 作为一条新记录追加到日志末尾，序号为 lastSeq() + 1。
+    bool append(const QVector<Op> &ops);
+
+    /// @brief 检查点：把序号大于 baseSeq 的记录写入 newPath 处的新日志并改为向它追加。
+    /// newPath 与原路径不同时删除原日志。
+    bool compact(const QString &newPath, quint64 token, quint64 baseSeq);
+
+    static bool readHeader(const QString &path, Header *header);
+    /// @brief 按顺序读取 path 中的所有完整记录。
+    /// @param visitor 对每条记录调用一次；返回 false 时停止读取。
+    /// @return 无法打开文件或文件头无效时返回 false。
+    static bool read(const QString &path, Header *header,
+                     const std::function<bool(quint64 seq, const QVector<Op> &ops)> &visitor);
+    /// @brief path 处是否存在至少一条有效记录。
+    static bool hasRecords(const QString &path);
+
+private:
+    static QByteArray encodeRecord(quint64 seq, const QVector<Op> &ops);
+    static bool decodeOps(const QByteArray &payload, QVector<Op> *ops);
+    static QByteArray encodeHeader(const Header &header);
+    static bool readRecords(const QString &path, Header *header,
+                            const std::function<bool(quint64 seq, const QByteArray &payload, const QByteArray &record)> &visitor);
+    bool openForAppend(const QString &path);
+
+    QFile m_file;
+    Header m_header;
+    quint64 m_lastSeq;
+    int m_recordCount;
+};
+
+#endif // COMMANDJOURNAL_H
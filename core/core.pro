@@ -0,0 +1,84 @@
+# ---------------------------------------------------------------------------
+# fishplatecore：与界面无关的静态库。包含图形、命令、文档模型 (ArtboardDocument)、
+# 编解码、.fpa 文件读写、背景图金字塔和导出。只依赖 QtGui（QPainter/QImage）、QtSql 和 QtConcurrent，
+# 不需要 QWidget。使用它的工程包含 ../fishplatecore.pri 即可链接。
+# ---------------------------------------------------------------------------
+
+TEMPLATE = lib
+
+QT -= widgets
+QT += core gui sql concurrent
+
+CONFIG += staticlib c++17
+
+TARGET = fishplatecore
+
+SOURCES += \
+    ../abstractshape.cpp \
+    ../addmultipleshapescommand.cpp \
+    ../addshapecommand.cpp \
+    ../artboarddocument.cpp \
+    ../backgroundcache.cpp \
+    ../backgroundpyramid.cpp \
+    ../clearallcommand.cpp \
+    ../commandjournal.cpp \
+    ../curvefitter.cpp \
+    ../deletemultipleshapescommand.cpp \
+    ../deleteshapecommand.cpp \
+    ../documentloader.cpp \
+    ../documentsaver.cpp \
+    ../ellipseshape.cpp \
+    ../eraserpathshape.cpp \
+    ../fpadatabase.cpp \
+    ../freehandpathshape.cpp \
+    ../geometrykernels.cpp \
+    ../groupcommand.cpp \
+    ../groupshape.cpp \
+    ../lineshape.cpp \
+    ../movemultipleshapescommand.cpp \
+    ../moveshapecommand.cpp \
+    ../rectangleshape.cpp \
+    ../resizecommand.cpp \
+    ../rotatecommand.cpp \
+    ../sceneexporter.cpp \
+    ../scenerastercache.cpp \
+    ../shapecodec.cpp \
+    ../shapespatialindex.cpp \
+    ../starshape.cpp \
+    ../ungroupcommand.cpp
+
+HEADERS += \
+    ../abstractcommand.h \
+    ../abstractshape.h \
+    ../addmultipleshapescommand.h \
+    ../addshapecommand.h \
+    ../artboarddocument.h \
+    ../backgroundcache.h \
+    ../backgroundpyramid.h \
+    ../clearallcommand.h \
+    ../commandjournal.h \
+    ../curvefitter.h \
+    ../deletemultipleshapescommand.h \
+    ../deleteshapecommand.h \
+    ../documentloader.h \
+    ../documentsaver.h \
+    ../ellipseshape.h \
+    ../eraserpathshape.h \
+    ../fpadatabase.h \
+    ../freehandpathshape.h \
+    ../geometrykernels.h \
+    ../groupcommand.h \
+    ../groupshape.h \
+    ../lineshape.h \
+    ../movemultipleshapescommand.h \
+    ../moveshapecommand.h \
+    ../rectangleshape.h \
+    ../resizecommand.h \
+    ../rotatecommand.h \
+    ../sceneexporter.h \
+    ../scenerastercache.h \
+    ../shapecodec.h \
+    ../shapespatialindex.h \
+    ../shared_types.h \
+    ../starshape.h \
+    ../ungroupcommand.h
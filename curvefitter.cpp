@@ -0,0 +1,233 @@
+#include "curvefitter.h"
+#include <QtMath>
+#include <algorithm>
+
+QPointF CubicSegment::pointAt(qreal t) const
+{
+    const qreal mt = 1.0 - t;
+    return p0 * (mt * mt * mt) + c1 * (3.0 * mt * mt * t) + c2 * (3.0 * mt * t * t) + p3 * (t * t * t);
+}
+
+namespace {
+
+// 拟合误差超过 maxError 但不超过这个倍数时，先尝试重新参数化，而不是直接拆分
+const qreal ReparameterizeErrorFactor = 4.0;
+const int MaxReparameterizeIterations = 4;
+
+qreal dot(const QPointF &a, const QPointF &b)
+{
+    return a.x() * b.x() + a.y() * b.y();
+}
+
+QPointF normalized(const QPointF &v)
+{
+    const qreal length = qSqrt(dot(v, v));
+    return length > 0.0 ? v / length : v;
+}
+
+// 三次伯恩斯坦基函数
+qreal b0(qreal u) { qreal t = 1.0 - u; return t * t * t; }
+qreal b1(qreal u) { qreal t = 1.0 - u; return 3.0 * u * t * t; }
+qreal b2(qreal u) { qreal t = 1.0 - u; return 3.0 * u * u * t; }
+qreal b3(qreal u) { return u * u * u; }
+
+QPointF derivative(const CubicSegment &s, qreal t)
+{
+    const qreal mt = 1.0 - t;
+    return (s.c1 - s.p0) * (3.0 * mt * mt) + (s.c2 - s.c1) * (6.0 * mt * t) + (s.p3 - s.c2) * (3.0 * t * t);
+}
+
+QPointF secondDerivative(const CubicSegment &s, qreal t)
+{
+    return (s.c2 - s.c1 * 2.0 + s.p0) * (6.0 * (1.0 - t)) + (s.p3 - s.c2 * 2.0 + s.c1) * (6.0 * t);
+}
+
+// 按弦长为 [first, last] 中的每个点分配参数 u ∈ [0, 1]
+QVector<qreal> chordLengthParameterize(const QVector<QPointF> &d, int first, int last)
+{
+    QVector<qreal> u(last - first + 1);
+    u[0] = 0.0;
+    for (int i = first + 1; i <= last; ++i) {
+        const QPointF delta = d.at(i) - d.at(i - 1);
+        u[i - first] = u[i - first - 1] + qSqrt(dot(delta, delta));
+    }
+    const qreal total = u.last();
+    for (int i = 1; i < u.size(); ++i) {
+        u[i] = total > 0.0 ? u[i] / total : qreal(i) / (u.size() - 1);
+    }
+    return u;
+}
+
+// 在给定端点切线方向的前提下，用最小二乘求两个控制点到端点的距离
+CubicSegment generateBezier(const QVector<QPointF> &d, int first, int last, const QVector<qreal> &u,
+                            const QPointF &tHat1, const QPointF &tHat2)
+{
+    const QPointF &p0 = d.at(first);
+    const QPointF &p3 = d.at(last);
+
+    qreal c00 = 0.0, c01 = 0.0, c11 = 0.0, x0 = 0.0, x1 = 0.0;
+    for (int i = 0; i < u.size(); ++i) {
+        const QPointF a0 = tHat1 * b1(u.at(i));
+        const QPointF a1 = tHat2 * b2(u.at(i));
+        c00 += dot(a0, a0);
+        c01 += dot(a0, a1);
+        c11 += dot(a1, a1);
+        const QPointF tmp = d.at(first + i) - (p0 * (b0(u.at(i)) + b1(u.at(i))) + p3 * (b2(u.at(i)) + b3(u.at(i))));
+        x0 += dot(a0, tmp);
+        x1 += dot(a1, tmp);
+    }
+
+    const qreal detC0C1 = c00 * c11 - c01 * c01;
+    const qreal detC0X = c00 * x1 - c01 * x0;
+    const qreal detXC1 = x0 * c11 - x1 * c01;
+    qreal alphaL = qFuzzyIsNull(detC0C1) ? 0.0 : detXC1 / detC0C1;
+    qreal alphaR = qFuzzyIsNull(detC0C1) ? 0.0 : detC0X / detC0C1;
+
+    // 最小二乘解不可用时（点太少或共线），退回到 Wu/Barsky 启发式：控制点取弦长的三分之一
+    const QPointF chord = p3 - p0;
+    const qreal segmentLength = qSqrt(dot(chord, chord));
+    const qreal epsilon = 1.0e-6 * segmentLength;
+    if (alphaL < epsilon || alphaR < epsilon) {
+        alphaL = alphaR = segmentLength / 3.0;
+    }
+
+    return CubicSegment{ p0, p0 + tHat1 * alphaL, p3 + tHat2 * alphaR, p3 };
+}
+
+// 用一步牛顿迭代改进每个点的参数，使曲线上的对应点更接近采样点
+QVector<qreal> reparameterize(const QVector<QPointF> &d, int first, const QVector<qreal> &u, const CubicSegment &bezier)
+{
+    QVector<qreal> result(u.size());
+    for (int i = 0; i < u.size(); ++i) {
+        const qreal t = u.at(i);
+        const QPointF diff = bezier.pointAt(t) - d.at(first + i);
+        const QPointF q1 = derivative(bezier, t);
+        const QPointF q2 = secondDerivative(bezier, t);
+        const qreal denominator = dot(q1, q1) + dot(diff, q2);
+        result[i] = qFuzzyIsNull(denominator) ? t : qBound(0.0, t - dot(diff, q1) / denominator, 1.0);
+    }
+    return result;
+}
+
+// 返回最大距离的平方，splitPoint 为误差最大的点
+qreal computeMaxError(const QVector<QPointF> &d, int first, int last, const CubicSegment &bezier,
+                      const QVector<qreal> &u, int *splitPoint)
+{
+    *splitPoint = (first + last) / 2;
+    qreal maxDistance = 0.0;
+    for (int i = first + 1; i < last; ++i) {
+        const QPointF diff = bezier.pointAt(u.at(i - first)) - d.at(i);
+        const qreal distance = dot(diff, diff);
+        if (distance >= maxDistance) {
+            maxDistance = distance;
+            *splitPoint = i;
+        }
+    }
+    return maxDistance;
+}
+
+// 拆分点处的切线，指向前一个点的方向（作为左半段的终点切线）
+QPointF centerTangent(const QVector<QPointF> &d, int center)
+{
+    QPointF tangent = normalized(d.at(center - 1) - d.at(center + 1));
+    if (dot(tangent, tangent) == 0.0) {
+        // 笔画在这里原路折返，前后两点重合：退而使用指向前一点的方向
+        tangent = normalized(d.at(center - 1) - d.at(center));
+    }
+    return tangent;
+}
+
+struct FitTask
+{
+    int first;
+    int last;
+    QPointF tHat1;
+    QPointF tHat2;
+};
+
+}
+
+QVector<CubicSegment> CurveFitter::fit(const QVector<QPoint> &points, qreal maxError)
+{
+    QVector<CubicSegment> result;
+
+    // 去掉连续重复的点，否则端点切线可能是零向量
+    QVector<QPointF> d;
+    d.reserve(points.size());
+    for (const QPoint &p : points) {
+        if (d.isEmpty() || d.last() != QPointF(p)) {
+            d.append(QPointF(p));
+        }
+    }
+    if (d.size() < 2) {
+        return result;
+    }
+
+    const qreal errorSquared = qMax<qreal>(maxError, 0.01) * qMax<qreal>(maxError, 0.01);
+    const QPointF startTangent = normalized(d.at(1) - d.at(0));
+    const QPointF endTangent = normalized(d.at(d.size() - 2) - d.last());
+
+    // 用显式栈代替原算法的递归。先压右半段再压左半段，输出顺序与递归版本相同。
+    QVector<FitTask> stack;
+    stack.append(FitTask{ 0, int(d.size()) - 1, startTangent, endTangent });
+    while (!stack.isEmpty()) {
+        const FitTask task = stack.takeLast();
+        const int count = task.last - task.first + 1;
+
+        if (count == 2) {
+            const QPointF chord = d.at(task.last) - d.at(task.first);
+            const qreal distance = qSqrt(dot(chord, chord)) / 3.0;
+            result.append(CubicSegment{ d.at(task.first), d.at(task.first) + task.tHat1 * distance,
+                                        d.at(task.last) + task.tHat2 * distance, d.at(task.last) });
+            continue;
+        }
+
+        QVector<qreal> u = chordLengthParameterize(d, task.first, task.last);
+        CubicSegment bezier = generateBezier(d, task.first, task.last, u, task.tHat1, task.tHat2);
+        int splitPoint = 0;
+        qreal maxDistance = computeMaxError(d, task.first, task.last, bezier, u, &splitPoint);
+
+        bool fitted = maxDistance < errorSquared;
+        if (!fitted && maxDistance < errorSquared * ReparameterizeErrorFactor) {
+            for (int i = 0; i < MaxReparameterizeIterations && !fitted; ++i) {
+                u = reparameterize(d, task.first, u, bezier);
+                bezier = generateBezier(d, task.first, task.last, u, task.tHat1, task.tHat2);
+                maxDistance = computeMaxError(d, task.first, task.last, bezier, u, &splitPoint);
+                fitted = maxDistance < errorSquared;
+            }
+        }
+        if (fitted) {
+            result.append(bezier);
+            continue;
+        }
+
+        // 在误差最大的点处拆成两段分别拟合
+        const QPointF tangent = centerTangent(d, splitPoint);
+        stack.append(FitTask{ splitPoint, task.last, -tangent, task.tHat2 });
+        stack.append(FitTask{ task.first, splitPoint, task.tHat1, tangent });
+    }
+    return result;
+}
+
+QVector<QPointF> CurveFitter::flatten(const QVector<CubicSegment> &segments, qreal tolerance)
+{
+    QVector<QPointF> result;
+    if (segments.isEmpty()) {
+        return result;
+    }
+    const qreal flatness = qMax<qreal>(tolerance, 0.01);
+
+    result.append(segments.first().p0);
+    for (const CubicSegment &segment : segments) {
+        // Wang 公式：均匀细分为 n 段时，折线与曲线的最大偏差不超过
+        // (3·2/8)·M / n²，其中 M 是控制点二阶差分的最大长度
+        const QPointF dd1 = segment.p0 - segment.c1 * 2.0 + segment.c2;
+        const QPointF dd2 = segment.c1 - segment.c2 * 2.0 + segment.p3;
+        const qreal m = qSqrt(qMax(dot(dd1, dd1), dot(dd2, dd2)));
+        const int steps = qBound(1, qCeil(qSqrt(0.75 * m / flatness)), 256);
+        for (int i = 1; i <= steps; ++i) {
+            result.append(segment.pointAt(qreal(i) / steps));
+        }
+    }
+    return result;
+}
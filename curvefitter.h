@@ -0,0 +1,40 @@
+#ifndef CURVEFITTER_H
+#define CURVEFITTER_H
+
+// ---------------------------------------------------------------------------
+// 描述: 三次贝塞尔曲线拟合。
+//       按 Philip J. Schneider 的 "An Algorithm for Automatically Fitting Digitized Curves"
+//       (Graphics Gems, 1990) 把鼠标采样得到的折线拟合为一串首尾相接的三次贝塞尔曲线段，
+//       每段与原始采样点的最大偏差不超过给定的误差。
+// ---------------------------------------------------------------------------
+
+#include <QPoint>
+#include <QPointF>
+#include <QVector>
+
+/// @brief 一段三次贝塞尔曲线：起点、两个控制点、终点。
+struct CubicSegment
+{
+    QPointF p0;
+    QPointF c1;
+    QPointF c2;
+    QPointF p3;
+
+    QPointF pointAt(qreal t) const;
+};
+
+namespace CurveFitter
+{
+/// @brief 把折线拟合为三次贝塞尔曲线段。
+/// 相邻段共享端点，段与段之间在连接处切线连续（除非拟合失败后在该处被迫拆分）。
+/// @param points 原始采样点。连续重复的点会被忽略。
+/// @param maxError 允许的最大偏差（像素）。
+/// @return 曲线段列表；去重后少于 2 个点时返回空列表。
+QVector<CubicSegment> fit(const QVector<QPoint> &points, qreal maxError);
+
+/// @brief 把曲线段展平为折线，用于绘制和点击测试。
+/// @param tolerance 折线与曲线之间允许的最大偏差（像素），越小越平滑。
+QVector<QPointF> flatten(const QVector<CubicSegment> &segments, qreal tolerance = 0.25);
+}
+
+#endif // CURVEFITTER_H
@@ -32,16 +32,16 @@ void DeleteMultipleShapesCommand::execute()
 {
     qDebug() << "DeleteMultipleShapesCommand: Executing all" << m_deleteCommands.size() << "sub-delete-commands.";
     // 正序执行所有子删除命令。
-    // 每个子 DeleteShapeCommand::execute() 会从 ArtboardView::shapesList 中移除图形。
+    // 每个子 DeleteShapeCommand::execute() 会从 ArtboardDocument::shapes() 中移除图形。
     // 如果子命令是按原始索引从高到低排列的，这里的正序执行是正确的。
     for (DeleteShapeCommand *cmd : m_deleteCommands) { // 使用范围 for 循环
         if (cmd) { // 安全检查
             cmd->execute();
         }
     }
-    // 注意：ArtboardView::update() 应该由每个子命令的 execute() 调用，
+    // 注意：ArtboardDocument::updateShapeArea() 应该由每个子命令的 execute() 调用，
     // 或者由最后调用此宏命令的 executeCommand() 在所有操作完成后统一调用一次。
-    // 我们当前的 DeleteShapeCommand::execute() 会调用 ArtboardView::update()。
+    // 我们当前的 DeleteShapeCommand::execute() 会调用 ArtboardDocument::updateShapeArea()。
 }
 
 /// @brief 撤销宏命令，即依次撤销其包含的所有单个 DeleteShapeCommand 的 undo() 方法。
@@ -61,3 +61,10 @@ void DeleteMultipleShapesCommand::undo()
         }
     }
 }
+
+void DeleteMultipleShapesCommand::collectShapes(QSet<AbstractShape*> *shapes) const
+{
+    for (const DeleteShapeCommand *command : m_deleteCommands) {
+        command->collectShapes(shapes);
+    }
+}
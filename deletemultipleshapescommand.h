@@ -48,6 +48,7 @@ public:
     /// 此方法会遍历内部存储的 DeleteShapeCommand 列表（通常以与执行时相反的顺序），
     /// 并依次调用每个子命令的 undo() 方法。
     void undo() override;
+    void collectShapes(QSet<AbstractShape*> *shapes) const override;
 
 private:
     QList<DeleteShapeCommand*> m_deleteCommands; ///< 存储一系列指向单个 DeleteShapeCommand 对象的指针。
@@ -0,0 +1,163 @@
+#include "documentloader.h"
+#include "abstractshape.h"
+#include "shapecodec.h"
+#include <QJsonDocument>
+#include <QMutexLocker>
+#include <QtConcurrent>
+#include <QDebug>
+
+DocumentLoader::DocumentLoader(QObject *parent)
+    : QObject(parent),
+    m_generation(0),
+    m_running(false)
+{
+}
+
+DocumentLoader::~DocumentLoader()
+{
+    cancel();
+    m_future.waitForFinished();
+    // 读取线程结束前放入队列、但还没送到主线程的批次
+    for (const Batch &batch : m_ready) {
+        for (const LoadedShape &loaded : batch.shapes) {
+            delete loaded.shape;
+        }
+    }
+}
+
+AbstractShape *DocumentLoader::decodeShape(const FpaDatabase::ShapeRow &row)
+{
+    // 版本 2 的行是二进制记录，版本 1 留下的行是 JSON 文本
+    const QJsonObject jsonObj = row.data.isEmpty() ? QJsonDocument::fromJson(row.jsonData.toUtf8()).object()
+                                                   : ShapeCodec::decode(row.data);
+    AbstractShape *shape = AbstractShape::fromJsonObject(jsonObj);
+    if (shape) {
+        shape->setId(row.id);
+    }
+    return shape;
+}
+
+void DocumentLoader::start(const QString &filePath, const QRect &area)
+{
+    cancel();
+    // 上一次载入的读取线程发现自己过期后会在当前这一批解码完成时退出
+    m_future.waitForFinished();
+    const quint64 generation = m_generation.load();
+    m_running = true;
+    m_future = QtConcurrent::run([this, generation, filePath, area]() { run(generation, filePath, area); });
+}
+
+void DocumentLoader::cancel()
+{
+    ++m_generation;
+    m_running = false;
+}
+
+void DocumentLoader::run(quint64 generation, const QString &filePath, const QRect &area)
+{
+    bool ok = false;
+    {
+        // 每个线程必须使用自己的连接
+        FpaDatabase db(QString("document_loader_%1_%2").arg(quintptr(this)).arg(generation));
+        const bool opened = db.open(filePath);
+        const int version = opened ? db.schemaVersion() : 0;
+        if (opened && !FpaDatabase::isSupportedVersion(version)) {
+            qWarning() << "Error:" << filePath << "was written by a newer version (schema" << version << ").";
+        } else if (opened) {
+            // 有文件摘要时直接取其中的图形数，不必数一遍所有行
+            const int total = area.isNull() ? db.documentInfo().shapeCount : db.shapeCountInArea(area);
+            int loaded = 0;
+            QVector<FpaDatabase::ShapeRow> rows;
+            rows.reserve(BatchSize);
+
+            // 一批在线程池中解码的同时，本线程继续读取下一批
+            QFuture<LoadedShape> pending;
+            int pendingCount = 0;
+            auto finishPending = [&]() {
+                if (pendingCount == 0) {
+                    return;
+                }
+                pending.waitForFinished();
+                loaded += pendingCount;
+                pendingCount = 0;
+                post(generation, pending.results(), loaded, total);
+            };
+            auto decodeRows = [&]() {
+                finishPending();
+                pending = QtConcurrent::mapped(rows, [](const FpaDatabase::ShapeRow &row) {
+                    return LoadedShape{ decodeShape(row), row.zOrder };
+                });
+                pendingCount = rows.size();
+                rows.clear();
+            };
+
+            auto visitor = [&](const FpaDatabase::ShapeRow &row) {
+                if (!isCurrent(generation)) {
+                    return false;
+                }
+                rows.append(row);
+                if (rows.size() >= BatchSize) {
+                    decodeRows();
+                }
+                return true;
+            };
+            ok = area.isNull() ? db.readShapes(visitor) : db.readShapesInArea(area, visitor);
+            if (!rows.isEmpty()) {
+                decodeRows();
+            }
+            finishPending();
+        }
+    }
+    QMetaObject::invokeMethod(this, [this, generation, ok]() { complete(generation, ok); }, Qt::QueuedConnection);
+}
+
+void DocumentLoader::post(quint64 generation, QVector<LoadedShape> shapes, int loaded, int total)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_ready.append(Batch{ generation, shapes, loaded, total });
+    }
+    QMetaObject::invokeMethod(this, &DocumentLoader::deliverReady, Qt::QueuedConnection);
+}
+
+void DocumentLoader::deliverReady()
+{
+    QVector<Batch> ready;
+    {
+        QMutexLocker locker(&m_mutex);
+        ready.swap(m_ready);
+    }
+    for (const Batch &batch : ready) {
+        if (!isCurrent(batch.generation) || !m_running) {
+            // 已取消的载入：丢弃并释放
+            for (const LoadedShape &loaded : batch.shapes) {
+                delete loaded.shape;
+            }
+            continue;
+        }
+        QVector<LoadedShape> shapes;
+        shapes.reserve(batch.shapes.size());
+        for (const LoadedShape &loaded : batch.shapes) {
+            if (loaded.shape) {
+                shapes.append(loaded);
+            }
+        }
+        if (!shapes.isEmpty()) {
+            emit shapesLoaded(shapes);
+        }
+        emit progress(batch.loaded, batch.total);
+    }
+}
+
+void DocumentLoader::complete(quint64 generation, bool ok)
+{
+    if (!isCurrent(generation) || !m_running) {
+        return;
+    }
+    deliverReady(); // 确保所有批次都在 finished 之前送出
+    m_running = false;
+    if (ok) {
+        qDebug() << "Canvas loaded successfully!";
+    }
+    emit finished(ok);
+}
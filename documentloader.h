@@ -0,0 +1,84 @@
+#ifndef DOCUMENTLOADER_H
+#define DOCUMENTLOADER_H
+
+// ---------------------------------------------------------------------------
+// 描述: 定义了 DocumentLoader 类，在后台线程中载入 .fpa 文件。
+//       读取线程使用自己的 SQLite 连接按 z 顺序逐行读取，每攒够一批就交给线程池并行解码，
+//       同时继续读取下一批。解码好的图形按原来的顺序分批送回主线程，
+//       画布可以一边载入一边显示，界面始终可以操作。
+// ---------------------------------------------------------------------------
+
+#include <QObject>
+#include <QFuture>
+#include <QMutex>
+#include <QRect>
+#include <QVector>
+#include <atomic>
+#include "fpadatabase.h"
+
+class AbstractShape;
+
+class DocumentLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// 每批图形的行数。越小画布出现内容越快，越大线程间交接的开销越小。
+    static const int BatchSize = 1024;
+
+    struct LoadedShape
+    {
+        AbstractShape *shape;   // 已设置好持久 ID
+        qint64 zOrder;          // 文件中的 z_order
+    };
+
+    explicit DocumentLoader(QObject *parent = nullptr);
+    /// 析构时取消正在进行的载入并等待读取线程结束，尚未送出的图形会被释放。
+    ~DocumentLoader() override;
+
+    /// @brief 开始载入 filePath。正在进行的上一次载入会先被取消。
+    /// @param area 不为空时只载入区域与它相交的图形（分页模式，需要文件有空间索引）。
+    void start(const QString &filePath, const QRect &area = QRect());
+
+    /// @brief 取消当前的载入。之后不会再发出这次载入的任何信号，尚未送出的图形会被释放。
+    void cancel();
+
+    bool isRunning() const { return m_running; }
+
+    /// @brief 把一行记录解码为图形并设置持久 ID。同步载入也使用它。
+    /// @return 记录无法解码时返回 nullptr。可以在任意线程中调用。
+    static AbstractShape *decodeShape(const FpaDatabase::ShapeRow &row);
+
+signals:
+    /// @brief 一批按 z 顺序排列的图形。接收方获得这些图形的所有权。
+    void shapesLoaded(const QVector<DocumentLoader::LoadedShape> &batch);
+    /// @param total 文件中的图形总数；读取失败时为 0。
+    void progress(int loaded, int total);
+    /// @brief 载入结束（被取消时不发出）。ok 为 false 表示无法打开或读取文件。
+    void finished(bool ok);
+
+private:
+    struct Batch
+    {
+        quint64 generation;
+        QVector<LoadedShape> shapes;
+        int loaded;
+        int total;
+    };
+
+    void run(quint64 generation, const QString &filePath, const QRect &area);    // 读取线程
+    void post(quint64 generation, QVector<LoadedShape> shapes, int loaded, int total);
+    void deliverReady();                                         // 主线程
+    void complete(quint64 generation, bool ok);                  // 主线程
+    bool isCurrent(quint64 generation) const { return m_generation.load() == generation; }
+
+    std::atomic<quint64> m_generation;  // 每次 start/cancel 加一，读取线程据此发现自己已过期
+    bool m_running;
+    QFuture<void> m_future;
+    QMutex m_mutex;                      // 保护 m_ready
+    QVector<Batch> m_ready;              // 已解码、等待主线程取走的批次
+};
+
+Q_DECLARE_METATYPE(DocumentLoader::LoadedShape)
+
+#endif // DOCUMENTLOADER_H
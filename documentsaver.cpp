@@ -0,0 +1,136 @@
+#include "documentsaver.h"
+#include "fpadatabase.h"
+#include "documentloader.h"
+#include "abstractshape.h"
+#include "backgroundpyramid.h"
+#include "shapecodec.h"
+#include <QBuffer>
+#include <QFile>
+#include <QFileInfo>
+#include <QtConcurrent>
+#include <QThread>
+#include <QDebug>
+
+namespace {
+
+bool writeBackground(FpaDatabase *db, const SaveSnapshot &snapshot, const QString &connectionName)
+{
+    if (!snapshot.backgroundImage.isNull() || snapshot.backgroundFrom.isEmpty()) {
+        return BackgroundPyramid::write(snapshot.backgroundImage, db);
+    }
+    if (QFileInfo(snapshot.backgroundFrom) == QFileInfo(snapshot.filePath)) {
+        return true; // 全量写入同一个文件时瓦片保持原样
+    }
+    if (!QFileInfo::exists(snapshot.backgroundFrom)) {
+        qWarning() << "Warning: The background image source" << snapshot.backgroundFrom << "no longer exists; saving without it.";
+        return BackgroundPyramid::write(QImage(), db);
+    }
+    FpaDatabase source(connectionName + "_background");
+    return source.open(snapshot.backgroundFrom) && BackgroundPyramid::copy(&source, db);
+}
+
+}
+
+DocumentSaver::DocumentSaver(QObject *parent)
+    : QObject(parent)
+{
+    connect(&m_watcher, &QFutureWatcher<bool>::finished, this, [this]() {
+        emit finished(m_watcher.result(), m_filePath);
+    });
+}
+
+DocumentSaver::~DocumentSaver()
+{
+    m_watcher.waitForFinished();
+}
+
+void DocumentSaver::start(const SaveSnapshot &snapshot)
+{
+    m_watcher.waitForFinished();
+    m_filePath = snapshot.filePath;
+    m_watcher.setFuture(QtConcurrent::run([snapshot]() mutable {
+        encode(&snapshot);
+        return write(snapshot, QString("document_saver_%1").arg(quintptr(QThread::currentThreadId())));
+    }));
+}
+
+void DocumentSaver::encode(SaveSnapshot *snapshot)
+{
+    QVector<SaveSnapshot::Record> records = QtConcurrent::blockingMapped<QVector<SaveSnapshot::Record>>(snapshot->pendingShapes,
+        [](const SaveSnapshot::PendingShape &pending) {
+            const QJsonObject jsonObj = pending.shape->toJsonObject();
+            return SaveSnapshot::Record{ pending.id, pending.zOrder, jsonObj["type"].toString(),
+                                         ShapeCodec::encode(jsonObj), pending.shape->getDamageRect() };
+        });
+    for (const SaveSnapshot::PendingShape &pending : snapshot->pendingShapes) {
+        delete pending.shape;
+    }
+    snapshot->pendingShapes.clear();
+    snapshot->records += records;
+}
+
+bool DocumentSaver::write(const SaveSnapshot &snapshot, const QString &connectionName)
+{
+    if (!snapshot.copyFrom.isEmpty()) {
+        // 分页模式下内存中只有一部分图形，另存为时先复制整个文件，其余部分原样保留
+        FpaDatabase source(connectionName + "_source");
+        QFile::remove(snapshot.filePath);
+        QFile::remove(snapshot.filePath + "-wal");
+        QFile::remove(snapshot.filePath + "-shm");
+        if (!source.open(snapshot.copyFrom) || !source.copyTo(snapshot.filePath)) {
+            return false;
+        }
+    }
+
+    FpaDatabase db(connectionName);
+    // prepareForWriting() 开始写事务，表结构升级和下面的写入一起提交
+    if (!db.open(snapshot.filePath) || !db.prepareForWriting()) {
+        return false;
+    }
+    auto fail = [&db]() {
+        db.rollback();
+        return false;
+    };
+
+    if (!snapshot.incremental) {
+        if (!db.deleteAllShapes()) return fail();
+    }
+    for (quint64 id : snapshot.deletedIds) {
+        if (!db.deleteShape(id)) return fail();
+    }
+    for (const QPair<quint64, qint64> &update : snapshot.zOrderUpdates) {
+        if (!db.updateZOrder(update.first, update.second)) return fail();
+    }
+    for (const SaveSnapshot::Record &record : snapshot.records) {
+        if (!db.upsertShape(record.id, record.zOrder, record.type, record.data, record.bounds)) return fail();
+    }
+    if (snapshot.writeBackground && !writeBackground(&db, snapshot, connectionName)) return fail();
+    // 旧版本文件中没有改写过的行，解码一次补上区域
+    const bool indexed = db.completeSpatialIndex([](const FpaDatabase::ShapeRow &row) {
+        AbstractShape *shape = DocumentLoader::decodeShape(row);
+        const QRect bounds = shape ? shape->getDamageRect() : QRect();
+        delete shape;
+        return bounds;
+    });
+    if (!indexed) return fail();
+    // 文件摘要在图形和背景图写完之后生成，缩略图在这里编码，不占用主线程
+    QByteArray preview;
+    if (!snapshot.preview.isNull()) {
+        QBuffer buffer(&preview);
+        buffer.open(QIODevice::WriteOnly);
+        snapshot.preview.save(&buffer, "PNG");
+    }
+    if (!db.writeDocumentInfo(preview)) return fail();
+    // 与图形在同一个事务中写入，文件内容和它对应的日志检查点总是一致
+    if (!db.setMetaValue("journal_token", qint64(snapshot.journalToken))
+        || !db.setMetaValue("journal_seq", qint64(snapshot.journalSeq))) {
+        return fail();
+    }
+    if (!db.commit()) {
+        return false;
+    }
+
+    qDebug() << "Saved" << snapshot.records.size() << "shapes," << snapshot.deletedIds.size() << "deleted,"
+             << snapshot.zOrderUpdates.size() << "z-order changes" << (snapshot.incremental ? "(incremental)." : "(full).");
+    return true;
+}
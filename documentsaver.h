@@ -0,0 +1,88 @@
+#ifndef DOCUMENTSAVER_H
+#define DOCUMENTSAVER_H
+
+// ---------------------------------------------------------------------------
+// 描述: 定义了保存快照 SaveSnapshot 和后台保存器 DocumentSaver。
+//       保存分两步：先在主线程中生成快照，其中需要整行写入的图形是它们的副本（AbstractShape::clone()，
+//       点集等数据隐式共享，复制只是增加引用计数），不引用文档中的任何图形；
+//       再由 DocumentSaver 在后台线程中把副本编码为记录 (encode)，用自己的 SQLite 连接写入文件。
+//       快照生成之后用户可以继续编辑，之后的修改不会影响正在写入的内容。
+// ---------------------------------------------------------------------------
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QImage>
+#include <QPair>
+#include <QRect>
+#include <QString>
+#include <QVector>
+
+class AbstractShape;
+
+/// @brief 一次保存要写入文件的全部内容。
+struct SaveSnapshot
+{
+    struct Record
+    {
+        quint64 id;
+        qint64 zOrder;
+        QString type;
+        QByteArray data;    // ShapeCodec 编码的图形记录
+        QRect bounds;       // 图形影响的区域，写入 shapes_rtree
+    };
+
+    /// 还没有编码的图形
+    struct PendingShape
+    {
+        quint64 id;
+        qint64 zOrder;
+        AbstractShape *shape;   // 主线程中复制的图形，归快照所有，由 DocumentSaver::encode 编码后释放
+    };
+
+    QString filePath;
+    QString copyFrom;                               // 不为空时先把这个文件复制为 filePath，再在副本上增量写入
+    bool incremental = false;                       // false 时先清空 shapes 表
+    QVector<quint64> deletedIds;                    // 要删除的行
+    QVector<QPair<quint64, qint64>> zOrderUpdates;  // 只改写 z_order 的行
+    QVector<PendingShape> pendingShapes;            // 整行写入的图形，encode 之后转为 records
+    QVector<Record> records;                        // 整行写入的图形的编码
+    bool writeBackground = false;                   // 是否改写背景图
+    QImage backgroundImage;                         // 要写入的背景图
+    QString backgroundFrom;                         // backgroundImage 为空时从这个文件复制背景图；两者都为空表示删除背景图
+    QImage preview;                                 // 写入文件摘要的缩略图
+    quint64 journalToken = 0;                       // 保存成为命令日志的新检查点（见 CommandJournal）
+    quint64 journalSeq = 0;                         // 文件内容已包含的最后一条日志记录
+};
+
+class DocumentSaver : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DocumentSaver(QObject *parent = nullptr);
+    /// 析构时等待正在进行的写入完成，退出程序不会留下写了一半的事务。
+    ~DocumentSaver() override;
+
+    /// @brief 在后台线程中编码并写入快照，快照中的图形副本由这次写入释放。
+    /// 上一次写入尚未完成时先等待它完成。
+    void start(const SaveSnapshot &snapshot);
+    bool isRunning() const { return m_watcher.isRunning(); }
+    void waitForFinished() { m_watcher.waitForFinished(); }
+    /// @brief 最近一次写入的结果。只在写入完成后有意义。
+    bool result() const { return m_watcher.future().isValid() && m_watcher.result(); }
+
+    /// @brief 把 pendingShapes 中的图形副本并行编码为 records，并释放这些副本。
+    static void encode(SaveSnapshot *snapshot);
+    /// @brief 在当前线程中把快照写入文件，整个写入在一个事务中完成。调用前先 encode。
+    /// @param connectionName 本次写入使用的 Qt SQL 连接名。
+    static bool write(const SaveSnapshot &snapshot, const QString &connectionName);
+
+signals:
+    void finished(bool ok, const QString &filePath);
+
+private:
+    QFutureWatcher<bool> m_watcher;
+    QString m_filePath;
+};
+
+#endif // DOCUMENTSAVER_H
@@ -4,8 +4,7 @@
 #include <QPainter>
 #include <QPen>
 #include <QBrush>
-#include <QPainterPath>
-#include <QPainterPathStroker>
+#include "geometrykernels.h"
 #include <QJsonArray>
 #include <QJsonObject>
 
@@ -16,6 +15,11 @@ EllipseShape::EllipseShape(const QRectF &rect, const QColor &borderColor, int pe
 {
 }
 
+AbstractShape *EllipseShape::clone() const
+{
+    return new EllipseShape(*this);
+}
+
 void EllipseShape::draw(QPainter *painter)
 {
     if (!painter || m_rect.isNull()) return;
@@ -63,53 +67,35 @@ QRect EllipseShape::getBoundingRect() const // "TheShape" 指代 RectangleShape,
     return transform.mapRect(m_rect.normalized()).toAlignedRect();
 }
 
-bool EllipseShape::containsPoint(const QPoint &point) const // "TheShape" 指代 RectangleShape 等
+bool EllipseShape::containsPoint(const QPoint &point) const
 {
-    // 如果没有旋转，用最快的方式判断
-    if (m_rotationAngle == 0.0) {
-        // 这里是你原来的 containsPoint 逻辑
-        if (isFilled()) { return m_rect.contains(point); }
-        else { /* ... stroker logic ... */ }
-    }
+    // 1. 用缓存的逆矩阵把点击位置“反向旋转”回未旋转的图形坐标系（与 draw() 中的变换一致）
+    QPointF unrotatedPoint = inverseRotation().map(QPointF(point));
 
-    // 1. 创建与 draw() 方法中完全一样的变换矩阵
-    QTransform transform;
-    transform.translate(m_rect.center().x(), m_rect.center().y());
-    transform.rotate(m_rotationAngle);
-    transform.translate(-m_rect.center().x(), -m_rect.center().y());
-
-    // 2. 获取该变换的“逆矩阵”
-    QTransform inverseTransform = transform.inverted();
-
-    // 3. 将用户点击的点，通过逆矩阵，“反向旋转”回去
-    QPointF unrotatedPoint = inverseTransform.map(QPointF(point));
-
-    // 4. 判断这个“反向旋转”后的点，是否在“未旋转”的原始图形内部
-    //    这里的逻辑就和我们之前写的 containsPoint 完全一样了
+    // 2. 在未旋转的坐标系中判断：填充的椭圆在整个外接矩形内命中（与原来的行为一致，
+    //    点击椭圆四角的空白处也能选中它），未填充的只在轮廓附近命中
     if (isFilled()) {
         return m_rect.contains(unrotatedPoint);
-    } else {
-        QPainterPath path;
-        path.addEllipse(m_rect);
-        QPainterPathStroker stroker;
-        stroker.setWidth(this->getPenWidth() + 4.0);
-        return stroker.createStroke(path).contains(unrotatedPoint);
     }
+    return GeometryKernels::ellipseOutlineNear(m_rect, unrotatedPoint, hitRadius());
 }
 
 void EllipseShape::moveBy(const QPoint &offset)
 {
     m_rect.translate(offset);
+    invalidateCaches();
 }
 
 void EllipseShape::updateShape(const QPoint &point)
 {
     m_rect.setBottomRight(point);
+    invalidateCaches();
 }
 
 void EllipseShape::setGeometry(const QRect &rect)
 {
     m_rect = rect;
+    invalidateCaches();
 }
 
 QJsonObject EllipseShape::toJsonObject() const
@@ -8,7 +8,7 @@
 #include <QPainter>             // draw 方法需要
 #include <QPen>                 // 用于设置画笔
 #include <QBrush>               // draw 方法中明确设置为 NoBrush (虽然橡皮擦是用"笔"画的)
-#include <QPainterPathStroker>  // getBoundingRect 和 containsPoint 方法需要
+#include "geometrykernels.h"     // containsPoint 方法需要
 #include <QDebug>               // 用于调试输出
 #include <QJsonArray>
 #include <QJsonObject>
@@ -27,43 +27,49 @@ EraserPathShape::EraserPathShape(const QVector<QPoint> &points, int eraserWidth,
     //    - false, Qt::transparent: 橡皮擦路径本身不进行额外填充。
     m_points(points) // 2. 初始化存储点的 QVector 成员
 {
-    // 3. 根据初始的点集构建内部的 QPainterPath 对象。
-    buildPath();
+    // 3. 根据初始的点集计算包围盒。
+    updateBounds();
     // qDebug() << "EraserPathShape created with" << m_points.size() << "points, width:" << eraserWidth << "color:" << eraserColor.name();
 }
 
-/// @brief 私有辅助函数，根据当前的 m_points 点集更新（重建）内部的 m_painterPath 对象。
+AbstractShape *EraserPathShape::clone() const
+{
+    return new EraserPathShape(*this);
+}
+
+/// @brief 私有辅助函数，根据当前的 m_points 点集重新计算包围盒 m_pointBounds。
 /// 对于橡皮擦，即使只有一个点（鼠标单击），也应该能擦除一个小区域（通过画笔的 RoundCap 实现）。
-void EraserPathShape::buildPath()
+void EraserPathShape::updateBounds()
 {
-    m_painterPath = QPainterPath(); // 清空现有路径
+    m_pointBounds = QRectF();
+    invalidateCaches();
 
-    if (m_points.isEmpty()) { // 如果没有点，则路径为空
+    if (m_points.isEmpty()) { // 如果没有点，包围盒为空
         return;
     }
 
-    m_painterPath.moveTo(m_points.first()); // 将路径的当前点移动到点集的第一个点
-    if (m_points.size() == 1) {
-        // 如果只有一个点，画一条长度为0的线到自身，以便 QPainter 使用 RoundCap 时能画出一个圆点。
-        m_painterPath.lineTo(m_points.first());
-    } else { // 如果有多个点，则连接所有点
-        for (int i = 1; i < m_points.size(); ++i) {
-            m_painterPath.lineTo(m_points.at(i));
-        }
+    int left = m_points.first().x(), right = left;
+    int top = m_points.first().y(), bottom = top;
+    for (const QPoint &p : m_points) {
+        left = qMin(left, p.x());
+        right = qMax(right, p.x());
+        top = qMin(top, p.y());
+        bottom = qMax(bottom, p.y());
     }
+    m_pointBounds = QRectF(QPointF(left, top), QPointF(right, bottom));
 }
 
 // ----------------- eraserpathshape.cpp (请完整替换此函数) -----------------
 void EraserPathShape::draw(QPainter *painter)
 {
-    if (!painter || m_painterPath.isEmpty()) {
+    if (!painter || m_points.isEmpty()) {
         return;
     }
 
     painter->save(); // 保存状态
 
-    // 同样以路径包围盒的中心为旋转中心
-    QPointF center = m_painterPath.boundingRect().center();
+    // 以点集包围盒的中心为旋转中心
+    QPointF center = m_pointBounds.center();
     painter->translate(center);
     painter->rotate(m_rotationAngle);
     painter->translate(-center);
@@ -78,46 +84,41 @@ void EraserPathShape::draw(QPainter *painter)
 
     painter->setBrush(Qt::NoBrush);
 
-    // 在旋转后的坐标系上绘制路径
-    painter->drawPath(m_painterPath);
+    // 在旋转后的坐标系上直接绘制折线。
+    // draw() 可能在场景缓存的多个工作线程中同时调用，这里只读取 m_points。
+    // 只有一个点时画一条长度为 0 的线，配合 RoundCap 画出圆点。
+    if (m_points.size() == 1) {
+        const QPoint dot[2] = { m_points.first(), m_points.first() };
+        painter->drawPolyline(dot, 2);
+    } else {
+        painter->drawPolyline(m_points.constData(), m_points.size());
+    }
 
     painter->restore(); // 恢复状态
 }
 
 /// @brief EraserPathShape 类的 getBoundingRect 方法实现。
 /// 返回包含整个橡皮擦路径（已考虑其宽度）的最小外接矩形。
+/// 使用圆形线帽和圆形连接时，描边不会超出点集包围盒向外扩展半个线宽的范围，
+/// 所以直接由缓存的点集包围盒算出，与路径长度无关。
 QRect EraserPathShape::getBoundingRect() const
 {
-    if (m_painterPath.isEmpty()) {
+    if (m_points.isEmpty()) {
         return QRect(); // 空路径返回空矩形
     }
-    // 为了获得准确的包围盒（尤其对于有宽度的路径），使用 QPainterPathStroker
-    QPainterPathStroker stroker;
-    stroker.setWidth(this->shapePenWidth); // 使用橡皮擦的实际宽度
-    stroker.setCapStyle(Qt::RoundCap);   // 与绘制时的线帽样式一致
-    stroker.setJoinStyle(Qt::RoundJoin); // 与绘制时的连接样式一致
-    // createStroke() 返回描边路径，boundingRect() 获取其包围盒 (QRectF)
-    return stroker.createStroke(m_painterPath).boundingRect().toAlignedRect();
+    const qreal halfWidth = this->shapePenWidth / 2.0;
+    return m_pointBounds.adjusted(-halfWidth, -halfWidth, halfWidth, halfWidth).toAlignedRect();
 }
 
+
 /// @brief EraserPathShape 类的 containsPoint 方法实现。
 /// 判断给定点是否在橡皮擦路径的有效点击区域内（考虑到橡皮擦宽度和容差）。
 /// 这个方法主要用于当橡皮擦痕迹本身也可以被其他工具（如笔画橡皮擦）操作时的判断。
 bool EraserPathShape::containsPoint(const QPoint &point) const
 {
-    if (m_painterPath.isEmpty()) {
-        return false;
-    }
-
-    QPainterPathStroker stroker;
-    // 设置描边的宽度，基于橡皮擦的实际宽度，并增加一些容差方便点击
-    stroker.setWidth(this->shapePenWidth + 4.0); // 例如，增加4像素的点击容差
-    stroker.setCapStyle(Qt::RoundCap);
-    stroker.setJoinStyle(Qt::RoundJoin);
-
-    QPainterPath strokedPath = stroker.createStroke(m_painterPath); // 生成描边路径
-
-    return strokedPath.contains(point); // 判断点是否在描边路径内
+    // 橡皮擦使用圆形线帽和圆形连接，到折线的距离不超过 线宽/2 + 容差 即为命中，
+    // 与按“线宽 + 4”描边后判断包含的结果完全一致。
+    return GeometryKernels::polylineNear(m_points.constData(), m_points.size(), QPointF(point), hitRadius());
 }
 
 /// @brief EraserPathShape 类的 moveBy 方法实现。
@@ -128,7 +129,7 @@ void EraserPathShape::moveBy(const QPoint &offset)
     for (QPoint &p : m_points) {
         p += offset;
     }
-    buildPath(); // 点集变化后，重新构建 QPainterPath
+    updateBounds(); // 点集变化后，重新计算包围盒
 }
 
 /// @brief EraserPathShape 类的 updateShape 方法实现。
@@ -139,21 +140,31 @@ void EraserPathShape::updateShape(const QPoint &point)
 }
 
 /// @brief 向此橡皮擦路径的点集 (m_points) 末尾添加一个新点。
-/// 添加点后，会自动调用 buildPath() 来更新内部的 QPainterPath。
+/// 与 FreehandPathShape::addPoint 相同，只扩展已有的包围盒，均摊 O(1)。
 /// @param point 要添加的 QPoint。
 void EraserPathShape::addPoint(const QPoint &point)
 {
     m_points.append(point);
-    buildPath();
+
+    if (m_points.size() == 1) {
+        updateBounds();
+        return;
+    }
+
+    m_pointBounds.setLeft(qMin(m_pointBounds.left(), qreal(point.x())));
+    m_pointBounds.setRight(qMax(m_pointBounds.right(), qreal(point.x())));
+    m_pointBounds.setTop(qMin(m_pointBounds.top(), qreal(point.y())));
+    m_pointBounds.setBottom(qMax(m_pointBounds.bottom(), qreal(point.y())));
+    invalidateCaches();
 }
 
 /// @brief 设置构成此橡皮擦路径的完整点集。
-/// 这会替换掉现有的所有点。调用此方法后，会自动调用 buildPath()。
+/// 这会替换掉现有的所有点。调用此方法后，会自动调用 updateBounds()。
 /// @param points 包含所有新点的 QVector<QPoint>。
 void EraserPathShape::setPoints(const QVector<QPoint> &points)
 {
     m_points = points;
-    buildPath();
+    updateBounds();
 }
 
 QJsonObject EraserPathShape::toJsonObject() const
@@ -186,7 +197,7 @@ QJsonObject EraserPathShape::toJsonObject() const
 QPointF EraserPathShape::getCenter() const
 {
     // 橡皮擦路径的几何中心，同样是其外包围盒的中心
-    return m_painterPath.boundingRect().center();
+    return m_pointBounds.center();
 }
 
 QRectF EraserPathShape::getCoreGeometry() const
@@ -3,7 +3,6 @@
 #define ERASERPATHSHAPE_H
 
 #include "abstractshape.h"
-#include <QPainterPath>
 #include <QVector>
 #include <QPoint>
 #include <QJsonObject>
@@ -13,6 +12,8 @@ class EraserPathShape : public AbstractShape
 public:
     EraserPathShape(const QVector<QPoint> &points, int eraserWidth, const QColor &eraserColor);
 
+    AbstractShape *clone() const override;
+
     void draw(QPainter *painter) override;
     QRect getBoundingRect() const override;
     QRectF getCoreGeometry() const override;
@@ -29,9 +30,9 @@ public:
     const QVector<QPoint> &getPoints() const { return m_points; }
 
 private:
-    void buildPath();
+    void updateBounds();
     QVector<QPoint> m_points;
-    QPainterPath m_painterPath;
+    QRectF m_pointBounds; // 所有点的包围盒，也是旋转中心的来源
 };
 
 #endif // ERASERPATHSHAPE_H
@@ -0,0 +1,20 @@
+# ---------------------------------------------------------------------------
+# 链接 fishplatecore 静态库（见 core/core.pro）。
+# 图形界面程序、命令行工具和基准测试都包含这个文件；顶层工程保证 core 先于它们构建。
+# ---------------------------------------------------------------------------
+
+QT += core gui sql concurrent
+
+CONFIG += c++17
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+FISHPLATECORE_DIR = $$shadowed($$PWD)/core
+win32:CONFIG(release, debug|release): FISHPLATECORE_DIR = $$FISHPLATECORE_DIR/release
+else:win32:CONFIG(debug, debug|release): FISHPLATECORE_DIR = $$FISHPLATECORE_DIR/debug
+
+LIBS += -L$$FISHPLATECORE_DIR -lfishplatecore
+
+win32-msvc*: PRE_TARGETDEPS += $$FISHPLATECORE_DIR/fishplatecore.lib
+else: PRE_TARGETDEPS += $$FISHPLATECORE_DIR/libfishplatecore.a
@@ -0,0 +1,765 @@
+#include "fpadatabase.h"
+#include <QSqlError>
+#include <QSqlRecord>
+#include <QVariant>
+#include <QVector>
+#include <QPair>
+#include <QCryptographicHash>
+#include <QThread>
+#include <QtEndian>
+#include <QDebug>
+
+FpaDatabase::FpaDatabase(const QString &connectionName)
+    : m_connectionName(connectionName),
+    m_writeBounds(false),
+    m_upgradeVersion(false),
+    m_shapesHashKnown(false),
+    m_backgroundHashKnown(false),
+    m_shapesCleared(false),
+    m_tilesCleared(false),
+    m_shapesHash(0),
+    m_backgroundHash(0)
+{
+}
+
+FpaDatabase::~FpaDatabase()
+{
+    close();
+}
+
+bool FpaDatabase::open(const QString &filePath)
+{
+    close();
+    m_db = QSqlDatabase::addDatabase("QSQLITE", m_connectionName);
+    m_db.setDatabaseName(filePath);
+    if (!m_db.open()) {
+        qWarning() << "Error: Failed to open database." << m_db.lastError();
+        close();
+        return false;
+    }
+    return true;
+}
+
+void FpaDatabase::close()
+{
+    if (!m_db.isValid()) {
+        return;
+    }
+    // 所有 QSqlQuery 和 QSqlDatabase 句柄都必须在 removeDatabase 之前释放
+    m_upsertQuery = QSqlQuery();
+    m_updateZOrderQuery = QSqlQuery();
+    m_deleteQuery = QSqlQuery();
+    m_upsertBoundsQuery = QSqlQuery();
+    m_deleteBoundsQuery = QSqlQuery();
+    m_storedRowQuery = QSqlQuery();
+    m_shapesHashKnown = false;
+    m_backgroundHashKnown = false;
+    m_db.close();
+    m_db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(m_connectionName);
+}
+
+// WAL 模式下写事务只追加日志，不需要先把原页复制到回滚日志；
+// synchronous=NORMAL 在 WAL 模式下只在检查点时 fsync，断电最多丢失最后一次提交，
+// 但数据库不会损坏。
+bool FpaDatabase::prepareForWriting()
+{
+    if (!isSupportedVersion(schemaVersion())) {
+        qWarning() << "Error: Refusing to write a file created by a newer version (schema" << schemaVersion() << ").";
+        return false;
+    }
+    // 日志模式不能在事务中修改，先于事务设置
+    QSqlQuery query(m_db);
+    query.exec("PRAGMA journal_mode=WAL");
+    query.exec("PRAGMA synchronous=NORMAL");
+
+    // 表结构升级与随后写入的内容在同一个事务中：保存失败或程序中途退出时，
+    // 文件保持原来的版本和内容，不会出现表结构已经升级、数据还是旧的一半状态
+    if (!beginTransaction()) {
+        return false;
+    }
+    if (!upgradeSchema() || !prepareStatements()) {
+        m_db.rollback();
+        return false;
+    }
+    return true;
+}
+
+bool FpaDatabase::upgradeSchema()
+{
+    QSqlQuery query(m_db);
+    if (!query.exec("CREATE TABLE IF NOT EXISTS shapes (id INTEGER PRIMARY KEY, type TEXT, json_data TEXT, z_order INTEGER, data BLOB)")) {
+        warn("Failed to create shapes table.", query);
+        return false;
+    }
+    if (!hasColumn("shapes", "z_order")) {
+        // 旧版本文件：按原来的 id 顺序（也就是原来的绘制顺序）补上 z_order
+        if (!query.exec("ALTER TABLE shapes ADD COLUMN z_order INTEGER")
+            || !query.exec(QString("UPDATE shapes SET z_order = id * %1").arg(ZOrderGap))) {
+            warn("Failed to upgrade shapes table.", query);
+            return false;
+        }
+    }
+    if (!query.exec("CREATE INDEX IF NOT EXISTS shapes_z_order ON shapes (z_order)")) {
+        warn("Failed to create z_order index.", query);
+        return false;
+    }
+    if (!hasColumn("shapes", "data") && !query.exec("ALTER TABLE shapes ADD COLUMN data BLOB")) {
+        warn("Failed to upgrade shapes table.", query);
+        return false;
+    }
+    if (!query.exec("CREATE TABLE IF NOT EXISTS meta (key TEXT PRIMARY KEY, value)")) {
+        warn("Failed to create meta table.", query);
+        return false;
+    }
+    if (!query.exec("CREATE TABLE IF NOT EXISTS background_tiles (level INTEGER, tile_x INTEGER, tile_y INTEGER, data BLOB, "
+                    "PRIMARY KEY (level, tile_x, tile_y)) WITHOUT ROWID")) {
+        warn("Failed to create background_tiles table.", query);
+        return false;
+    }
+    // R*Tree 模块是 SQLite 的编译选项。没有它时文件仍然可以保存，只是不能按区域载入。
+    m_writeBounds = query.exec("CREATE VIRTUAL TABLE IF NOT EXISTS shapes_rtree USING rtree(id, min_x, max_x, min_y, max_y)");
+    if (!m_writeBounds) {
+        warn("R*Tree is not available; the file will not support paged loading.", query);
+    }
+    // 新的版本号在 commit() 中最后写入
+    m_upgradeVersion = schemaVersion() < SchemaVersion;
+    return true;
+}
+
+bool FpaDatabase::prepareStatements()
+{
+    m_upsertQuery = QSqlQuery(m_db);
+    m_updateZOrderQuery = QSqlQuery(m_db);
+    m_deleteQuery = QSqlQuery(m_db);
+    m_storedRowQuery = QSqlQuery(m_db);
+    if (!m_upsertQuery.prepare("INSERT INTO shapes (id, z_order, type, data, json_data) VALUES (?, ?, ?, ?, NULL) "
+                               "ON CONFLICT (id) DO UPDATE SET z_order = excluded.z_order, "
+                               "type = excluded.type, data = excluded.data, json_data = NULL")
+        || !m_updateZOrderQuery.prepare("UPDATE shapes SET z_order = ? WHERE id = ?")
+        || !m_deleteQuery.prepare("DELETE FROM shapes WHERE id = ?")
+        || !m_storedRowQuery.prepare("SELECT z_order, type, data, json_data FROM shapes WHERE id = ?")) {
+        qWarning() << "Error: Failed to prepare statements." << m_db.lastError();
+        return false;
+    }
+    if (m_writeBounds) {
+        m_upsertBoundsQuery = QSqlQuery(m_db);
+        m_deleteBoundsQuery = QSqlQuery(m_db);
+        if (!m_upsertBoundsQuery.prepare("INSERT OR REPLACE INTO shapes_rtree (id, min_x, max_x, min_y, max_y) VALUES (?, ?, ?, ?, ?)")
+            || !m_deleteBoundsQuery.prepare("DELETE FROM shapes_rtree WHERE id = ?")) {
+            qWarning() << "Error: Failed to prepare statements." << m_db.lastError();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FpaDatabase::beginTransaction()
+{
+    if (!m_db.transaction()) {
+        qWarning() << "Error: Failed to begin transaction." << m_db.lastError();
+        return false;
+    }
+    m_shapesCleared = false;
+    m_tilesCleared = false;
+    return true;
+}
+
+bool FpaDatabase::commit()
+{
+    // 内容摘要与内容在同一个事务中提交
+    if (!ensureContentHash()) {
+        rollback();
+        return false;
+    }
+    const QString contentHash = QString("%1").arg(m_shapesHash + m_backgroundHash, 16, 16, QChar('0'));
+    if (!setMetaValue("shapes_hash", qint64(m_shapesHash)) || !setMetaValue("background_hash", qint64(m_backgroundHash))
+        || !setMetaValue("content_hash", contentHash)) {
+        rollback();
+        return false;
+    }
+    // 版本号最后写入：只有表结构和数据都已写好，文件才标记为新版本
+    if (m_upgradeVersion) {
+        QSqlQuery query(m_db);
+        if (!query.exec(QString("PRAGMA user_version = %1").arg(SchemaVersion))) {
+            warn("Failed to set schema version.", query);
+            rollback();
+            return false;
+        }
+    }
+    if (!m_db.commit()) {
+        qWarning() << "Error: Failed to commit transaction." << m_db.lastError();
+        m_db.rollback();
+        return false;
+    }
+    return true;
+}
+
+void FpaDatabase::rollback()
+{
+    m_db.rollback();
+    // 摘要中已经计入了撤销的写入，下次需要时重新读取
+    m_shapesHashKnown = false;
+    m_backgroundHashKnown = false;
+    m_shapesCleared = false;
+    m_tilesCleared = false;
+}
+
+bool FpaDatabase::deleteAllShapes()
+{
+    QSqlQuery query(m_db);
+    if (!query.exec("DELETE FROM shapes") || (m_writeBounds && !query.exec("DELETE FROM shapes_rtree"))) {
+        warn("Failed to clear shapes table.", query);
+        return false;
+    }
+    m_shapesHash = 0;
+    m_shapesHashKnown = true;
+    m_shapesCleared = true;
+    return true;
+}
+
+bool FpaDatabase::upsertShape(quint64 id, qint64 zOrder, const QString &type, const QByteArray &data, const QRect &bounds)
+{
+    // 完整保存时表已清空，每个 id 只写一次，不需要查找旧行
+    if (!m_shapesCleared) {
+        if (!ensureContentHash()) {
+            return false;
+        }
+        qint64 oldZOrder = 0;
+        QString oldType;
+        QByteArray oldPayload;
+        if (storedRow(id, &oldZOrder, &oldType, &oldPayload)) {
+            m_shapesHash -= rowHash(id, oldZOrder, oldType, oldPayload);
+        }
+    }
+    m_shapesHash += rowHash(id, zOrder, type, data);
+    m_upsertQuery.bindValue(0, id);
+    m_upsertQuery.bindValue(1, zOrder);
+    m_upsertQuery.bindValue(2, type);
+    m_upsertQuery.bindValue(3, data);
+    if (!m_upsertQuery.exec()) {
+        warn("Failed to write shape.", m_upsertQuery);
+        return false;
+    }
+    return setShapeBounds(id, bounds);
+}
+
+bool FpaDatabase::setShapeBounds(quint64 id, const QRect &bounds)
+{
+    if (!m_writeBounds) {
+        return true;
+    }
+    m_upsertBoundsQuery.bindValue(0, id);
+    m_upsertBoundsQuery.bindValue(1, bounds.left());
+    m_upsertBoundsQuery.bindValue(2, bounds.right());
+    m_upsertBoundsQuery.bindValue(3, bounds.top());
+    m_upsertBoundsQuery.bindValue(4, bounds.bottom());
+    if (!m_upsertBoundsQuery.exec()) {
+        warn("Failed to write shape bounds.", m_upsertBoundsQuery);
+        return false;
+    }
+    return true;
+}
+
+bool FpaDatabase::updateZOrder(quint64 id, qint64 zOrder)
+{
+    if (!ensureContentHash()) {
+        return false;
+    }
+    qint64 oldZOrder = 0;
+    QString type;
+    QByteArray payload;
+    if (storedRow(id, &oldZOrder, &type, &payload)) {
+        m_shapesHash += rowHash(id, zOrder, type, payload) - rowHash(id, oldZOrder, type, payload);
+    }
+    m_updateZOrderQuery.bindValue(0, zOrder);
+    m_updateZOrderQuery.bindValue(1, id);
+    if (!m_updateZOrderQuery.exec()) {
+        warn("Failed to update z-order.", m_updateZOrderQuery);
+        return false;
+    }
+    return true;
+}
+
+bool FpaDatabase::deleteShape(quint64 id)
+{
+    if (!ensureContentHash()) {
+        return false;
+    }
+    qint64 zOrder = 0;
+    QString type;
+    QByteArray payload;
+    if (storedRow(id, &zOrder, &type, &payload)) {
+        m_shapesHash -= rowHash(id, zOrder, type, payload);
+    }
+    m_deleteQuery.bindValue(0, id);
+    if (!m_deleteQuery.exec()) {
+        warn("Failed to delete shape.", m_deleteQuery);
+        return false;
+    }
+    if (m_writeBounds) {
+        m_deleteBoundsQuery.bindValue(0, id);
+        if (!m_deleteBoundsQuery.exec()) {
+            warn("Failed to delete shape bounds.", m_deleteBoundsQuery);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FpaDatabase::setMetaValue(const QString &key, const QVariant &value)
+{
+    QSqlQuery query(m_db);
+    query.prepare("INSERT INTO meta (key, value) VALUES (?, ?) ON CONFLICT (key) DO UPDATE SET value = excluded.value");
+    query.bindValue(0, key);
+    query.bindValue(1, value);
+    if (!query.exec()) {
+        warn("Failed to write meta value.", query);
+        return false;
+    }
+    return true;
+}
+
+QVariant FpaDatabase::metaValue(const QString &key)
+{
+    if (!m_db.tables().contains("meta")) {
+        return QVariant();
+    }
+    QSqlQuery query(m_db);
+    query.prepare("SELECT value FROM meta WHERE key = ?");
+    query.bindValue(0, key);
+    if (!query.exec() || !query.next()) {
+        return QVariant();
+    }
+    return query.value(0);
+}
+
+bool FpaDatabase::removeMetaValue(const QString &key)
+{
+    QSqlQuery query(m_db);
+    query.prepare("DELETE FROM meta WHERE key = ?");
+    query.bindValue(0, key);
+    if (!query.exec()) {
+        warn("Failed to remove meta value.", query);
+        return false;
+    }
+    return true;
+}
+
+quint64 FpaDatabase::maxShapeId()
+{
+    QSqlQuery query(m_db);
+    if (!query.exec("SELECT MAX(id) FROM shapes") || !query.next()) {
+        return 0;
+    }
+    return query.value(0).toULongLong();
+}
+
+qint64 FpaDatabase::maxZOrder()
+{
+    QSqlQuery query(m_db);
+    if (!hasColumn("shapes", "z_order") || !query.exec("SELECT MAX(z_order) FROM shapes") || !query.next()) {
+        return 0;
+    }
+    return query.value(0).toLongLong();
+}
+
+// 每次写入都会补全索引并在 meta 中记下，打开文件时不必逐行检查
+bool FpaDatabase::hasSpatialIndex()
+{
+    return metaValue("spatial_index").toBool() && m_db.tables().contains("shapes_rtree");
+}
+
+bool FpaDatabase::completeSpatialIndex(const std::function<QRect(const ShapeRow &)> &boundsOf)
+{
+    if (!m_writeBounds || hasSpatialIndex()) {
+        return true;
+    }
+    QVector<QPair<quint64, QRect>> missing;
+    {
+        QSqlQuery query(m_db);
+        query.setForwardOnly(true);
+        if (!query.exec("SELECT id, z_order, data, json_data FROM shapes WHERE id NOT IN (SELECT id FROM shapes_rtree)")) {
+            warn("Failed to query shapes.", query);
+            return false;
+        }
+        readRows(query, [&missing, &boundsOf](const ShapeRow &row) {
+            const QRect bounds = boundsOf(row);
+            if (!bounds.isNull()) {
+                missing.append(qMakePair(row.id, bounds));
+            }
+            return true;
+        });
+    }
+    for (const QPair<quint64, QRect> &entry : missing) {
+        if (!setShapeBounds(entry.first, entry.second)) {
+            return false;
+        }
+    }
+    return setMetaValue("spatial_index", 1);
+}
+
+bool FpaDatabase::copyTo(const QString &filePath)
+{
+    QSqlQuery query(m_db);
+    query.prepare("VACUUM INTO ?");
+    query.bindValue(0, filePath);
+    if (!query.exec()) {
+        warn("Failed to copy document.", query);
+        return false;
+    }
+    return true;
+}
+
+int FpaDatabase::shapeCount()
+{
+    QSqlQuery query(m_db);
+    if (!query.exec("SELECT COUNT(*) FROM shapes") || !query.next()) {
+        return 0;
+    }
+    return query.value(0).toInt();
+}
+
+int FpaDatabase::schemaVersion()
+{
+    QSqlQuery query(m_db);
+    if (!query.exec("PRAGMA user_version") || !query.next()) {
+        return 0;
+    }
+    return query.value(0).toInt();
+}
+
+FpaDatabase::DocumentInfo FpaDatabase::documentInfo()
+{
+    DocumentInfo info;
+    info.schemaVersion = schemaVersion();
+    const QVariant count = metaValue("shape_count");
+    info.shapeCount = count.isValid() ? count.toInt() : shapeCount();
+    const QVariant width = metaValue("bounds_width");
+    if (width.isValid()) {
+        info.bounds = QRect(metaValue("bounds_x").toInt(), metaValue("bounds_y").toInt(),
+                            width.toInt(), metaValue("bounds_height").toInt());
+    }
+    info.preview = metaValue("preview").toByteArray();
+    info.contentHash = metaValue("content_hash").toString();
+    return info;
+}
+
+bool FpaDatabase::readDocumentInfo(const QString &filePath, DocumentInfo *info)
+{
+    FpaDatabase db(QString("document_info_%1").arg(quintptr(QThread::currentThreadId())));
+    if (!db.open(filePath)) {
+        return false;
+    }
+    *info = db.documentInfo();
+    return true;
+}
+
+// 图形区域直接由 R*Tree 汇总，不需要解码任何记录
+bool FpaDatabase::writeDocumentInfo(const QByteArray &preview)
+{
+    QRect bounds;
+    if (m_writeBounds && hasSpatialIndex()) {
+        QSqlQuery query(m_db);
+        if (!query.exec("SELECT MIN(min_x), MAX(max_x), MIN(min_y), MAX(max_y), COUNT(*) FROM shapes_rtree") || !query.next()) {
+            warn("Failed to query shape bounds.", query);
+            return false;
+        }
+        if (query.value(4).toInt() > 0) {
+            bounds = QRect(QPoint(query.value(0).toInt(), query.value(2).toInt()),
+                           QPoint(query.value(1).toInt(), query.value(3).toInt()));
+        }
+    }
+    // 提交时文件升级到 SchemaVersion（见 commit()）
+    bool ok = setMetaValue("schema_version", SchemaVersion)
+              && setMetaValue("shape_count", shapeCount())
+              && setMetaValue("preview", preview);
+    if (bounds.isValid()) {
+        ok = ok && setMetaValue("bounds_x", bounds.x()) && setMetaValue("bounds_y", bounds.y())
+             && setMetaValue("bounds_width", bounds.width()) && setMetaValue("bounds_height", bounds.height());
+    } else {
+        ok = ok && removeMetaValue("bounds_x") && removeMetaValue("bounds_y")
+             && removeMetaValue("bounds_width") && removeMetaValue("bounds_height");
+    }
+    return ok;
+}
+
+bool FpaDatabase::readShapes(const std::function<bool(const ShapeRow &)> &visitor)
+{
+    // 版本 1 的文件没有 z_order 和 data 列
+    const QString zOrder = hasColumn("shapes", "z_order") ? QString("z_order") : QString("id * %1").arg(ZOrderGap);
+    const QString data = hasColumn("shapes", "data") ? "data" : "NULL";
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    const QString sql = QString("SELECT id, %1, %2, json_data FROM shapes ORDER BY %1, id").arg(zOrder, data);
+    if (!query.exec(sql)) {
+        warn("Failed to query shapes.", query);
+        return false;
+    }
+    return readRows(query, visitor);
+}
+
+// R*Tree 先找出区域相交的 id，再按主键取出这些行；只有结果需要排序
+bool FpaDatabase::readShapesInArea(const QRect &area, const std::function<bool(const ShapeRow &)> &visitor)
+{
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    query.prepare("SELECT s.id, s.z_order, s.data, s.json_data FROM shapes_rtree r JOIN shapes s ON s.id = r.id "
+                  "WHERE r.max_x >= ? AND r.min_x <= ? AND r.max_y >= ? AND r.min_y <= ? ORDER BY s.z_order, s.id");
+    bindArea(query, area);
+    if (!query.exec()) {
+        warn("Failed to query shapes in area.", query);
+        return false;
+    }
+    return readRows(query, visitor);
+}
+
+int FpaDatabase::shapeCountInArea(const QRect &area)
+{
+    QSqlQuery query(m_db);
+    query.prepare("SELECT COUNT(*) FROM shapes_rtree r WHERE r.max_x >= ? AND r.min_x <= ? AND r.max_y >= ? AND r.min_y <= ?");
+    bindArea(query, area);
+    if (!query.exec() || !query.next()) {
+        return 0;
+    }
+    return query.value(0).toInt();
+}
+
+bool FpaDatabase::readShape(quint64 id, ShapeRow *row)
+{
+    QSqlQuery query(m_db);
+    query.prepare("SELECT id, z_order, data, json_data FROM shapes WHERE id = ?");
+    query.bindValue(0, id);
+    if (!query.exec()) {
+        warn("Failed to query shape.", query);
+        return false;
+    }
+    bool found = false;
+    readRows(query, [row, &found](const ShapeRow &result) {
+        *row = result;
+        found = true;
+        return false;
+    });
+    return found;
+}
+
+bool FpaDatabase::writeBackgroundTile(const TileRow &tile)
+{
+    if (!m_tilesCleared) {
+        if (!ensureContentHash()) {
+            return false;
+        }
+        quint64 oldHash = 0;
+        if (storedTileHash(tile, &oldHash)) {
+            m_backgroundHash -= oldHash;
+        }
+    }
+    m_backgroundHash += tileHash(tile);
+    QSqlQuery query(m_db);
+    query.prepare("INSERT OR REPLACE INTO background_tiles (level, tile_x, tile_y, data) VALUES (?, ?, ?, ?)");
+    query.bindValue(0, tile.level);
+    query.bindValue(1, tile.x);
+    query.bindValue(2, tile.y);
+    query.bindValue(3, tile.data);
+    if (!query.exec()) {
+        warn("Failed to write background tile.", query);
+        return false;
+    }
+    return true;
+}
+
+bool FpaDatabase::deleteBackgroundTiles()
+{
+    QSqlQuery query(m_db);
+    if (!query.exec("DELETE FROM background_tiles")) {
+        warn("Failed to clear background tiles.", query);
+        return false;
+    }
+    m_backgroundHash = 0;
+    m_backgroundHashKnown = true;
+    m_tilesCleared = true;
+    return true;
+}
+
+bool FpaDatabase::readBackgroundTiles(int level, const std::function<bool(const TileRow &)> &visitor, const QRect &tiles)
+{
+    if (!m_db.tables().contains("background_tiles")) {
+        return true;
+    }
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    if (level < 0) {
+        query.prepare("SELECT level, tile_x, tile_y, data FROM background_tiles");
+    } else if (tiles.isNull()) {
+        query.prepare("SELECT level, tile_x, tile_y, data FROM background_tiles WHERE level = ?");
+        query.bindValue(0, level);
+    } else {
+        // 主键的前缀是 (level, tile_x)，按列范围查找只扫描需要的部分
+        query.prepare("SELECT level, tile_x, tile_y, data FROM background_tiles "
+                      "WHERE level = ? AND tile_x BETWEEN ? AND ? AND tile_y BETWEEN ? AND ?");
+        query.bindValue(0, level);
+        query.bindValue(1, tiles.left());
+        query.bindValue(2, tiles.right());
+        query.bindValue(3, tiles.top());
+        query.bindValue(4, tiles.bottom());
+    }
+    if (!query.exec()) {
+        warn("Failed to query background tiles.", query);
+        return false;
+    }
+    while (query.next()) {
+        TileRow tile;
+        tile.level = query.value(0).toInt();
+        tile.x = query.value(1).toInt();
+        tile.y = query.value(2).toInt();
+        tile.data = query.value(3).toByteArray();
+        if (!visitor(tile)) {
+            break;
+        }
+    }
+    return true;
+}
+
+bool FpaDatabase::readRows(QSqlQuery &query, const std::function<bool(const ShapeRow &)> &visitor)
+{
+    while (query.next()) {
+        ShapeRow row;
+        row.id = query.value(0).toULongLong();
+        row.zOrder = query.value(1).toLongLong();
+        row.data = query.value(2).toByteArray();
+        if (row.data.isEmpty()) {
+            row.jsonData = query.value(3).toString();
+        }
+        if (!visitor(row)) {
+            break;
+        }
+    }
+    return true;
+}
+
+void FpaDatabase::bindArea(QSqlQuery &query, const QRect &area)
+{
+    query.bindValue(0, area.left());
+    query.bindValue(1, area.right());
+    query.bindValue(2, area.top());
+    query.bindValue(3, area.bottom());
+}
+
+bool FpaDatabase::hasColumn(const QString &table, const QString &column)
+{
+    return m_db.record(table).contains(column);
+}
+
+// 摘要随每次写入一起提交，只在增量写入需要旧值时才读取；完整保存清空了两张表，
+// 摘要直接由写入的行累加，不读取文件。没有摘要的旧版本文件在第一次需要时完整计算一次
+bool FpaDatabase::ensureContentHash()
+{
+    if (m_shapesHashKnown && m_backgroundHashKnown) {
+        return true;
+    }
+    const QVariant shapes = metaValue("shapes_hash");
+    const QVariant background = metaValue("background_hash");
+    if (shapes.isValid() && background.isValid()) {
+        if (!m_shapesHashKnown) {
+            m_shapesHash = quint64(shapes.toLongLong());
+            m_shapesHashKnown = true;
+        }
+        if (!m_backgroundHashKnown) {
+            m_backgroundHash = quint64(background.toLongLong());
+            m_backgroundHashKnown = true;
+        }
+        return true;
+    }
+
+    if (!m_shapesHashKnown) {
+        QSqlQuery query(m_db);
+        query.setForwardOnly(true);
+        if (!query.exec("SELECT id, z_order, type, data, json_data FROM shapes")) {
+            warn("Failed to query shapes.", query);
+            return false;
+        }
+        quint64 hash = 0;
+        while (query.next()) {
+            const QByteArray data = query.value(3).toByteArray();
+            hash += rowHash(query.value(0).toULongLong(), query.value(1).toLongLong(), query.value(2).toString(),
+                            data.isEmpty() ? query.value(4).toString().toUtf8() : data);
+        }
+        m_shapesHash = hash;
+        m_shapesHashKnown = true;
+    }
+    if (!m_backgroundHashKnown) {
+        quint64 hash = 0;
+        if (!readBackgroundTiles(-1, [&hash](const TileRow &tile) {
+                hash += tileHash(tile);
+                return true;
+            })) {
+            return false;
+        }
+        m_backgroundHash = hash;
+        m_backgroundHashKnown = true;
+    }
+    return true;
+}
+
+bool FpaDatabase::storedRow(quint64 id, qint64 *zOrder, QString *type, QByteArray *payload)
+{
+    m_storedRowQuery.bindValue(0, id);
+    if (!m_storedRowQuery.exec() || !m_storedRowQuery.next()) {
+        return false;
+    }
+    *zOrder = m_storedRowQuery.value(0).toLongLong();
+    *type = m_storedRowQuery.value(1).toString();
+    *payload = m_storedRowQuery.value(2).toByteArray();
+    if (payload->isEmpty()) {
+        *payload = m_storedRowQuery.value(3).toString().toUtf8();
+    }
+    m_storedRowQuery.finish();
+    return true;
+}
+
+bool FpaDatabase::storedTileHash(const TileRow &tile, quint64 *hash)
+{
+    QSqlQuery query(m_db);
+    query.prepare("SELECT data FROM background_tiles WHERE level = ? AND tile_x = ? AND tile_y = ?");
+    query.bindValue(0, tile.level);
+    query.bindValue(1, tile.x);
+    query.bindValue(2, tile.y);
+    if (!query.exec() || !query.next()) {
+        return false;
+    }
+    TileRow stored = tile;
+    stored.data = query.value(0).toByteArray();
+    *hash = tileHash(stored);
+    return true;
+}
+
+// 行内容（二进制记录，或旧版本的 JSON 文本）连同 id 和 z_order 一起取 SHA-1 的前 8 个字节
+quint64 FpaDatabase::rowHash(quint64 id, qint64 zOrder, const QString &type, const QByteArray &payload)
+{
+    char key[16];
+    qToLittleEndian(id, key);
+    qToLittleEndian(zOrder, key + 8);
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray(key, sizeof(key)));
+    hash.addData(type.toUtf8());
+    hash.addData(QByteArray(1, '\0'));
+    hash.addData(payload);
+    return qFromLittleEndian<quint64>(hash.result().constData());
+}
+
+quint64 FpaDatabase::tileHash(const TileRow &tile)
+{
+    char key[12];
+    qToLittleEndian(qint32(tile.level), key);
+    qToLittleEndian(qint32(tile.x), key + 4);
+    qToLittleEndian(qint32(tile.y), key + 8);
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray(key, sizeof(key)));
+    hash.addData(tile.data);
+    return qFromLittleEndian<quint64>(hash.result().constData());
+}
+
+void FpaDatabase::warn(const char *what, const QSqlQuery &query) const
+{
+    qWarning() << "Error:" << what << query.lastError();
+}
@@ -0,0 +1,183 @@
+#ifndef FPADATABASE_H
+#define FPADATABASE_H
+
+// ---------------------------------------------------------------------------
+// 描述: 定义了 FpaDatabase 类，封装 .fpa 项目文件（SQLite 数据库）的表结构和读写语句。
+//       shapes 表的每一行是一个顶层图形：
+//           id        图形的持久 ID（AbstractShape::getId()），也是 SQLite 的 rowid
+//           z_order   绘制顺序，值越小越先画；相邻图形之间留有间隔，插入时不必给其他行重新编号
+//           type      图形类型名，与 JSON 中的 "type" 相同
+//           data      图形记录的二进制编码（见 ShapeCodec），版本 2 起写入
+//           json_data 图形的 JSON 文本，版本 1 的格式；新写入的行为 NULL
+//       meta 表以键值对保存文件级的信息（版本 3 起），例如文件内容对应的命令日志检查点（见 CommandJournal）。
+//       版本 6 起每次保存还在 meta 表中写入文件摘要（见 DocumentInfo）：预览图、图形区域、图形数、
+//       表结构版本和内容摘要，读取它们不需要解码任何图形。
+//       shapes_rtree 是 SQLite 的 R*Tree 虚拟表（版本 4 起），保存每个图形在画布上影响的区域
+//       （AbstractShape::getDamageRect()），按区域查询图形时不必解码任何记录。
+//       background_tiles 表（版本 5 起）保存背景图金字塔的瓦片（见 BackgroundPyramid），
+//       以 (level, tile_x, tile_y) 为主键，尺寸信息在 meta 表中。
+//       版本 7 起自由曲线可以保存为三次贝塞尔曲线段（记录中的 "curves"），不认识它的旧版本会读出空的笔画，
+//       因此这一版本只是为了让旧版本拒绝打开这样的文件，表结构没有变化。
+//       PRAGMA user_version 记录表结构版本。旧版本文件在第一次写入时自动升级，升级与写入在同一个事务中，
+//       版本号在提交前最后写入：
+//       补上 z_order 列并按 id 顺序编号，补上 data 列；未改写的行保留 json_data，读取时两种格式都支持；
+//       还没有区域的行由 DocumentSaver 在写入时补上。
+// ---------------------------------------------------------------------------
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QByteArray>
+#include <QRect>
+#include <QString>
+#include <QVariant>
+#include <functional>
+
+class FpaDatabase
+{
+public:
+    /// 新分配的 z_order 之间的间隔。在两个图形之间插入时取中点，
+    /// 间隔用完之前都不需要改动其他行。
+    static const qint64 ZOrderGap = 1024;
+    /// 当前写入的表结构版本（PRAGMA user_version）。
+    static const int SchemaVersion = 7;
+
+    struct ShapeRow
+    {
+        quint64 id;
+        qint64 zOrder;
+        QByteArray data;    // 二进制记录；为空时使用 jsonData
+        QString jsonData;
+    };
+
+    struct TileRow
+    {
+        int level;
+        int x;
+        int y;
+        QByteArray data;    // 编码后的瓦片图像
+    };
+
+    /// @brief 文件摘要，保存时写入 meta 表。
+    struct DocumentInfo
+    {
+        int schemaVersion = 0;
+        int shapeCount = 0;
+        QRect bounds;           // 所有图形影响的区域的并集；没有图形或未知时为空
+        QByteArray preview;     // 保存时画布的 PNG 缩略图，最长边不超过 PreviewSize
+        QString contentHash;    // 图形和背景图内容的摘要（十六进制）；内容相同的文件摘要相同。旧版本文件为空
+    };
+    /// 预览图最长边的像素数。
+    static const int PreviewSize = 256;
+
+    /// @param connectionName Qt SQL 连接名。同时打开的多个 FpaDatabase 必须使用不同的名字。
+    explicit FpaDatabase(const QString &connectionName);
+    ~FpaDatabase();
+
+    bool open(const QString &filePath);
+    void close();
+    bool isOpen() const { return m_db.isOpen(); }
+
+    /// @brief 设置写入用的 SQLite 参数（WAL 日志、synchronous=NORMAL），开始写事务，
+    /// 在事务中创建或升级表结构，并准备好写入语句。写入之前必须调用一次，之后用 commit() 或 rollback() 结束事务。
+    /// 失败时事务已经回滚。
+    bool prepareForWriting();
+
+    /// @brief 提交写事务。表结构版本 (user_version) 在提交前最后写入。
+    bool commit();
+    void rollback();
+
+    bool deleteAllShapes();
+    /// @brief 插入一行；id 已存在时更新这一行（UPSERT）。bounds 同时写入 shapes_rtree。
+    bool upsertShape(quint64 id, qint64 zOrder, const QString &type, const QByteArray &data, const QRect &bounds);
+    bool updateZOrder(quint64 id, qint64 zOrder);
+    bool deleteShape(quint64 id);
+
+    /// @brief 写入 meta 表中的一项，key 已存在时覆盖。
+    bool setMetaValue(const QString &key, const QVariant &value);
+    /// @brief 读取 meta 表中的一项。没有 meta 表（旧版本文件）或没有这一项时返回无效的 QVariant。
+    QVariant metaValue(const QString &key);
+    bool removeMetaValue(const QString &key);
+
+    /// @brief 文件中最大的图形 ID；没有图形时返回 0。
+    quint64 maxShapeId();
+    /// @brief 文件中最大的 z_order；没有图形时返回 0。
+    qint64 maxZOrder();
+
+    /// @brief 是否每个图形都有 shapes_rtree 中的区域，即能否按区域查询。
+    bool hasSpatialIndex();
+    /// @brief 给还没有区域的行（旧版本写入的行）补上区域，之后 hasSpatialIndex() 返回 true。
+    /// 在写事务中调用。
+    /// @param boundsOf 计算一行的区域，需要解码记录；返回空矩形表示无法解码，这一行不进入索引。
+    bool completeSpatialIndex(const std::function<QRect(const ShapeRow &)> &boundsOf);
+
+    /// @brief 用 VACUUM INTO 把整个文件（包括 WAL 中已提交的内容）复制到 filePath。filePath 不能已经存在。
+    bool copyTo(const QString &filePath);
+
+    /// @brief 文件中的图形行数。
+    int shapeCount();
+
+    /// @brief 文件的表结构版本。版本 1 的文件返回 0（SQLite 的默认值）。
+    int schemaVersion();
+    /// @brief 是否能读取 schemaVersion 版本的文件。更新的版本写入的文件可能包含不认识的内容。
+    static bool isSupportedVersion(int schemaVersion) { return schemaVersion <= SchemaVersion; }
+
+    /// @brief 读取文件摘要，只查询 meta 表。没有摘要的旧版本文件只填入版本和图形数。
+    DocumentInfo documentInfo();
+    /// @brief 打开 filePath 并读取它的摘要；文件无法打开时返回 false。
+    static bool readDocumentInfo(const QString &filePath, DocumentInfo *info);
+    /// @brief 写入文件摘要。在写事务中、所有图形写完之后调用；图形数、区域和内容摘要由文件内容得出。
+    /// @param preview PNG 格式的预览图。
+    bool writeDocumentInfo(const QByteArray &preview);
+
+    /// @brief 按 z_order 顺序读取所有图形行。旧版本文件按 id 顺序读取，zOrder 为 id × ZOrderGap。
+    /// @param visitor 对每一行调用一次；返回 false 时停止读取。
+    bool readShapes(const std::function<bool(const ShapeRow &)> &visitor);
+
+    /// @brief 按 z_order 顺序读取区域与 area 相交的图形行。需要 hasSpatialIndex()。
+    bool readShapesInArea(const QRect &area, const std::function<bool(const ShapeRow &)> &visitor);
+    /// @brief 区域与 area 相交的图形数。
+    int shapeCountInArea(const QRect &area);
+    /// @brief 读取一个图形行。没有这一行时返回 false。
+    bool readShape(quint64 id, ShapeRow *row);
+
+    bool writeBackgroundTile(const TileRow &tile);
+    bool deleteBackgroundTiles();
+    /// @brief 读取背景图第 level 级的瓦片；level 小于 0 时读取所有级。没有 background_tiles 表时什么也不读。
+    /// @param tiles 不为空时只读取列、行号在这个范围内的瓦片。
+    bool readBackgroundTiles(int level, const std::function<bool(const TileRow &)> &visitor, const QRect &tiles = QRect());
+
+private:
+    bool beginTransaction();
+    bool upgradeSchema();
+    bool prepareStatements();
+    bool hasColumn(const QString &table, const QString &column);
+    bool readRows(QSqlQuery &query, const std::function<bool(const ShapeRow &)> &visitor);
+    bool setShapeBounds(quint64 id, const QRect &bounds);
+    void bindArea(QSqlQuery &query, const QRect &area);
+    void warn(const char *what, const QSqlQuery &query) const;
+    bool ensureContentHash();
+    bool storedRow(quint64 id, qint64 *zOrder, QString *type, QByteArray *payload);
+    bool storedTileHash(const TileRow &tile, quint64 *hash);
+    static quint64 rowHash(quint64 id, qint64 zOrder, const QString &type, const QByteArray &payload);
+    static quint64 tileHash(const TileRow &tile);
+
+    QString m_connectionName;
+    QSqlDatabase m_db;
+    QSqlQuery m_upsertQuery;
+    QSqlQuery m_updateZOrderQuery;
+    QSqlQuery m_deleteQuery;
+    QSqlQuery m_upsertBoundsQuery;
+    QSqlQuery m_deleteBoundsQuery;
+    QSqlQuery m_storedRowQuery;
+    bool m_writeBounds;     // SQLite 不支持 R*Tree 时只写 shapes 表
+    bool m_upgradeVersion;  // 提交时把 user_version 改为 SchemaVersion
+    // 内容摘要是每一行、每个瓦片各自摘要的和，写入时只需减去旧行、加上新行
+    bool m_shapesHashKnown;     // m_shapesHash 与表中内容一致
+    bool m_backgroundHashKnown;
+    bool m_shapesCleared;       // 本事务中已清空 shapes 表，写入的行没有旧值
+    bool m_tilesCleared;
+    quint64 m_shapesHash;
+    quint64 m_backgroundHash;
+};
+
+#endif // FPADATABASE_H
@@ -6,7 +6,7 @@
 #include "freehandpathshape.h"
 #include <QPainter>             // draw 方法需要
 #include <QPen>                 // 用于设置画笔
-#include <QPainterPathStroker>  // containsPoint 方法需要
+#include "geometrykernels.h"     // containsPoint 方法需要
 #include <QDebug>               // 用于调试输出 (如果需要)
 #include <QJsonObject>
 #include <QJsonArray>
@@ -23,43 +23,107 @@ FreehandPathShape::FreehandPathShape(const QVector<QPoint> &points,
     //    - false, Qt::transparent: 自由曲线不进行填充。
     m_points(points) // 2. 初始化存储点的 QVector 成员
 {
-    // 3. 根据初始的点集构建内部的 QPainterPath 对象，以备绘制和计算使用。
-    buildPath();
+    // 3. 根据初始的点集计算包围盒，以备绘制和计算使用。
+    updateBounds();
     // qDebug() << "FreehandPathShape created with" << m_points.size() << "points.";
 }
 
-/// @brief 私有辅助函数，根据当前的 m_points 点集更新（重建）内部的 m_painterPath 对象。
-/// 当 m_points 列表为空或只有一个点时，m_painterPath 将被清空或设为无效，
-/// 因为至少需要两个点才能形成一条可绘制的线段或路径。
-void FreehandPathShape::buildPath()
+AbstractShape *FreehandPathShape::clone() const
 {
-    // 清空现有的 QPainterPath，准备重新构建
-    m_painterPath = QPainterPath(); // 或者 m_painterPath.clear();
+    return new FreehandPathShape(*this);
+}
 
-    if (m_points.size() >= 2) { // 至少需要两个点才能构成一条路径
-        m_painterPath.moveTo(m_points.first()); // 将路径的当前点移动到点集的第一个点
-        for (int i = 1; i < m_points.size(); ++i) {
-            m_painterPath.lineTo(m_points.at(i)); // 从当前点向点集中的下一个点添加一条直线段
-        }
-    } else if (m_points.size() == 1) {
-        // 如果只有一个点，可以创建一个包含该点的极小路径，
-        // 这样 QPainter 使用 RoundCap 时可以画出一个点。
-        m_painterPath.moveTo(m_points.first());
-        m_painterPath.lineTo(m_points.first()); // 画一个长度为0的线，配合RoundCap画点
+namespace {
+template <typename Point>
+QRectF boundsOf(const QVector<Point> &points)
+{
+    if (points.isEmpty()) {
+        return QRectF();
     }
-    // 如果 m_points 为空，m_painterPath 也会是空的 (默认构造或 clear() 后)
+    qreal left = points.first().x(), right = left;
+    qreal top = points.first().y(), bottom = top;
+    for (const Point &p : points) {
+        left = qMin(left, qreal(p.x()));
+        right = qMax(right, qreal(p.x()));
+        top = qMin(top, qreal(p.y()));
+        bottom = qMax(bottom, qreal(p.y()));
+    }
+    return QRectF(QPointF(left, top), QPointF(right, bottom));
+}
+
+// JSON 中曲线坐标保留两位小数，足够精确，也避免输出很长的浮点数
+double roundCoordinate(qreal value)
+{
+    return qRound64(value * 100.0) / 100.0;
+}
+}
+
+/// @brief 私有辅助函数，根据当前的点集重新计算包围盒 m_pointBounds。
+/// 折线模式下是所有采样点的包围盒；曲线模式下是曲线本身的紧包围盒（QPainterPath 按曲线的极值点计算），
+/// 不包含伸出曲线之外的控制点。
+void FreehandPathShape::updateBounds()
+{
+    m_pointBounds = hasCurves() ? curvePath().boundingRect() : boundsOf(m_points);
+    invalidateCaches();
+}
+
+void FreehandPathShape::invalidateCaches()
+{
+    AbstractShape::invalidateCaches();
+    m_flattenedValid = false;
+}
+
+/// @brief 由曲线段构造的路径。每次调用都新建，不在多个线程之间共享。
+QPainterPath FreehandPathShape::curvePath() const
+{
+    QPainterPath path;
+    if (m_curves.isEmpty()) {
+        return path;
+    }
+    path.moveTo(m_curves.first().p0);
+    for (const CubicSegment &segment : m_curves) {
+        path.cubicTo(segment.c1, segment.c2, segment.p3);
+    }
+    return path;
+}
+
+/// @brief 曲线展平后的折线，与曲线的偏差不超过 0.25 像素，只在点击测试时按需计算。
+const QVector<QPointF> &FreehandPathShape::flattened() const
+{
+    if (!m_flattenedValid) {
+        m_flattened = CurveFitter::flatten(m_curves);
+        m_flattenedValid = true;
+    }
+    return m_flattened;
+}
+
+bool FreehandPathShape::fitCurves(qreal maxError)
+{
+    QVector<CubicSegment> curves = CurveFitter::fit(m_points, maxError);
+    if (curves.isEmpty()) {
+        return false;
+    }
+    setCurves(curves);
+    return true;
+}
+
+void FreehandPathShape::setCurves(const QVector<CubicSegment> &curves)
+{
+    m_curves = curves;
+    m_points.clear();
+    updateBounds();
 }
 
 void FreehandPathShape::draw(QPainter *painter)
 {
-    if (!painter || m_painterPath.isEmpty()) {
+    if (!painter || (m_points.isEmpty() && m_curves.isEmpty())) {
         return;
     }
 
     painter->save(); // 保存状态
 
-    // 以路径包围盒的中心为旋转中心
-    QPointF center = m_painterPath.boundingRect().center();
+    // 以点集包围盒的中心为旋转中心
+    QPointF center = m_pointBounds.center();
     painter->translate(center);
     painter->rotate(m_rotationAngle);
     painter->translate(-center);
@@ -74,8 +138,18 @@ void FreehandPathShape::draw(QPainter *painter)
 
     painter->setBrush(Qt::NoBrush);
 
-    // 在旋转后的坐标系上绘制路径
-    painter->drawPath(m_painterPath);
+    // 在旋转后的坐标系上直接绘制折线。
+    // draw() 可能在场景缓存的多个工作线程中同时调用，这里只读取 m_points / m_curves，
+    // 曲线模式下的路径在本次调用中临时构造，由 QPainter 按当前的缩放展平。
+    // 只有一个点时画一条长度为 0 的线，配合 RoundCap 画出圆点。
+    if (hasCurves()) {
+        painter->drawPath(curvePath());
+    } else if (m_points.size() == 1) {
+        const QPoint dot[2] = { m_points.first(), m_points.first() };
+        painter->drawPolyline(dot, 2);
+    } else {
+        painter->drawPolyline(m_points.constData(), m_points.size());
+    }
 
     painter->restore(); // 恢复状态
 }
@@ -83,28 +157,24 @@ void FreehandPathShape::draw(QPainter *painter)
 
 QRect FreehandPathShape::getBoundingRect() const
 {
-    if (m_rotationAngle == 0.0) return m_painterPath.controlPointRect().toAlignedRect();
+    if (m_rotationAngle == 0.0) return m_pointBounds.toAlignedRect();
     QTransform t;
-    QPointF center = m_painterPath.boundingRect().center();
+    QPointF center = m_pointBounds.center();
     t.translate(center.x(), center.y());
     t.rotate(m_rotationAngle);
     t.translate(-center.x(), -center.y());
-    return t.mapRect(m_painterPath.boundingRect()).toAlignedRect();
+    return t.mapRect(m_pointBounds).toAlignedRect();
 }
 
 bool FreehandPathShape::containsPoint(const QPoint &point) const
 {
-    QTransform t;
-    QPointF center = m_painterPath.boundingRect().center();
-    t.translate(center.x(), center.y());
-    t.rotate(m_rotationAngle);
-    t.translate(-center.x(), -center.y());
-
-    QPointF unrotatedPoint = t.inverted().map(QPointF(point));
-
-    QPainterPathStroker stroker;
-    stroker.setWidth(this->getPenWidth() + 4.0);
-    return stroker.createStroke(m_painterPath).contains(unrotatedPoint);
+    // 在未旋转的坐标系中计算点到折线的距离
+    QPointF unrotatedPoint = inverseRotation().map(QPointF(point));
+    if (hasCurves()) {
+        const QVector<QPointF> &polyline = flattened();
+        return GeometryKernels::polylineNear(polyline.constData(), polyline.size(), unrotatedPoint, hitRadius());
+    }
+    return GeometryKernels::polylineNear(m_points.constData(), m_points.size(), unrotatedPoint, hitRadius());
 }
 
 /// @brief FreehandPathShape 类的 moveBy 方法实现。
@@ -115,8 +185,20 @@ void FreehandPathShape::moveBy(const QPoint &offset)
     for (QPoint &p : m_points) { // 使用引用 & 来直接修改容器中的点对象
         p += offset;
     }
-    // 点集发生变化后，必须重新构建内部的 QPainterPath
-    buildPath();
+    // 曲线模式下平移所有控制点；包围盒随之平移，展平的折线下次点击测试时重新计算
+    for (CubicSegment &segment : m_curves) {
+        segment.p0 += offset;
+        segment.c1 += offset;
+        segment.c2 += offset;
+        segment.p3 += offset;
+    }
+    if (hasCurves()) {
+        m_pointBounds.translate(offset);
+        invalidateCaches();
+        return;
+    }
+    // 点集发生变化后，重新计算包围盒
+    updateBounds();
 }
 
 /// @brief FreehandPathShape 类的 updateShape 方法实现。
@@ -128,21 +210,33 @@ void FreehandPathShape::updateShape(const QPoint &point)
 }
 
 /// @brief 向此自由曲线的点集 (m_points) 末尾添加一个新点。
-/// 添加点后，会自动调用 buildPath() 来更新内部的 QPainterPath。
+/// 只扩展已有的包围盒，均摊 O(1)，
+/// 因此绘制一条 n 个点的笔画总共是 O(n)，而不是每次都重新计算的 O(n²)。
 /// @param point 要添加的 QPoint。
 void FreehandPathShape::addPoint(const QPoint &point)
 {
     m_points.append(point); // 将新点添加到点集末尾
-    buildPath();            // 重新构建 QPainterPath 以反映新的点集
+
+    if (m_points.size() == 1) {
+        updateBounds();
+        return;
+    }
+
+    m_pointBounds.setLeft(qMin(m_pointBounds.left(), qreal(point.x())));
+    m_pointBounds.setRight(qMax(m_pointBounds.right(), qreal(point.x())));
+    m_pointBounds.setTop(qMin(m_pointBounds.top(), qreal(point.y())));
+    m_pointBounds.setBottom(qMax(m_pointBounds.bottom(), qreal(point.y())));
+    invalidateCaches();
 }
 
 /// @brief 设置构成此自由曲线的完整点集。
-/// 这会替换掉现有的所有点。调用此方法后，会自动调用 buildPath() 来更新内部的 QPainterPath。
+/// 这会替换掉现有的所有点。调用此方法后，会自动调用 updateBounds() 重新计算包围盒。
 /// @param points 包含所有新点的 QVector<QPoint>。
 void FreehandPathShape::setPoints(const QVector<QPoint> &points)
 {
     m_points = points; // 用新的点集替换旧的点集
-    buildPath();       // 重新构建 QPainterPath
+    m_curves.clear();  // 设置点集即退出曲线模式
+    updateBounds();    // 重新计算包围盒
 }
 
 
@@ -154,13 +248,28 @@ QJsonObject FreehandPathShape::toJsonObject() const
     json["border_color"] = this->getBorderColor().name();
 
     QJsonObject geometry;
-    QJsonArray pointsArray;
-    // 遍历所有点
-    for(const QPoint &p : m_points){
-        // 将每个 QPoint(x,y) 转换为 [x, y] 数组，并添加到 pointsArray 中
-        pointsArray.append(QJsonArray({p.x(), p.y()}));
+    if (hasCurves()) {
+        // 曲线模式: "curves" 是一个扁平的数字数组，先是起点 x, y，
+        // 之后每段依次是 c1, c2, p3 的坐标（6 个数），前一段的终点就是下一段的起点。
+        QJsonArray curvesArray;
+        curvesArray.append(roundCoordinate(m_curves.first().p0.x()));
+        curvesArray.append(roundCoordinate(m_curves.first().p0.y()));
+        for (const CubicSegment &segment : m_curves) {
+            for (const QPointF &p : { segment.c1, segment.c2, segment.p3 }) {
+                curvesArray.append(roundCoordinate(p.x()));
+                curvesArray.append(roundCoordinate(p.y()));
+            }
+        }
+        geometry["curves"] = curvesArray;
+    } else {
+        QJsonArray pointsArray;
+        // 遍历所有点
+        for(const QPoint &p : m_points){
+            // 将每个 QPoint(x,y) 转换为 [x, y] 数组，并添加到 pointsArray 中
+            pointsArray.append(QJsonArray({p.x(), p.y()}));
+        }
+        geometry["points"] = pointsArray;
     }
-    geometry["points"] = pointsArray;
 
     json["geometry"] = geometry;
     return json;
@@ -169,7 +278,7 @@ QJsonObject FreehandPathShape::toJsonObject() const
 QPointF FreehandPathShape::getCenter() const
 {
     // 自由路径的几何中心，就是其外包围盒的中心
-    return m_painterPath.boundingRect().center();
+    return m_pointBounds.center();
 }
 
 QRectF FreehandPathShape::getCoreGeometry() const
@@ -3,10 +3,11 @@
 #define FREEHANDPATHSHAPE_H
 
 #include "abstractshape.h"
-#include <QPainterPath>
+#include "curvefitter.h"
 #include <QVector>
 #include <QPoint>
 #include <QJsonObject>
+#include <QPainterPath>
 
 class FreehandPathShape : public AbstractShape
 {
@@ -14,6 +15,8 @@ public:
     FreehandPathShape(const QVector<QPoint> &points,
                       const QColor &borderColor, int penWidth);
 
+    AbstractShape *clone() const override;
+
     void draw(QPainter *painter) override;
     QRect getBoundingRect() const override;
     bool containsPoint(const QPoint &point) const override;
@@ -29,10 +32,31 @@ public:
     void setPoints(const QVector<QPoint> &points);
     const QVector<QPoint> &getPoints() const { return m_points; }
 
+    /// @brief 把当前的采样点拟合为三次贝塞尔曲线段，并切换到曲线模式。
+    /// 曲线模式下 m_points 被清空，绘制和序列化都使用曲线段；点击测试使用按需展平的折线。
+    /// @param maxError 曲线与原始采样点之间允许的最大偏差（像素）。
+    /// @return 拟合成功返回 true；点数不足时保持原样并返回 false。
+    bool fitCurves(qreal maxError);
+    /// @brief 直接设置曲线段（例如从文件加载），并切换到曲线模式。
+    void setCurves(const QVector<CubicSegment> &curves);
+    bool hasCurves() const { return !m_curves.isEmpty(); }
+    const QVector<CubicSegment> &getCurves() const { return m_curves; }
+
+protected:
+    void invalidateCaches() override;
+
 private:
-    void buildPath();
+    void updateBounds();
+    QPainterPath curvePath() const;
+    const QVector<QPointF> &flattened() const;
+
     QVector<QPoint> m_points;
-    QPainterPath m_painterPath;
+    QVector<CubicSegment> m_curves;     // 曲线模式下的几何数据
+    // m_curves 展平后的折线，只用于点击测试，第一次点击时才计算，几何变化后失效。
+    // 绘制时不使用它（draw() 可能在多个线程中同时调用），而是直接用 cubicTo 绘制曲线。
+    mutable QVector<QPointF> m_flattened;
+    mutable bool m_flattenedValid = false;
+    QRectF m_pointBounds; // 所有点的包围盒，也是旋转中心的来源
 };
 
 #endif // FREEHANDPATHSHAPE_H
@@ -0,0 +1,172 @@
+#include "geometrykernels.h"
+#include <QPair>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+// 每块处理的线段数。块内只做算术和 min/max，块结束时才判断一次是否命中。
+const int ChunkSize = 16;
+
+template <typename Point>
+bool polylineNearImpl(const Point *points, int count, const QPointF &p, qreal radius, bool closed)
+{
+    if (!points || count <= 0) {
+        return false;
+    }
+    const double px = p.x();
+    const double py = p.y();
+    const double radiusSquared = double(radius) * radius;
+
+    if (count == 1) {
+        const double dx = points[0].x() - px;
+        const double dy = points[0].y() - py;
+        return dx * dx + dy * dy <= radiusSquared;
+    }
+
+    const int segments = count - 1;
+    for (int start = 0; start < segments; start += ChunkSize) {
+        const int end = std::min(start + ChunkSize, segments);
+        double best = std::numeric_limits<double>::max();
+        for (int i = start; i < end; ++i) {
+            const double ax = points[i].x();
+            const double ay = points[i].y();
+            const double dx = points[i + 1].x() - ax;
+            const double dy = points[i + 1].y() - ay;
+            const double lengthSquared = dx * dx + dy * dy;
+            // 退化线段的分子也是 0，t 得到 0，即到端点 a 的距离
+            double t = ((px - ax) * dx + (py - ay) * dy) / std::max(lengthSquared, 1e-12);
+            t = std::min(1.0, std::max(0.0, t));
+            const double cx = ax + t * dx - px;
+            const double cy = ay + t * dy - py;
+            best = std::min(best, cx * cx + cy * cy);
+        }
+        if (best <= radiusSquared) {
+            return true;
+        }
+    }
+
+    if (closed) {
+        QPointF first(points[0].x(), points[0].y());
+        QPointF last(points[count - 1].x(), points[count - 1].y());
+        return GeometryKernels::distanceToSegmentSquared(p, last, first) <= radiusSquared;
+    }
+    return false;
+}
+}
+
+qreal GeometryKernels::distanceToSegmentSquared(const QPointF &p, const QPointF &a, const QPointF &b)
+{
+    const qreal dx = b.x() - a.x();
+    const qreal dy = b.y() - a.y();
+    const qreal lengthSquared = dx * dx + dy * dy;
+    qreal t = 0.0;
+    if (lengthSquared > 0.0) {
+        t = qBound(0.0, ((p.x() - a.x()) * dx + (p.y() - a.y()) * dy) / lengthSquared, 1.0);
+    }
+    const qreal cx = a.x() + t * dx - p.x();
+    const qreal cy = a.y() + t * dy - p.y();
+    return cx * cx + cy * cy;
+}
+
+bool GeometryKernels::polylineNear(const QPoint *points, int count, const QPointF &p, qreal radius, bool closed)
+{
+    return polylineNearImpl(points, count, p, radius, closed);
+}
+
+bool GeometryKernels::polylineNear(const QPointF *points, int count, const QPointF &p, qreal radius, bool closed)
+{
+    return polylineNearImpl(points, count, p, radius, closed);
+}
+
+bool GeometryKernels::rectOutlineNear(const QRectF &rect, const QPointF &p, qreal radius)
+{
+    const QRectF r = rect.normalized();
+    // 到矩形的外部距离（点在内部时为 0）
+    const qreal outsideX = std::max({ r.left() - p.x(), 0.0, p.x() - r.right() });
+    const qreal outsideY = std::max({ r.top() - p.y(), 0.0, p.y() - r.bottom() });
+    if (outsideX > 0.0 || outsideY > 0.0) {
+        return outsideX * outsideX + outsideY * outsideY <= radius * radius;
+    }
+    // 点在矩形内部：到最近一条边的距离
+    const qreal inside = std::min({ p.x() - r.left(), r.right() - p.x(), p.y() - r.top(), r.bottom() - p.y() });
+    return inside <= radius;
+}
+
+bool GeometryKernels::ellipseOutlineNear(const QRectF &rect, const QPointF &p, qreal radius)
+{
+    const QRectF r = rect.normalized();
+    const qreal a = r.width() / 2.0;
+    const qreal b = r.height() / 2.0;
+    const QPointF c = r.center();
+
+    // 退化为线段的椭圆直接按线段处理，避免除以 0
+    if (a < 1e-6 || b < 1e-6) {
+        QPointF from = (a < 1e-6) ? QPointF(c.x(), r.top()) : QPointF(r.left(), c.y());
+        QPointF to = (a < 1e-6) ? QPointF(c.x(), r.bottom()) : QPointF(r.right(), c.y());
+        return distanceToSegmentSquared(p, from, to) <= radius * radius;
+    }
+
+    const qreal x = p.x() - c.x();
+    const qreal y = p.y() - c.y();
+    const qreal a2 = a * a;
+    const qreal b2 = b * b;
+    // 隐式方程 f = x²/a² + y²/b² - 1，一阶距离近似 |f| / |∇f|
+    const qreal f = x * x / a2 + y * y / b2 - 1.0;
+    const qreal gx = 2.0 * x / a2;
+    const qreal gy = 2.0 * y / b2;
+    const qreal gradientSquared = gx * gx + gy * gy;
+    if (gradientSquared <= 0.0) {
+        // 正好在圆心：距离轮廓为短半轴长度
+        return std::min(a, b) <= radius;
+    }
+    return f * f <= radius * radius * gradientSquared;
+}
+
+QVector<QPoint> GeometryKernels::simplifyPolyline(const QVector<QPoint> &points, qreal tolerance)
+{
+    const int count = points.size();
+    if (count < 3 || tolerance <= 0.0) {
+        return points;
+    }
+
+    const qreal toleranceSquared = tolerance * tolerance;
+    QVector<bool> keep(count, false);
+    keep[0] = true;
+    keep[count - 1] = true;
+
+    // 每一项是一段待处理的区间 [first, last]，两端的点已确定保留
+    QVector<QPair<int, int>> stack;
+    stack.append(qMakePair(0, count - 1));
+    while (!stack.isEmpty()) {
+        const QPair<int, int> range = stack.takeLast();
+        const QPointF a = points.at(range.first);
+        const QPointF b = points.at(range.second);
+
+        // 使用点到线段（而不是到直线）的距离，笔画折返时首尾重合也能正确处理
+        qreal farthestSquared = -1.0;
+        int farthestIndex = -1;
+        for (int i = range.first + 1; i < range.second; ++i) {
+            const qreal d = distanceToSegmentSquared(points.at(i), a, b);
+            if (d > farthestSquared) {
+                farthestSquared = d;
+                farthestIndex = i;
+            }
+        }
+
+        if (farthestIndex >= 0 && farthestSquared > toleranceSquared) {
+            keep[farthestIndex] = true;
+            stack.append(qMakePair(range.first, farthestIndex));
+            stack.append(qMakePair(farthestIndex, range.second));
+        }
+    }
+
+    QVector<QPoint> result;
+    result.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        if (keep.at(i)) {
+            result.append(points.at(i));
+        }
+    }
+    return result;
+}
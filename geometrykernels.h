@@ -0,0 +1,51 @@
+#ifndef GEOMETRYKERNELS_H
+#define GEOMETRYKERNELS_H
+
+// ---------------------------------------------------------------------------
+// 描述: 点击测试用的解析几何函数。
+//       直线、折线、矩形、椭圆和星形的点击测试本质上都是距离问题：
+//       点到线段的距离是否小于 线宽/2 + 容差。填充图形的内部命中仍然按外接矩形判断，
+//       与改写前的行为一致，不需要这里的函数。
+//       这些函数直接计算距离，取代原先“生成描边路径再判断包含”的做法，
+//       既不分配内存，也不依赖 QPainterPathStroker。
+//
+//       所有函数都在图形自身“未旋转”的局部坐标系中工作，调用方先用
+//       AbstractShape::inverseRotation() 把点击位置映射回来。
+//
+//       与旧的描边实现的差异：描边使用方头线帽和斜角连接，这里使用圆形的距离包络。
+//       因此结果只在线段端点和外侧拐角附近不同，差异不超过 (√2 - 1) × radius，
+//       在其余位置两者完全一致。椭圆轮廓使用一阶 (Sampson) 距离近似，
+//       在轮廓附近（距离远小于短半轴时）与真实距离的相对误差是二阶小量。
+// ---------------------------------------------------------------------------
+
+#include <QPoint>
+#include <QPointF>
+#include <QPolygonF>
+#include <QRectF>
+#include <QVector>
+
+namespace GeometryKernels
+{
+/// @brief 点 p 到线段 ab 的距离的平方。ab 退化为一个点时返回到该点距离的平方。
+qreal distanceToSegmentSquared(const QPointF &p, const QPointF &a, const QPointF &b);
+
+/// @brief 判断点 p 与折线的距离是否不超过 radius。
+/// 循环按固定大小分块遍历连续的点数组，块内没有分支，编译器可以自动向量化。
+/// @param closed 为 true 时把最后一个点与第一个点也连成一段（多边形轮廓）。
+bool polylineNear(const QPoint *points, int count, const QPointF &p, qreal radius, bool closed = false);
+bool polylineNear(const QPointF *points, int count, const QPointF &p, qreal radius, bool closed = false);
+
+/// @brief 判断点 p 与矩形边框的距离是否不超过 radius（矩形内部远离边框的点不算）。
+bool rectOutlineNear(const QRectF &rect, const QPointF &p, qreal radius);
+
+/// @brief 判断点 p 与内切于 rect 的椭圆轮廓的距离是否不超过 radius。
+bool ellipseOutlineNear(const QRectF &rect, const QPointF &p, qreal radius);
+
+/// @brief Ramer–Douglas–Peucker 折线简化。
+/// 保留首尾两点，删除所有与简化后折线距离不超过 tolerance 的中间点。
+/// 使用显式栈而不是递归，数万个点的笔画也不会耗尽调用栈。
+/// @param tolerance 允许的最大偏差（像素）。小于等于 0 时原样返回。
+QVector<QPoint> simplifyPolyline(const QVector<QPoint> &points, qreal tolerance);
+}
+
+#endif // GEOMETRYKERNELS_H
@@ -1,14 +1,14 @@
 #include "groupcommand.h"
-#include "artboardview.h"
+#include "artboarddocument.h"
 #include "groupshape.h"
 #include <algorithm> // for std::sort
 
-GroupCommand::GroupCommand(const QList<AbstractShape*> &shapesToGroup, ArtboardView *view)
-    : m_view(view), m_shapesToGroup(shapesToGroup), m_groupShape(nullptr)
+GroupCommand::GroupCommand(const QList<AbstractShape*> &shapesToGroup, ArtboardDocument *document)
+    : m_document(document), m_shapesToGroup(shapesToGroup), m_groupShape(nullptr)
 {
     // 保存原始索引，用于撤销
     for(AbstractShape* shape : m_shapesToGroup) {
-        m_originalIndices.append(m_view->shapesList.indexOf(shape));
+        m_originalIndices.append(m_document->shapes().indexOf(shape));
     }
 }
 
@@ -16,20 +16,25 @@ GroupCommand::~GroupCommand()
 {
     // 如果组对象没有被添加到视图中（例如，命令在撤销后被销毁），
     // 则需要手动删除它，以避免内存泄漏。
-    if (m_groupShape && m_view && !m_view->shapesList.contains(m_groupShape)) {
+    if (m_groupShape && m_document && !m_document->shapes().contains(m_groupShape)) {
         delete m_groupShape;
     }
 }
 
 void GroupCommand::execute()
 {
-    if (!m_view || m_shapesToGroup.count() < 2) return;
+    if (!m_document || m_shapesToGroup.count() < 2) return;
+
+    // 编组前先把各个图形的区域加入待重绘区域，旧的选择装饰在更新选择时擦掉
+    for (AbstractShape* shape : m_shapesToGroup) {
+        m_document->updateShapeArea(shape);
+    }
 
     // 为了安全地移除，我们从高索引到低索引进行
     QList<int> sortedIndices = m_originalIndices;
     std::sort(sortedIndices.begin(), sortedIndices.end(), std::greater<int>());
     for (int index : sortedIndices) {
-        m_view->shapesList.removeAt(index);
+        m_document->removeShape(m_document->shapes().at(index));
     }
 
     // [ 关键修正 ]
@@ -40,22 +45,22 @@ void GroupCommand::execute()
         static_cast<GroupShape*>(m_groupShape)->addChildren(m_shapesToGroup);
     }
 
-    m_view->shapesList.append(m_groupShape);
+    m_document->appendShape(m_groupShape);
 
     // 更新选择
-    m_view->m_selectedShapes.clear();
-    m_view->m_selectedShapes.append(m_groupShape);
+    m_document->setSelectedShapes(QList<AbstractShape*>() << m_groupShape);
 
-    m_view->update();
+    m_document->updateShapeArea(m_groupShape);
 }
 
 // ----------------- groupcommand.cpp (请完整替换此函数) -----------------
 void GroupCommand::undo()
 {
-    if (!m_view || !m_groupShape) return;
+    if (!m_document || !m_groupShape) return;
 
-    // 1. 从视图中移除组对象
-    m_view->shapesList.removeOne(m_groupShape);
+    // 1. 从视图中移除组对象（移除前先把组及其选择框的区域加入待重绘区域）
+    m_document->updateShapeArea(m_groupShape);
+    m_document->removeShape(m_groupShape);
 
     // 2. [ 关键修正 ]
     // 让组对象移交其子图形的所有权。
@@ -69,12 +74,21 @@ void GroupCommand::undo()
         // 找到这个子图形对应的原始索引
         int originalShapeIndex = m_shapesToGroup.indexOf(children.at(i));
         int indexToInsert = m_originalIndices.at(originalShapeIndex);
-        m_view->shapesList.insert(indexToInsert, children.at(i));
+        m_document->insertShape(indexToInsert, children.at(i));
     }
 
     // 4. 恢复选择状态为原来的多个图形
-    m_view->m_selectedShapes.clear();
-    m_view->m_selectedShapes = children; // 使用从组里拿出来的、最新的子图形列表
+    m_document->setSelectedShapes(children); // 使用从组里拿出来的、最新的子图形列表
 
-    m_view->update();
+    for (AbstractShape* child : children) {
+        m_document->updateShapeArea(child);
+    }
+}
+
+void GroupCommand::collectShapes(QSet<AbstractShape*> *shapes) const
+{
+    for (AbstractShape *shape : m_shapesToGroup) {
+        shapes->insert(shape);
+    }
+    shapes->insert(m_groupShape);
 }
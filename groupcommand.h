@@ -5,19 +5,20 @@
 #include <QList>
 
 class AbstractShape;
-class ArtboardView;
+class ArtboardDocument;
 
 class GroupCommand : public AbstractCommand
 {
 public:
-    GroupCommand(const QList<AbstractShape*> &shapesToGroup, ArtboardView *view);
+    GroupCommand(const QList<AbstractShape*> &shapesToGroup, ArtboardDocument *document);
     ~GroupCommand() override;
 
     void execute() override;
     void undo() override;
+    void collectShapes(QSet<AbstractShape*> *shapes) const override;
 
 private:
-    ArtboardView *m_view;
+    ArtboardDocument *m_document;
     QList<AbstractShape*> m_shapesToGroup; // 用于撤销时恢复
     // Qt 6.5及以上可以使用QList<qsizetype>，否则用QList<int>
     QList<int> m_originalIndices; // 保存原始索引以正确撤销
@@ -8,6 +8,19 @@ GroupShape::GroupShape(const QList<AbstractShape*> &children)
 {
 }
 
+GroupShape::GroupShape(const GroupShape &other)
+    : AbstractShape(other)
+{
+    for (AbstractShape *child : other.m_children) {
+        m_children.append(child->clone());
+    }
+}
+
+AbstractShape *GroupShape::clone() const
+{
+    return new GroupShape(*this);
+}
+
 // 析构函数负责释放所有子图形的内存
 GroupShape::~GroupShape()
 {
@@ -36,6 +49,16 @@ QRect GroupShape::getBoundingRect() const
     return totalRect;
 }
 
+// 重绘区域：组本身没有线宽，取所有子图形重绘区域的并集
+QRect GroupShape::getDamageRect() const
+{
+    QRect totalRect;
+    for (AbstractShape* child : m_children) {
+        totalRect = totalRect.united(child->getDamageRect());
+    }
+    return totalRect;
+}
+
 // 点击判断：只要点中了任何一个子图形，就视为点中了组
 bool GroupShape::containsPoint(const QPoint &point) const
 {
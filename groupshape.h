@@ -8,11 +8,16 @@ class GroupShape : public AbstractShape
 {
 public:
     explicit GroupShape(const QList<AbstractShape*> &children);
+    /// @brief 深复制：子图形也逐个复制，副本与原编组不共享任何子图形。
+    GroupShape(const GroupShape &other);
+    GroupShape &operator=(const GroupShape &) = delete;
     ~GroupShape() override;
 
     // 重写基类的所有纯虚函数
+    AbstractShape *clone() const override;
     void draw(QPainter *painter) override;
     QRect getBoundingRect() const override;
+    QRect getDamageRect() const override;
     bool containsPoint(const QPoint &point) const override;
     void moveBy(const QPoint &offset) override;
     void setRotationAngle(qreal angle) override;
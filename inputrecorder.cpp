@@ -0,0 +1,138 @@
+#include "inputrecorder.h"
+#include <QAction>
+#include <QColor>
+#include <QDebug>
+#include <QJsonDocument>
+#include <QMouseEvent>
+#include <QResizeEvent>
+#include <QWidget>
+
+const char *InputRecorder::FormatName = "fishplate-input";
+
+InputRecorder::InputRecorder(QWidget *canvas, QObject *parent)
+    : QObject(parent),
+    m_canvas(canvas)
+{
+}
+
+InputRecorder::~InputRecorder()
+{
+    stop();
+}
+
+bool InputRecorder::start(const QString &filePath)
+{
+    stop();
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Error: cannot create input recording" << filePath << m_file.errorString();
+        return false;
+    }
+    QJsonObject header;
+    header["format"] = FormatName;
+    header["version"] = FormatVersion;
+    m_file.write(QJsonDocument(header).toJson(QJsonDocument::Compact) + '\n');
+
+    m_clock.start();
+    QJsonObject resize;
+    resize["type"] = "resize";
+    resize["width"] = m_canvas->width();
+    resize["height"] = m_canvas->height();
+    write(resize, true);
+    m_canvas->installEventFilter(this);
+    return true;
+}
+
+void InputRecorder::stop()
+{
+    if (!m_file.isOpen()) {
+        return;
+    }
+    m_canvas->removeEventFilter(this);
+    m_file.close();
+}
+
+void InputRecorder::recordAction(const QAction *action)
+{
+    if (!action || action->objectName().isEmpty()) {
+        return;
+    }
+    QJsonObject record;
+    record["type"] = "action";
+    record["name"] = action->objectName();
+    write(record, true);
+}
+
+void InputRecorder::recordColor(const QColor &color)
+{
+    QJsonObject record;
+    record["type"] = "color";
+    record["color"] = color.name(QColor::HexArgb);
+    write(record, true);
+}
+
+void InputRecorder::recordFillColor(const QColor &color)
+{
+    QJsonObject record;
+    record["type"] = "fill_color";
+    record["color"] = color.name(QColor::HexArgb);
+    write(record, true);
+}
+
+void InputRecorder::recordPenWidth(int width)
+{
+    QJsonObject record;
+    record["type"] = "pen";
+    record["width"] = width;
+    write(record, true);
+}
+
+// 只观察，不拦截：事件照常交给画布处理
+bool InputRecorder::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched != m_canvas) {
+        return QObject::eventFilter(watched, event);
+    }
+    switch (event->type()) {
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseMove:
+    case QEvent::MouseButtonRelease: {
+        const QMouseEvent *mouseEvent = static_cast<QMouseEvent*>(event);
+        QJsonObject record;
+        record["type"] = event->type() == QEvent::MouseButtonPress ? "press"
+                         : event->type() == QEvent::MouseMove ? "move" : "release";
+        record["x"] = mouseEvent->position().x();
+        record["y"] = mouseEvent->position().y();
+        record["button"] = int(mouseEvent->button());
+        record["buttons"] = int(mouseEvent->buttons());
+        record["modifiers"] = int(mouseEvent->modifiers());
+        // 拖动中的移动事件很多，只在一次操作结束时写到磁盘
+        write(record, event->type() == QEvent::MouseButtonRelease);
+        break;
+    }
+    case QEvent::Resize: {
+        const QSize size = static_cast<QResizeEvent*>(event)->size();
+        QJsonObject record;
+        record["type"] = "resize";
+        record["width"] = size.width();
+        record["height"] = size.height();
+        write(record, false);
+        break;
+    }
+    default:
+        break;
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+void InputRecorder::write(QJsonObject record, bool flush)
+{
+    if (!m_file.isOpen()) {
+        return;
+    }
+    record["t"] = m_clock.nsecsElapsed() / 1000;
+    m_file.write(QJsonDocument(record).toJson(QJsonDocument::Compact) + '\n');
+    if (flush) {
+        m_file.flush();
+    }
+}
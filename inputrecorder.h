@@ -0,0 +1,65 @@
+#ifndef INPUTRECORDER_H
+#define INPUTRECORDER_H
+
+// ---------------------------------------------------------------------------
+// 描述: 定义了输入录制器 InputRecorder。
+//       把画布上的鼠标事件、画布尺寸变化，以及主窗口中的工具切换、颜色和线宽修改
+//       按发生时间写入录制文件，之后可以用 InputReplayer 在没有显示器的环境中重放，
+//       测量真实操作路径上每个事件的处理和绘制耗时。
+//
+//       录制文件每行一个 JSON 对象。第一行是文件头：
+//           {"format":"fishplate-input","version":1}
+//       之后每行一个事件，t 为从开始录制起的微秒数：
+//           {"t":..,"type":"press"|"move"|"release","x":..,"y":..,"button":..,"buttons":..,"modifiers":..}
+//           {"t":..,"type":"resize","width":..,"height":..}
+//           {"t":..,"type":"action","name":"<QAction 的 objectName>"}
+//           {"t":..,"type":"color"|"fill_color","color":"#aarrggbb"}
+//           {"t":..,"type":"pen","width":..}
+//       事件随发生随写入，程序意外退出时已经录下的部分仍然可用。
+// ---------------------------------------------------------------------------
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonObject>
+
+class QAction;
+class QColor;
+class QWidget;
+
+class InputRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const char *FormatName;
+    static const int FormatVersion = 1;
+
+    /// @brief 录制 canvas 上的鼠标事件。canvas 在录制期间必须一直存在。
+    explicit InputRecorder(QWidget *canvas, QObject *parent = nullptr);
+    ~InputRecorder() override;
+
+    /// @brief 创建录制文件并开始录制，首先记录画布当前的尺寸。
+    /// @return 文件无法创建时返回 false。
+    bool start(const QString &filePath);
+    /// @brief 停止录制并关闭文件。
+    void stop();
+    bool isRecording() const { return m_file.isOpen(); }
+
+    void recordAction(const QAction *action);
+    void recordColor(const QColor &color);
+    void recordFillColor(const QColor &color);
+    void recordPenWidth(int width);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    void write(QJsonObject record, bool flush);
+
+    QWidget *m_canvas;
+    QFile m_file;
+    QElapsedTimer m_clock;
+};
+
+#endif // INPUTRECORDER_H
@@ -0,0 +1,140 @@
+#include "inputreplayer.h"
+#include "artboardview.h"
+#include "inputrecorder.h"
+#include <QAction>
+#include <QColor>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QJsonDocument>
+#include <QMouseEvent>
+#include <QTimer>
+#include <QWidget>
+
+bool InputReplayer::load(const QString &filePath)
+{
+    m_events.clear();
+    m_error.clear();
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        m_error = file.errorString();
+        return false;
+    }
+
+    const QJsonObject header = QJsonDocument::fromJson(file.readLine()).object();
+    if (header.value("format").toString() != InputRecorder::FormatName) {
+        m_error = QString("not an input recording");
+        return false;
+    }
+    if (header.value("version").toInt() > InputRecorder::FormatVersion) {
+        m_error = QString("unsupported recording version %1").arg(header.value("version").toInt());
+        return false;
+    }
+
+    int lineNumber = 1;
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine().trimmed();
+        ++lineNumber;
+        if (line.isEmpty()) {
+            continue;
+        }
+        QJsonParseError parseError;
+        const QJsonDocument document = QJsonDocument::fromJson(line, &parseError);
+        if (!document.isObject()) {
+            // 录制程序意外退出时最后一行可能不完整，之前的事件仍然可以重放
+            if (file.atEnd()) {
+                qWarning() << "Error: ignoring truncated last line" << lineNumber << "of" << filePath;
+                break;
+            }
+            m_error = QString("line %1: %2").arg(lineNumber).arg(parseError.errorString());
+            m_events.clear();
+            return false;
+        }
+        m_events.append(document.object());
+    }
+    return true;
+}
+
+QVector<InputReplayer::Timing> InputReplayer::replay(QWidget *window, ArtboardView *canvas, Pace pace)
+{
+    QVector<Timing> timings;
+    timings.reserve(m_events.size());
+    QElapsedTimer clock;
+    clock.start();
+
+    for (int i = 0; i < m_events.size(); ++i) {
+        const QJsonObject &event = m_events.at(i);
+        Timing timing;
+        timing.index = i;
+        timing.type = event.value("type").toString();
+        timing.timestampUs = event.value("t").toInteger();
+
+        if (pace == Pace::Recorded) {
+            // 等待期间照常运行事件循环，定时器、后台加载和缓存清理与交互时一样得到执行
+            const qint64 remainingMs = (timing.timestampUs - clock.nsecsElapsed() / 1000) / 1000;
+            if (remainingMs > 0) {
+                QEventLoop loop;
+                QTimer::singleShot(int(remainingMs), Qt::PreciseTimer, &loop, &QEventLoop::quit);
+                loop.exec();
+            }
+        }
+
+        timing.handleUs = dispatch(event, window, canvas);
+
+        // 部件的重绘请求都投递给顶层窗口，在这里立即完成，计入这个事件的绘制耗时
+        QElapsedTimer paintClock;
+        paintClock.start();
+        QCoreApplication::sendPostedEvents(window, QEvent::UpdateRequest);
+        timing.paintUs = paintClock.nsecsElapsed() / 1000;
+
+        if (pace == Pace::AsFastAsPossible) {
+            // 不等待，但仍要处理其他已投递的事件（布局、后台结果），否则它们会一直积压
+            QCoreApplication::processEvents();
+        }
+        timings.append(timing);
+    }
+    return timings;
+}
+
+qint64 InputReplayer::dispatch(const QJsonObject &event, QWidget *window, ArtboardView *canvas)
+{
+    const QString type = event.value("type").toString();
+    QElapsedTimer clock;
+    clock.start();
+
+    if (type == "press" || type == "move" || type == "release") {
+        const QEvent::Type eventType = type == "press" ? QEvent::MouseButtonPress
+                                       : type == "move" ? QEvent::MouseMove : QEvent::MouseButtonRelease;
+        const QPointF position(event.value("x").toDouble(), event.value("y").toDouble());
+        QMouseEvent mouseEvent(eventType, position, canvas->mapToGlobal(position),
+                               Qt::MouseButton(event.value("button").toInt()),
+                               Qt::MouseButtons(event.value("buttons").toInt()),
+                               Qt::KeyboardModifiers(event.value("modifiers").toInt()));
+        clock.restart();
+        QCoreApplication::sendEvent(canvas, &mouseEvent);
+    } else if (type == "resize") {
+        // 录下的是画布的尺寸，窗口按差值缩放，布局完成后画布即为录制时的大小
+        const QSize target(event.value("width").toInt(), event.value("height").toInt());
+        window->resize(window->size() + target - canvas->size());
+        QCoreApplication::processEvents();
+    } else if (type == "action") {
+        QAction *action = window->findChild<QAction*>(event.value("name").toString());
+        if (!action) {
+            qWarning() << "Error: replay cannot find action" << event.value("name").toString();
+            return 0;
+        }
+        action->trigger();
+    } else if (type == "color") {
+        canvas->setCurrentDrawingColor(QColor(event.value("color").toString()));
+    } else if (type == "fill_color") {
+        canvas->setCurrentDrawingFillColor(QColor(event.value("color").toString()));
+    } else if (type == "pen") {
+        canvas->setCurrentPenWidth(event.value("width").toInt());
+    } else {
+        qWarning() << "Error: replay skips unknown event type" << type;
+        return 0;
+    }
+    return clock.nsecsElapsed() / 1000;
+}
@@ -0,0 +1,53 @@
+#ifndef INPUTREPLAYER_H
+#define INPUTREPLAYER_H
+
+// ---------------------------------------------------------------------------
+// 描述: 定义了输入回放器 InputReplayer，重放 InputRecorder 录制的文件（格式见 inputrecorder.h）。
+//       鼠标事件直接发送给画布，工具切换和编辑命令通过触发主窗口中同名的 QAction 完成，
+//       走的都是交互时的同一条路径；颜色和线宽（录制时来自对话框和滑块）直接设置到画布。
+//       每个事件分别测量处理耗时（事件处理函数）和绘制耗时（随后立即完成的那次重绘）。
+// ---------------------------------------------------------------------------
+
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+
+class ArtboardView;
+class QWidget;
+
+class InputReplayer
+{
+public:
+    enum class Pace {
+        AsFastAsPossible, ///< 事件之间不等待，测量纯处理能力。
+        Recorded          ///< 按录制时的时间间隔发送，期间照常处理定时器和后台结果。
+    };
+
+    /// @brief 一个事件的测量结果。
+    struct Timing {
+        int index = 0;
+        QString type;
+        qint64 timestampUs = 0; ///< 录制时的时间戳。
+        qint64 handleUs = 0;    ///< 事件处理（鼠标处理函数、动作的槽函数）的耗时。
+        qint64 paintUs = 0;     ///< 事件之后立即进行的重绘的耗时；事件没有引起重绘时接近 0。
+    };
+
+    /// @brief 读取录制文件。
+    /// @return 文件不存在或格式不符时返回 false，原因见 errorString()。
+    bool load(const QString &filePath);
+    int eventCount() const { return m_events.size(); }
+    QString errorString() const { return m_error; }
+
+    /// @brief 在 window 中重放全部事件。canvas 是接收鼠标事件的画布，window 中应当有录制时的 QAction。
+    /// 调用前 window 应当已经显示（offscreen 平台即可）。
+    QVector<Timing> replay(QWidget *window, ArtboardView *canvas, Pace pace);
+
+private:
+    /// 执行一个事件，返回处理耗时（微秒）。
+    qint64 dispatch(const QJsonObject &event, QWidget *window, ArtboardView *canvas);
+
+    QVector<QJsonObject> m_events;
+    QString m_error;
+};
+
+#endif // INPUTREPLAYER_H
@@ -5,8 +5,7 @@
 
 #include "lineshape.h"
 #include <QPainter>            // draw 方法需要 QPainter
-#include <QPainterPath>        // containsPoint 方法使用 QPainterPath
-#include <QPainterPathStroker> // containsPoint 方法使用 QPainterPathStroker
+#include "geometrykernels.h"   // containsPoint 方法使用点到线段的距离
 #include <QPen>                // draw 方法使用 QPen
 #include <QJsonArray>
 #include <QJsonObject>
@@ -27,6 +26,11 @@ LineShape::LineShape(const QPoint &start, const QPoint &end,
     // qDebug() << "LineShape object created. Start:" << p1_start << "End:" << p2_end;
 }
 
+AbstractShape *LineShape::clone() const
+{
+    return new LineShape(*this);
+}
+
 
 void LineShape::draw(QPainter *painter)
 {
@@ -69,20 +73,10 @@ QRect LineShape::getBoundingRect() const
 
 bool LineShape::containsPoint(const QPoint &point) const
 {
-    QTransform t;
-    QPointF center = (p1_start.toPointF() + p2_end.toPointF()) / 2.0;
-    t.translate(center.x(), center.y());
-    t.rotate(m_rotationAngle);
-    t.translate(-center.x(), -center.y());
-
-    QPointF unrotatedPoint = t.inverted().map(QPointF(point));
-
-    QPainterPath path;
-    path.moveTo(p1_start);
-    path.lineTo(p2_end);
-    QPainterPathStroker stroker;
-    stroker.setWidth(this->getPenWidth() + 4.0);
-    return stroker.createStroke(path).contains(unrotatedPoint);
+    // 逆变换是缓存的；在未旋转的坐标系中直接比较点到线段的距离
+    QPointF unrotatedPoint = inverseRotation().map(QPointF(point));
+    const qreal radius = hitRadius();
+    return GeometryKernels::distanceToSegmentSquared(unrotatedPoint, p1_start, p2_end) <= radius * radius;
 }
 
 // LineShape 类的 moveBy 方法实现
@@ -91,6 +85,7 @@ void LineShape::moveBy(const QPoint &offset)
 {
     p1_start += offset; // 起点坐标加上偏移量
     p2_end += offset;   // 终点坐标加上偏移量
+    invalidateCaches();
 }
 
 // LineShape 类的 updateShape 方法实现
@@ -99,6 +94,7 @@ void LineShape::moveBy(const QPoint &offset)
 void LineShape::updateShape(const QPoint &point)
 {
     p2_end = point; // 将直线的结束点更新为当前鼠标位置
+    invalidateCaches();
 }
 
 
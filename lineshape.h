@@ -32,6 +32,8 @@ public:
 
     // --- 从 AbstractShape 继承并重写的虚函数 ---
 
+    AbstractShape *clone() const override;
+
     /// @brief 重写基类的 draw 方法，使用 QPainter 绘制直线。
     /// @param painter 指向 QPainter 对象的指针。
     void draw(QPainter *painter) override;
@@ -68,11 +70,11 @@ public:
 
     /// @brief 设置直线的起始点。
     /// @param point 新的起始点。
-    void setStartPoint(const QPoint &point) { p1_start = point; }
+    void setStartPoint(const QPoint &point) { p1_start = point; invalidateCaches(); }
 
     /// @brief 设置直线的结束点。
     /// @param point 新的结束点。
-    void setEndPoint(const QPoint &point) { p2_end = point; }
+    void setEndPoint(const QPoint &point) { p2_end = point; invalidateCaches(); }
 
     QJsonObject toJsonObject() const override;
 
@@ -2,12 +2,105 @@
 // 描述: Qt 应用程序的主入口点。
 //       负责创建 QApplication 实例和主窗口 MainWindow 实例，
 //       并启动 Qt 的事件循环。
+//
+//       性能测试用的命令行选项：
+//           --record <文件>    把这次会话中的画布操作录制到文件（见 inputrecorder.h）
+//           --replay <文件>    在 offscreen 平台上重放录制文件，输出每个事件的处理和绘制耗时后退出
+//           --pace fast|recorded   重放速度：不等待（默认）或按录制时的时间间隔
+//           --report <文件>    把每个事件的耗时写到文件而不是标准输出
+//       重放结束时按事件类型把汇总（次数、平均值、p50、p95、最大值，单位微秒）写到标准错误。
+//       重放成功时返回 0，录制文件无法读取时返回 1，参数错误时返回 2。
 // ---------------------------------------------------------------------------
 
 /// @note 这部分是Qt自己生成的代码，大部分情况无需改动。
 
 #include "mainwindow.h"   // 包含主窗口类的头文件
+#include "inputreplayer.h"
 #include <QApplication>    // 包含 QApplication 类的头文件，它是所有 Qt GUI 应用程序的基础
+#include <QCommandLineParser>
+#include <QFile>
+#include <QMap>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+// 一行汇总：次数、平均值、p50、p95、最大值
+void writeSummaryRow(const QString &type, const char *phase, QVector<qint64> values)
+{
+    std::sort(values.begin(), values.end());
+    qint64 sum = 0;
+    for (qint64 value : values) {
+        sum += value;
+    }
+    const int count = values.size();
+    fprintf(stderr, "%-12s %-6s %7d %9lld %9lld %9lld %9lld\n", qPrintable(type), phase, count, sum / count,
+            values.at(count / 2), values.at(qMin(count - 1, count * 95 / 100)), values.last());
+}
+
+void writeSummary(const QVector<InputReplayer::Timing> &timings)
+{
+    QMap<QString, QVector<qint64>> handle;
+    QMap<QString, QVector<qint64>> paint;
+    for (const InputReplayer::Timing &timing : timings) {
+        handle[timing.type].append(timing.handleUs);
+        paint[timing.type].append(timing.paintUs);
+    }
+    fprintf(stderr, "%-12s %-6s %7s %9s %9s %9s %9s\n", "type", "phase", "count", "mean_us", "p50_us", "p95_us", "max_us");
+    for (auto it = handle.cbegin(); it != handle.cend(); ++it) {
+        writeSummaryRow(it.key(), "handle", it.value());
+        writeSummaryRow(it.key(), "paint", paint.value(it.key()));
+    }
+}
+
+// 重放录制文件，返回进程的退出码
+int replay(const QString &recordingPath, InputReplayer::Pace pace, const QString &reportPath)
+{
+    InputReplayer replayer;
+    if (!replayer.load(recordingPath)) {
+        fprintf(stderr, "FishplateArtboard: cannot replay '%s': %s\n", qPrintable(recordingPath),
+                qPrintable(replayer.errorString()));
+        return 1;
+    }
+
+    // 命令日志照常写入（计入命令的耗时），但写到临时目录，不碰用户的恢复日志
+    QTemporaryDir journalDir;
+    MainWindow window;
+    if (journalDir.isValid()) {
+        window.setRecoveryJournalPath(journalDir.filePath("replay.fpa-journal"));
+    }
+    window.show();
+    QCoreApplication::processEvents();
+
+    const QVector<InputReplayer::Timing> timings = replayer.replay(&window, window.artboardView(), pace);
+
+    QFile reportFile;
+    if (reportPath.isEmpty()) {
+        reportFile.open(stdout, QIODevice::WriteOnly);
+    } else {
+        reportFile.setFileName(reportPath);
+        if (!reportFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            fprintf(stderr, "FishplateArtboard: cannot create '%s'\n", qPrintable(reportPath));
+            return 1;
+        }
+    }
+    QTextStream report(&reportFile);
+    report << "index\ttype\tt_us\thandle_us\tpaint_us\n";
+    for (const InputReplayer::Timing &timing : timings) {
+        report << timing.index << '\t' << timing.type << '\t' << timing.timestampUs << '\t'
+               << timing.handleUs << '\t' << timing.paintUs << '\n';
+    }
+    report.flush();
+
+    if (!timings.isEmpty()) {
+        writeSummary(timings);
+    }
+    return 0;
+}
+
+}
 
 /// @brief 应用程序的主函数 (main function)。
 /// 这是 C++ 程序的入口点。对于 Qt 应用程序，它通常执行以下操作：
@@ -22,11 +115,42 @@
 /// @return 应用程序的退出状态码。0 表示成功退出。
 int main(int argc, char *argv[])
 {
+    // 重放不连接任何显示服务器。平台必须在创建 QApplication 之前确定，所以这里直接检查参数
+    for (int i = 1; i < argc; ++i) {
+        if (qstrcmp(argv[i], "--replay") == 0 && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+    }
+
     // 1. 创建 QApplication 对象。每个 Qt GUI 应用程序都需要一个 QApplication 对象。
     QApplication a(argc, argv);
 
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    const QCommandLineOption recordOption("record", "Record canvas input of this session into <file>.", "file");
+    const QCommandLineOption replayOption("replay", "Replay <file> offscreen and print per-event timings.", "file");
+    const QCommandLineOption paceOption("pace", "Replay pace: fast or recorded (default fast).", "pace", "fast");
+    const QCommandLineOption reportOption("report", "Write the per-event timings into <file> instead of stdout.", "file");
+    parser.addOptions({ recordOption, replayOption, paceOption, reportOption });
+    parser.process(a);
+
+    if (parser.isSet(replayOption)) {
+        const QString pace = parser.value(paceOption);
+        if (pace != "fast" && pace != "recorded") {
+            fprintf(stderr, "FishplateArtboard: invalid pace '%s'\n", qPrintable(pace));
+            return 2;
+        }
+        return replay(parser.value(replayOption),
+                      pace == "fast" ? InputReplayer::Pace::AsFastAsPossible : InputReplayer::Pace::Recorded,
+                      parser.value(reportOption));
+    }
+
     // 2. 创建主窗口对象 MainWindow 的实例。
     MainWindow w;
+    if (parser.isSet(recordOption) && !w.startInputRecording(parser.value(recordOption))) {
+        fprintf(stderr, "FishplateArtboard: cannot record into '%s'\n", qPrintable(parser.value(recordOption)));
+        return 2;
+    }
 
     // 3. 显示主窗口。
     //    调用 show() 会使窗口变为可见状态，并开始接收事件。
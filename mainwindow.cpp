@@ -10,6 +10,12 @@
 #include <QMessageBox>       // 用于向用户显示提示或警告信息对话框
 #include <QIcon>             // 用于我的程序的左上角的图标
 #include <QPalette>
+#include <QProgressBar>
+#include <QStatusBar>
+#include <QToolButton>
+#include <QStandardPaths>
+#include <QDir>
+#include <QTimer>
 
 #include <QInputDialog>          // <--- 新增，用于弹出输入框
 #include <QNetworkAccessManager> // <--- 新增，网络访问管理器
@@ -23,9 +29,11 @@
 
 #include "artboardview.h"    // 确保包含了 ArtboardView 的完整定义
 #include "clearallcommand.h" // 包含了清空画布命令的定义
+#include "fpadatabase.h"
 #include "abstractshape.h"
 #include "groupshape.h"
 #include "groupcommand.h"
+#include "inputrecorder.h"
 #include "ungroupcommand.h"
 
 
@@ -55,7 +63,8 @@
 /// @param parent 指向父 QWidget 对象的指针，对于主窗口通常为 nullptr。
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent),      // 调用基类 QMainWindow 的构造函数
-    ui(new Ui::MainWindow)  // 创建并初始化 Ui::MainWindow 对象 (管理 Designer UI 元素)
+    ui(new Ui::MainWindow),  // 创建并初始化 Ui::MainWindow 对象 (管理 Designer UI 元素)
+    m_inputRecorder(nullptr)
 {
     // 1. 加载和设置由 Qt Designer 设计的UI。
     //    这行代码必须在构造函数的最前面，因为它会实例化 ui 指针所指向的对象，
@@ -163,17 +172,40 @@ MainWindow::MainWindow(QWidget *parent)
         qWarning() << "MainWindow Constructor: UI file might be missing 'sliderPenWidth' or 'labelCurrentPenWidth', or myArtboardView is null.";
     }
 
-    // 9. 连接 ArtboardView 发射的信号到 MainWindow 的槽函数，用于动态更新撤销/重做按钮的启用状态。
+    // 9. 连接 ArtboardDocument 发射的信号到 MainWindow 的槽函数，用于动态更新撤销/重做按钮的启用状态。
     //     这些是跨对象的连接，必须手动进行。
     if (myArtboardView) {
-        connect(myArtboardView, &ArtboardView::undoAvailabilityChanged,
+        connect(myArtboardView->document(), &ArtboardDocument::undoAvailabilityChanged,
                 this, &MainWindow::updateUndoActionState);
-        connect(myArtboardView, &ArtboardView::redoAvailabilityChanged,
+        connect(myArtboardView->document(), &ArtboardDocument::redoAvailabilityChanged,
                 this, &MainWindow::updateRedoActionState);
-    }
+        connect(myArtboardView->document(), &ArtboardDocument::loadProgress,
+                this, &MainWindow::updateLoadProgress);
+        connect(myArtboardView->document(), &ArtboardDocument::loadFinished,
+                this, &MainWindow::onLoadFinished);
+        connect(myArtboardView->document(), &ArtboardDocument::saveFinished,
+                this, &MainWindow::onSaveFinished);
+        connect(myArtboardView->document(), &ArtboardDocument::journalReplayed,
+                this, &MainWindow::onJournalReplayed);
+    }
+
+    // 后台载入工程时在状态栏显示进度条和取消按钮，载入期间画布仍然可以操作
+    m_loadProgressBar = new QProgressBar(this);
+    m_loadProgressBar->setMaximumWidth(200);
+    m_loadProgressBar->setVisible(false);
+    m_cancelLoadButton = new QToolButton(this);
+    m_cancelLoadButton->setText(tr("取消载入"));
+    m_cancelLoadButton->setVisible(false);
+    statusBar()->addPermanentWidget(m_loadProgressBar);
+    statusBar()->addPermanentWidget(m_cancelLoadButton);
+    connect(m_cancelLoadButton, &QToolButton::clicked, this, [this]() {
+        myArtboardView->document()->cancelLoading();
+        setLoadIndicatorVisible(false);
+        statusBar()->showMessage(tr("已取消载入，保留已载入的部分。"), 5000);
+    });
 
     // 10. 显式设置撤销 (Undo) 和重做 (Redo) QAction 按钮的初始禁用状态。
-    //     虽然 ArtboardView 在构造时会发射信号将它们设为禁用，但在这里再次设置可以作为双保险，
+    //     虽然 ArtboardDocument 在构造时会发射信号将它们设为禁用，但在这里再次设置可以作为双保险，
     //     确保在界面完全显示前，它们就是禁用的。
     //     前提是这些 QAction (objectName: actionUndo, actionRedo) 在 Designer 中已创建。
     if (ui->actionUndo) {
@@ -185,6 +217,8 @@ MainWindow::MainWindow(QWidget *parent)
 
     setupAdaptiveIcons();
 
+    // 窗口显示之后再检查上次是否有未保存的画布需要恢复
+    QTimer::singleShot(0, this, &MainWindow::setupRecoveryJournal);
 }
 
 /// @brief MainWindow 类的析构函数。
@@ -193,6 +227,10 @@ MainWindow::MainWindow(QWidget *parent)
 /// 因此，这里主要需要显式 delete 的是由 `new Ui::MainWindow` 创建的 ui 对象。
 MainWindow::~MainWindow()
 {
+    // 录制器停止时要从画布上移除事件过滤器，必须在画布随子对象一起销毁之前删除
+    delete m_inputRecorder;
+    m_inputRecorder = nullptr;
+
     delete ui;    // 释放由 Qt Designer 生成的 UI 类实例所占用的内存
     ui = nullptr; // 防止悬空指针
 
@@ -258,6 +296,15 @@ void MainWindow::on_actionDrawFreehand_triggered()
     }
 }
 
+/// @brief 响应“平滑曲线”QAction (ui->actionFitCurves) 勾选状态改变的槽函数。
+/// 拟合会丢弃原始采样点，并且含有曲线的工程旧版本无法打开，因此默认关闭，由用户选择开启。
+void MainWindow::on_actionFitCurves_toggled(bool checked)
+{
+    if (myArtboardView) {
+        myArtboardView->setCurveFittingTolerance(checked ? ArtboardView::DefaultCurveFittingTolerance : 0.0);
+    }
+}
+
 /// @brief 响应“椭圆工具”QAction (ui->actionDrawEllipse) 被触发的槽函数。
 /// 将 ArtboardView 的当前绘图模式设置为 ShapeType::Ellipse。
 void MainWindow::on_actionDrawEllipse_triggered()
@@ -318,6 +365,9 @@ void MainWindow::on_actionChangeColor_triggered()
             // 调用 ArtboardView 的方法来设置新的当前边框颜色。
             myArtboardView->setCurrentDrawingColor(selectedBorderColor);
         }
+        if (m_inputRecorder) {
+            m_inputRecorder->recordColor(selectedBorderColor);
+        }
         qDebug() << "MainWindow: Border color selected -" << selectedBorderColor.name();
         /// @note 可以在这里更新UI上某个地方（比如一个色块）来显示新选中的边框颜色，也是可优化的一点。
     }
@@ -355,6 +405,9 @@ void MainWindow::on_actionChangeFillColor_triggered()
             // 调用 ArtboardView 的方法来设置新的当前填充颜色。
             myArtboardView->setCurrentDrawingFillColor(selectedFillColor);
         }
+        if (m_inputRecorder) {
+            m_inputRecorder->recordFillColor(selectedFillColor);
+        }
         qDebug() << "MainWindow: Fill color selected -" << selectedFillColor.name();
         /// @note 可以在这里更新UI上某个地方（比如一个色块）来显示新选中的边框颜色，也是可优化的一点。
     }
@@ -383,6 +436,9 @@ void MainWindow::on_sliderPenWidth_valueChanged(int value)
     if (ui->labelCurrentPenWidth) {
         ui->labelCurrentPenWidth->setText(QString("线宽: %1").arg(value));
     }
+    if (m_inputRecorder) {
+        m_inputRecorder->recordPenWidth(value);
+    }
 }
 
 /// @brief 响应“点击式笔画橡皮擦”QAction (ui->actionStrokeEraser) 被触发的槽函数。
@@ -452,15 +508,15 @@ void MainWindow::on_actionNormalEraser_triggered()
 
 /// @brief 响应“撤销”QAction (ui->actionUndo) 被触发的槽函数。
 /// 当用户点击“撤销”按钮或使用快捷键 (如 Ctrl+Z) 时，此函数被调用。
-/// 它会调用 ArtboardView 的 undo() 方法来执行实际的撤销操作。
+/// 它会调用 ArtboardDocument 的 undo() 方法来执行实际的撤销操作。
 /// @note 此槽函数依赖 Qt 的 MOC 自动连接机制。
 ///       前提是 ui->actionUndo 在 Designer 中的 objectName 为 "actionUndo"。
 void MainWindow::on_actionUndo_triggered()
 {
     if (myArtboardView) { // 确保 ArtboardView 实例有效
-        myArtboardView->undo(); // 调用 ArtboardView 的撤销方法
+        myArtboardView->document()->undo(); // 调用 ArtboardDocument 的撤销方法
         qDebug() << "MainWindow: Undo action triggered.";
-        // ArtboardView::undo() 内部会调用 updateUndoRedoStatus()，
+        // ArtboardDocument::undo() 内部会调用 updateUndoRedoStatus()，
         // 后者发射信号，由 MainWindow::updateUndoActionState() 和 updateRedoActionState()
         // 槽函数接收并更新撤销/重做按钮的启用状态。
     }
@@ -468,14 +524,14 @@ void MainWindow::on_actionUndo_triggered()
 
 /// @brief 响应“重做”QAction (ui->actionRedo) 被触发的槽函数。
 /// 当用户点击“重做”按钮或使用快捷键 (如 Ctrl+Y) 时，此函数被调用。
-/// 它会调用 ArtboardView 的 redo() 方法来执行实际的重做操作。
+/// 它会调用 ArtboardDocument 的 redo() 方法来执行实际的重做操作。
 /// @note 此槽函数依赖 Qt 的 MOC 自动连接机制。
 void MainWindow::on_actionRedo_triggered()
 {
     if (myArtboardView) { // 确保 ArtboardView 实例有效
-        myArtboardView->redo(); // 调用 ArtboardView 的重做方法
+        myArtboardView->document()->redo(); // 调用 ArtboardDocument 的重做方法
         qDebug() << "MainWindow: Redo action triggered.";
-        // ArtboardView::redo() 内部会调用 updateUndoRedoStatus() 来更新按钮状态。
+        // ArtboardDocument::redo() 内部会调用 updateUndoRedoStatus() 来更新按钮状态。
     }
 }
 
@@ -483,20 +539,20 @@ void MainWindow::on_actionRedo_triggered()
 ///
 /// 当用户点击“清空画布”按钮时，此函数被调用。它会：
 /// 1. 创建一个 ClearAllCommand 对象，该命令封装了清空画布的操作。
-/// 2. 调用 ArtboardView 的 executeCommand() 方法来执行此命令，
+/// 2. 调用 ArtboardDocument 的 executeCommand() 方法来执行此命令，
 ///    该方法会将命令压入撤销栈并清空重做栈，同时更新UI。
 /// @note 此槽函数依赖 Qt 的 MOC 自动连接机制。
 void MainWindow::on_actionClearCanvas_triggered()
 {
     if (myArtboardView) { // 确保 ArtboardView 实例有效
         qDebug() << "MainWindow: ClearCanvas action triggered.";
-        // 1. 创建一个 ClearAllCommand 实例，将 myArtboardView 作为参数传递，
-        //    以便命令可以操作 ArtboardView 的图形列表和命令栈。
-        ClearAllCommand *clearCmd = new ClearAllCommand(myArtboardView);
-        // 2. 通过 ArtboardView 的 executeCommand 方法执行此命令。
+        // 1. 创建一个 ClearAllCommand 实例，将画布的文档作为参数传递，
+        //    以便命令可以操作文档的图形列表。
+        ClearAllCommand *clearCmd = new ClearAllCommand(myArtboardView->document());
+        // 2. 通过 ArtboardDocument 的 executeCommand 方法执行此命令。
         //    executeCommand 会负责调用 clearCmd->execute()，
         //    将 clearCmd 压入撤销栈，并清空重做栈，同时更新撤销/重做按钮状态。
-        myArtboardView->executeCommand(clearCmd);
+        myArtboardView->document()->executeCommand(clearCmd);
     }
 }
 
@@ -520,19 +576,25 @@ void MainWindow::on_actionOpen_triggered()
     // [ 关键修正 ]
     // 不再检查 selectedFilter，而是直接检查文件名的后缀
     if (filePath.endsWith(".fpa", Qt::CaseInsensitive)) { // Qt::CaseInsensitive 表示不区分大小写
-        // 如果选择的是工程文件，则调用加载数据库的函数
-        if (myArtboardView->loadFromDatabase(filePath)) { //
-            QMessageBox::information(this, tr("加载成功"), tr("已成功加载工程。"));
-        } else {
-            QMessageBox::critical(this, tr("加载失败"), tr("无法从指定文件加载工程。"));
+        // 文件摘要只需查询 meta 表，不兼容的文件在开始载入之前就能拒绝
+        FpaDatabase::DocumentInfo info;
+        if (FpaDatabase::readDocumentInfo(filePath, &info) && !FpaDatabase::isSupportedVersion(info.schemaVersion)) {
+            QMessageBox::warning(this, tr("无法打开"), tr("该工程文件由更新版本的程序保存（格式版本 %1），请升级后再打开。")
+                                                      .arg(info.schemaVersion));
+            return;
         }
+        // 如果选择的是工程文件，则在后台载入，结果由 onLoadFinished 报告
+        m_loadProgressBar->setRange(0, 0); // 总数未知之前显示忙碌状态
+        setLoadIndicatorVisible(true);
+        statusBar()->showMessage(tr("正在载入工程..."));
+        myArtboardView->document()->loadFromDatabaseAsync(filePath);
     }
     else // 否则，我们认为用户选择的是图片文件
     {
         QImage backgroundImageToLoad;
         if (backgroundImageToLoad.load(filePath)) {
             // 如果是图片文件，则调用设置背景图的函数
-            myArtboardView->setBackgroundImage(backgroundImageToLoad); //
+            myArtboardView->document()->setBackgroundImage(backgroundImageToLoad); //
         } else {
             // 如果加载图片也失败了（比如文件损坏），才报这个错
             QMessageBox::warning(this, tr("打开图片失败"), tr("无法加载选定的图像文件。"));
@@ -544,7 +606,7 @@ void MainWindow::on_actionOpen_triggered()
 void MainWindow::on_actionSaveAs_triggered()
 {
     // 定义文件类型过滤器
-    const QString filter = tr("Fishplate工程文件 (*.fpa);;PNG图片 (*.png);;JPEG图片 (*.jpg)");
+    const QString filter = tr("Fishplate工程文件 (*.fpa);;PNG图片 (*.png);;JPEG图片 (*.jpg);;TIFF图片（适合超大尺寸） (*.tif *.tiff)");
 
     // 弹出文件保存对话框
     QString filePath = QFileDialog::getSaveFileName(
@@ -561,18 +623,27 @@ void MainWindow::on_actionSaveAs_triggered()
     // [ 关键修正 ]
     // 同样，我们直接检查最终文件名的后缀
     if (filePath.endsWith(".fpa", Qt::CaseInsensitive)) {
-        // 调用保存到数据库的函数
-        if (!myArtboardView->saveToDatabase(filePath)) { //
-            QMessageBox::critical(this, tr("保存失败"), tr("无法将工程保存到指定文件。"));
+        if (myArtboardView->document()->isLoading()) {
+            QMessageBox::warning(this, tr("无法保存"), tr("工程仍在载入，请等待载入完成或取消载入后再保存。"));
+            return;
+        }
+        // 在后台保存，结果由 onSaveFinished 报告；保存期间可以继续编辑
+        if (myArtboardView->document()->saveToDatabaseAsync(filePath)) {
+            statusBar()->showMessage(tr("正在保存工程..."));
         } else {
-            QMessageBox::information(this, tr("保存成功"), tr("工程已成功保存。"));
+            QMessageBox::critical(this, tr("保存失败"), tr("无法将工程保存到指定文件。"));
         }
     }
     else // 否则，认为是保存为图片
     {
-        // 调用渲染到图片的函数
-        QImage imageToSave = myArtboardView->renderToImage(); //
-        if (imageToSave.save(filePath)) {
+        // 导出倍数：1 为屏幕分辨率，打印时可以取更大的值；输出按条带栅格化，TIFF 不受内存限制
+        bool accepted = false;
+        const double scale = QInputDialog::getDouble(this, tr("导出图片"), tr("导出倍数（相对于屏幕分辨率）："),
+                                                     1.0, 0.1, 100.0, 2, &accepted);
+        if (!accepted) {
+            return;
+        }
+        if (myArtboardView->document()->exportImage(filePath, scale)) {
             QMessageBox::information(this, tr("导出成功"), tr("图像已成功导出。"));
         } else {
             QMessageBox::critical(this, tr("导出失败"), tr("无法将图像保存到指定文件。"));
@@ -580,15 +651,15 @@ void MainWindow::on_actionSaveAs_triggered()
     }
 }
 
-/// @brief 响应来自 ArtboardView 的 undoAvailabilityChanged(bool) 信号的槽函数。
+/// @brief 响应来自 ArtboardDocument 的 undoAvailabilityChanged(bool) 信号的槽函数。
 ///
-/// 当 ArtboardView 中的撤销栈状态发生改变（例如，从空变为非空，或从非空变为空）时，
-/// ArtboardView 会发射 undoAvailabilityChanged 信号，此槽函数随之被调用。
+/// 当 ArtboardDocument 中的撤销栈状态发生改变（例如，从空变为非空，或从非空变为空）时，
+/// ArtboardDocument 会发射 undoAvailabilityChanged 信号，此槽函数随之被调用。
 /// 它根据传入的 `available` 参数来设置“撤销”QAction (ui->actionUndo) 的启用或禁用状态。
 ///
 /// @param available 布尔值，如果为 true，则表示当前有操作可以撤销，撤销按钮应被启用；
 ///                  如果为 false，则表示撤销栈为空，撤销按钮应被禁用。
-/// @note 此槽函数与 ArtboardView 的信号的连接是在 MainWindow 构造函数中手动建立的。
+/// @note 此槽函数与 ArtboardDocument 的信号的连接是在 MainWindow 构造函数中手动建立的。
 void MainWindow::updateUndoActionState(bool available)
 {
     if (ui->actionUndo) { // 确保 Designer 中的 ui->actionUndo 指针有效
@@ -599,15 +670,15 @@ void MainWindow::updateUndoActionState(bool available)
     }
 }
 
-/// @brief 响应来自 ArtboardView 的 redoAvailabilityChanged(bool) 信号的槽函数。
+/// @brief 响应来自 ArtboardDocument 的 redoAvailabilityChanged(bool) 信号的槽函数。
 ///
-/// 当 ArtboardView 中的重做栈状态发生改变时，ArtboardView 会发射 redoAvailabilityChanged 信号，
+/// 当 ArtboardDocument 中的重做栈状态发生改变时，ArtboardDocument 会发射 redoAvailabilityChanged 信号，
 /// 此槽函数随之被调用。它根据传入的 `available` 参数来设置“重做”QAction (ui->actionRedo)
 /// 的启用或禁用状态。
 ///
 /// @param available 布尔值，如果为 true，则表示当前有操作可以重做，重做按钮应被启用；
 ///                  如果为 false，则表示重做栈为空，重做按钮应被禁用。
-/// @note 此槽函数与 ArtboardView 的信号的连接是在 MainWindow 构造函数中手动建立的。
+/// @note 此槽函数与 ArtboardDocument 的信号的连接是在 MainWindow 构造函数中手动建立的。
 void MainWindow::updateRedoActionState(bool available)
 {
     if (ui->actionRedo) { // 确保 Designer 中的 ui->actionRedo 指针有效
@@ -618,16 +689,117 @@ void MainWindow::updateRedoActionState(bool available)
     }
 }
 
+void MainWindow::updateLoadProgress(int loaded, int total)
+{
+    if (total > 0) {
+        m_loadProgressBar->setRange(0, total);
+        m_loadProgressBar->setValue(loaded);
+    }
+    statusBar()->showMessage(tr("正在载入工程... %1 / %2").arg(loaded).arg(total));
+}
+
+void MainWindow::onLoadFinished(bool ok)
+{
+    setLoadIndicatorVisible(false);
+    if (ok) {
+        statusBar()->showMessage(tr("已成功加载工程。"), 5000);
+    } else {
+        statusBar()->clearMessage();
+        QMessageBox::critical(this, tr("加载失败"), tr("无法从指定文件加载工程。"));
+    }
+}
+
+void MainWindow::onSaveFinished(bool ok, const QString &filePath)
+{
+    if (ok) {
+        statusBar()->showMessage(tr("工程已成功保存到 %1。").arg(filePath), 5000);
+    } else {
+        statusBar()->clearMessage();
+        QMessageBox::critical(this, tr("保存失败"), tr("无法将工程保存到指定文件。"));
+    }
+}
+
+void MainWindow::onJournalReplayed(int records)
+{
+    statusBar()->showMessage(tr("已从命令日志恢复 %1 条未保存的修改。").arg(records), 8000);
+}
+
+/// @brief 为尚未保存的画布启用命令日志。上次程序意外退出时留下的日志可以选择恢复。
+/// 已经保存为 .fpa 的工程使用文件旁边的日志，打开文件时自动重放。
+void MainWindow::setRecoveryJournalPath(const QString &path)
+{
+    m_recoveryJournalPath = path;
+}
+
+bool MainWindow::startInputRecording(const QString &filePath)
+{
+    if (m_inputRecorder) {
+        return false;
+    }
+    m_inputRecorder = new InputRecorder(myArtboardView, this);
+    if (!m_inputRecorder->start(filePath)) {
+        delete m_inputRecorder;
+        m_inputRecorder = nullptr;
+        return false;
+    }
+    if (m_recoveryJournalPath.isEmpty()) {
+        m_recoveryJournalPath = filePath + "-journal";
+    }
+
+    // 先录下当前的工具、线宽和颜色，回放时从同样的状态开始
+    m_inputRecorder->recordAction(drawingToolGroup->checkedAction());
+    m_inputRecorder->recordPenWidth(myArtboardView->getCurrentPenWidth());
+    m_inputRecorder->recordColor(myArtboardView->getCurrentDrawingColor());
+    m_inputRecorder->recordFillColor(myArtboardView->getCurrentDrawingFillColor());
+
+    // 只录制改变画布的动作；打开文件、AI 绘图等依赖外部输入的操作无法重放
+    connect(drawingToolGroup, &QActionGroup::triggered, m_inputRecorder, &InputRecorder::recordAction);
+    for (QAction *action : { ui->actionUndo, ui->actionRedo, ui->actionClearCanvas, ui->actionGroup, ui->actionUngroup,
+                              ui->actionFitCurves }) {
+        connect(action, &QAction::triggered, m_inputRecorder, [this, action]() {
+            m_inputRecorder->recordAction(action);
+        });
+    }
+    return true;
+}
+
+void MainWindow::setupRecoveryJournal()
+{
+    if (!m_recoveryJournalPath.isEmpty()) {
+        myArtboardView->document()->setRecoveryJournalPath(m_recoveryJournalPath, false);
+        return;
+    }
+    const QString dirPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    if (dirPath.isEmpty() || !QDir().mkpath(dirPath)) {
+        qWarning() << "MainWindow: No writable location for the recovery journal.";
+        return;
+    }
+    const QString journalPath = QDir(dirPath).filePath("untitled.fpa-journal");
+    bool recover = false;
+    if (CommandJournal::hasRecords(journalPath)) {
+        recover = QMessageBox::question(this, tr("恢复画布"),
+                                        tr("发现上次未保存的画布，是否恢复？"),
+                                        QMessageBox::Yes | QMessageBox::No, QMessageBox::Yes) == QMessageBox::Yes;
+    }
+    myArtboardView->document()->setRecoveryJournalPath(journalPath, recover);
+}
+
+void MainWindow::setLoadIndicatorVisible(bool visible)
+{
+    m_loadProgressBar->setVisible(visible);
+    m_cancelLoadButton->setVisible(visible);
+}
+
 void MainWindow::on_actionGroup_triggered()
 {
     if (!myArtboardView) return;
 
-    const QList<AbstractShape*>& selectedShapes = myArtboardView->getSelectedShapes();
+    const QList<AbstractShape*>& selectedShapes = myArtboardView->document()->selectedShapes();
 
     // 只有当选中了多个图形时，编组才有意义
     if (selectedShapes.count() >= 2) {
-        GroupCommand *command = new GroupCommand(selectedShapes, myArtboardView);
-        myArtboardView->executeCommand(command);
+        GroupCommand *command = new GroupCommand(selectedShapes, myArtboardView->document());
+        myArtboardView->document()->executeCommand(command);
     } else {
         qDebug() << "Grouping requires at least two selected shapes.";
     }
@@ -637,15 +809,15 @@ void MainWindow::on_actionUngroup_triggered()
 {
     if (!myArtboardView) return;
 
-    const QList<AbstractShape*>& selectedShapes = myArtboardView->getSelectedShapes();
+    const QList<AbstractShape*>& selectedShapes = myArtboardView->document()->selectedShapes();
 
     // 只有当恰好选中一个图形，并且这个图形是一个组时，取消编组才有意义
     if (selectedShapes.count() == 1) {
         // 使用 dynamic_cast 来安全地检查选中的图形是否是 GroupShape 类型
         GroupShape *selectedGroup = dynamic_cast<GroupShape*>(selectedShapes.first());
         if (selectedGroup) {
-            UngroupCommand *command = new UngroupCommand(selectedGroup, myArtboardView);
-            myArtboardView->executeCommand(command);
+            UngroupCommand *command = new UngroupCommand(selectedGroup, myArtboardView->document());
+            myArtboardView->document()->executeCommand(command);
         } else {
             qDebug() << "Ungrouping requires a single selected group.";
         }
@@ -832,7 +1004,7 @@ Now, convert the user's following request.
                 }
 
                 if (!newShapes.isEmpty()) {
-                    myArtboardView->executeCommand(new AddMultipleShapesCommand(newShapes, myArtboardView));
+                    myArtboardView->document()->executeCommand(new AddMultipleShapesCommand(newShapes, myArtboardView->document()));
                 }
             } else {
                 QString errorString = reply->errorString();
@@ -14,6 +14,9 @@
 // 向前声明 QActionGroup，因为我们只在成员变量中使用了它的指针类型，
 // 这样可以避免在头文件中包含 <QActionGroup> 的完整定义，减少编译依赖。
 class QActionGroup;
+class InputRecorder;
+class QProgressBar;
+class QToolButton;
 
 // Qt Designer 生成的 UI 类通常放在一个命名空间 Ui 中
 QT_BEGIN_NAMESPACE
@@ -43,6 +46,18 @@ public:
     /// 主要负责释放由 Qt Designer 生成的 ui 对象的内存。
     ~MainWindow();
 
+    ArtboardView *artboardView() const { return myArtboardView; }
+
+    /// @brief 使用指定的命令日志，不使用默认位置的日志，也不询问是否恢复上次未保存的画布。
+    /// 必须在窗口显示之前调用（默认日志在窗口显示之后才打开）。
+    void setRecoveryJournalPath(const QString &path);
+
+    /// @brief 把之后画布上的鼠标操作和工具、颜色、线宽的修改录制到 filePath，供 InputReplayer 重放。
+    /// 回放总是从空白画布开始，所以录制时不恢复上次未保存的画布：除非另外指定，
+    /// 命令日志写到录制文件旁边的 "<录制文件>-journal"。必须在窗口显示之前调用。
+    /// @return 录制文件无法创建时返回 false。
+    bool startInputRecording(const QString &filePath);
+
     // 槽函数通常声明为 private slots 或 public slots。
     // private slots 意味着它们主要由内部信号（如此类自身的UI控件发出的信号）或其他友元类调用。
 private slots:
@@ -59,6 +74,8 @@ private slots:
     void on_actionDrawEllipse_triggered();
     /// @brief 响应“五角星工具”动作 (actionDrawStar) 被触发。
     void on_actionDrawStar_triggered();
+    /// @brief 响应“平滑曲线”动作 (actionFitCurves) 的勾选状态改变，开启或关闭自由曲线的曲线拟合。
+    void on_actionFitCurves_toggled(bool checked);
 
     // --- 橡皮擦工具相关的槽函数 ---
     /// @brief 响应“普通橡皮擦”动作 (actionNormalEraser) 被触发。
@@ -105,6 +122,14 @@ private slots:
     /// @brief 更新“重做”按钮的启用/禁用状态。
     /// @param available 如果为 true，则启用重做按钮；否则禁用。
     void updateRedoActionState(bool available);
+    /// @brief 在状态栏显示后台载入的进度。
+    void updateLoadProgress(int loaded, int total);
+    /// @brief 后台载入结束：隐藏进度条，失败时提示用户。
+    void onLoadFinished(bool ok);
+    /// @brief 后台保存结束：在状态栏显示结果，失败时提示用户。
+    void onSaveFinished(bool ok, const QString &filePath);
+    /// @brief 打开工程时重放了命令日志：在状态栏提示恢复了上次未保存的修改。
+    void onJournalReplayed(int records);
 
 private:
     Ui::MainWindow *ui; ///< 指向由 Qt Designer 自动生成的 UI 类实例的指针。
@@ -116,7 +141,14 @@ private:
     QActionGroup *drawingToolGroup; ///< 用于管理所有绘图工具 QAction 的动作组。
         ///< 设置为互斥 (exclusive)，以确保一次只能选择一个绘图工具。
 
+    QProgressBar *m_loadProgressBar;   ///< 状态栏中的后台载入进度条。
+    QToolButton *m_cancelLoadButton;   ///< 状态栏中的“取消载入”按钮。
+    QString m_recoveryJournalPath;     ///< 非空时代替默认位置的命令日志。
+    InputRecorder *m_inputRecorder;    ///< 正在录制输入时有效，否则为 nullptr。
+
     void setupAdaptiveIcons();
+    void setLoadIndicatorVisible(bool visible);
+    void setupRecoveryJournal();
 };
 
 #endif // MAINWINDOW_H
@@ -1,9 +1,9 @@
 #include "movemultipleshapescommand.h"
 #include "abstractshape.h"
-#include "artboardview.h"
+#include "artboarddocument.h"
 
-MoveMultipleShapesCommand::MoveMultipleShapesCommand(const QList<AbstractShape*> &shapes, const QPoint &offset, ArtboardView *view)
-    : m_shapes(shapes), m_offset(offset), m_view(view)
+MoveMultipleShapesCommand::MoveMultipleShapesCommand(const QList<AbstractShape*> &shapes, const QPoint &offset, ArtboardDocument *document)
+    : m_shapes(shapes), m_offset(offset), m_document(document)
 {
 }
 
@@ -14,10 +14,12 @@ MoveMultipleShapesCommand::~MoveMultipleShapesCommand()
 void MoveMultipleShapesCommand::execute()
 {
     for (AbstractShape* shape : m_shapes) {
+        if (m_document) m_document->updateShapeArea(shape);
         shape->moveBy(m_offset);
-    }
-    if (m_view) {
-        m_view->update();
+        if (m_document) {
+            m_document->updateShapeArea(shape);
+            m_document->markShapeMoved(shape, m_offset);
+        }
     }
 }
 
@@ -25,9 +27,18 @@ void MoveMultipleShapesCommand::undo()
 {
     // 以相反的偏移量移回
     for (AbstractShape* shape : m_shapes) {
+        if (m_document) m_document->updateShapeArea(shape);
         shape->moveBy(-m_offset);
+        if (m_document) {
+            m_document->updateShapeArea(shape);
+            m_document->markShapeMoved(shape, -m_offset);
+        }
     }
-    if (m_view) {
-        m_view->update();
+}
+
+void MoveMultipleShapesCommand::collectShapes(QSet<AbstractShape*> *shapes) const
+{
+    for (AbstractShape *shape : m_shapes) {
+        shapes->insert(shape);
     }
 }
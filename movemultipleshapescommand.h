@@ -6,22 +6,23 @@
 #include <QPoint>
 
 class AbstractShape;
-class ArtboardView;
+class ArtboardDocument;
 
 // 宏命令，用于将多个图形的移动打包成一个单一的可撤销操作
 class MoveMultipleShapesCommand : public AbstractCommand
 {
 public:
-    MoveMultipleShapesCommand(const QList<AbstractShape*> &shapes, const QPoint &offset, ArtboardView *view);
+    MoveMultipleShapesCommand(const QList<AbstractShape*> &shapes, const QPoint &offset, ArtboardDocument *document);
     ~MoveMultipleShapesCommand() override;
 
     void execute() override;
     void undo() override;
+    void collectShapes(QSet<AbstractShape*> *shapes) const override;
 
 private:
     QList<AbstractShape*> m_shapes;
     QPoint m_offset;
-    ArtboardView *m_view;
+    ArtboardDocument *m_document;
 };
 
 #endif // MOVEMULTIPLESHAPESCOMMAND_H
@@ -4,17 +4,17 @@
 // ---------------------------------------------------------------------------
 
 #include "moveshapecommand.h"
-#include "artboardview.h" // 如果需要调用 view->update()
+#include "artboarddocument.h" // 需要调用 document->updateShapeArea()
 #include <QDebug>         // 用于调试输出
 
 /// @brief MoveShapeCommand 构造函数的实现。
 /// @param shapeToMove 指向要移动的 AbstractShape 对象的指针。
 /// @param moveOffset 本次移动的净偏移量。
-/// @param view 指向 ArtboardView 实例的指针。
-MoveShapeCommand::MoveShapeCommand(AbstractShape *shapeToMove, const QPoint &moveOffset, ArtboardView *view)
+/// @param document 指向 ArtboardDocument 实例的指针。
+MoveShapeCommand::MoveShapeCommand(AbstractShape *shapeToMove, const QPoint &moveOffset, ArtboardDocument *document)
     : m_shapeMoved(shapeToMove), // 初始化，存储被移动的图形对象
     m_offset(moveOffset),      // 初始化，存储移动的偏移量
-    m_artboardView(view)       // 初始化，存储 ArtboardView 的指针
+    m_document(document)       // 初始化，存储 ArtboardDocument 的指针
 {
     // qDebug() << "MoveShapeCommand CONSTRUCTOR: For shape" << (void*)m_shapeMoved << "with offset" << m_offset;
 }
@@ -24,7 +24,7 @@ MoveShapeCommand::MoveShapeCommand(AbstractShape *shapeToMove, const QPoint &mov
 /// @brief 执行“移动图形”命令。
 /// 调用被移动图形 (m_shapeMoved) 的 moveBy() 方法，将其按 m_offset 指定的偏移量移动。
 /// 此方法主要用于“重做”操作，或者在标准的“执行命令”流程中（如果图形尚未被移动到最终位置）。
-/// 在我们的 ArtboardView::mouseReleaseEvent 实现中，图形在创建此命令前已被“预先移回”其原始位置，
+/// 在我们的 ArtboardDocument::mouseReleaseEvent 实现中，图形在创建此命令前已被“预先移回”其原始位置，
 /// 因此这里的 execute() 会将其“正确地”移动到用户拖动结束的目标位置。
 void MoveShapeCommand::execute()
 {
@@ -33,10 +33,15 @@ void MoveShapeCommand::execute()
         return;
     }
 
+    if (m_document) { // 旧位置需要重绘
+        m_document->updateShapeArea(m_shapeMoved);
+    }
+
     m_shapeMoved->moveBy(m_offset); // 调用图形自身的 moveBy 方法执行移动
 
-    if (m_artboardView) { // 如果 ArtboardView 指针有效
-        m_artboardView->update(); // 请求视图重绘以显示移动后的图形
+    if (m_document) { // 如果 ArtboardDocument 指针有效
+        m_document->updateShapeArea(m_shapeMoved); // 请求视图重绘移动后的新位置
+        m_document->markShapeMoved(m_shapeMoved, m_offset);
     }
     qDebug() << "MoveShapeCommand: Executed - Shape" << (void*)m_shapeMoved << "moved by" << m_offset;
 }
@@ -51,11 +56,21 @@ void MoveShapeCommand::undo()
         return;
     }
 
+    if (m_document) {
+        m_document->updateShapeArea(m_shapeMoved);
+    }
+
     // QPoint 的一元负号操作符会返回一个新的 QPoint，其 x 和 y 坐标都取反。
     m_shapeMoved->moveBy(-m_offset); // 应用相反的偏移量以移回原位
 
-    if (m_artboardView) { // 如果 ArtboardView 指针有效
-        m_artboardView->update(); // 请求视图重绘以显示恢复位置后的图形
+    if (m_document) { // 如果 ArtboardDocument 指针有效
+        m_document->updateShapeArea(m_shapeMoved); // 请求视图重绘恢复位置后的图形
+        m_document->markShapeMoved(m_shapeMoved, -m_offset);
     }
     qDebug() << "MoveShapeCommand: Undone - Shape" << (void*)m_shapeMoved << "moved back by" << -m_offset;
 }
+
+void MoveShapeCommand::collectShapes(QSet<AbstractShape*> *shapes) const
+{
+    shapes->insert(m_shapeMoved);
+}
@@ -12,8 +12,8 @@
 #include "abstractshape.h"   // 命令操作的是 AbstractShape 类型的对象
 #include <QPoint>            // 需要 QPoint 来表示移动的偏移量
 
-// 向前声明 ArtboardView 类，以减少头文件依赖
-class ArtboardView;
+// 向前声明 ArtboardDocument 类，以减少头文件依赖
+class ArtboardDocument;
 
 /// @brief MoveShapeCommand 类封装了移动单个图形对象的操作。
 ///
@@ -23,16 +23,16 @@ class ArtboardView;
 /// - undo(): 将图形按相反的偏移量移回，恢复到移动前的位置。
 ///
 /// 注意：此命令不拥有被移动的图形对象 (m_shapeMoved) 的所有权；
-/// 图形对象的生命周期由 ArtboardView 的 shapesList 或其他创建型命令管理。
+/// 图形对象的生命周期由 ArtboardDocument 的 shapesList 或其他创建型命令管理。
 class MoveShapeCommand : public AbstractCommand
 {
 public:
     /// @brief MoveShapeCommand 的构造函数。
     /// @param shapeToMove 指向要被移动的 AbstractShape 对象的指针。
     /// @param moveOffset 本次移动操作的净偏移量 (QPoint)。这是从图形原始位置到新位置的向量。
-    /// @param view 指向 ArtboardView 实例的指针，如果命令需要直接与视图交互（例如调用 update()）。
+    /// @param document 指向 ArtboardDocument 实例的指针，如果命令需要直接与视图交互（例如调用 update()）。
     ///             在我们的实现中，图形的 moveBy() 之后，视图通常会通过其他方式（如命令执行后的统一update）更新。
-    MoveShapeCommand(AbstractShape *shapeToMove, const QPoint &moveOffset, ArtboardView *view);
+    MoveShapeCommand(AbstractShape *shapeToMove, const QPoint &moveOffset, ArtboardDocument *document);
 
     /// @brief MoveShapeCommand 的析构函数。
     /// 由于此命令不拥有 m_shapeMoved 图形对象，因此析构函数通常为空，
@@ -50,11 +50,12 @@ public:
     /// @brief 撤销“移动图形”的操作。
     /// 将 m_shapeMoved 图形对象按照 m_offset 的相反方向移动，使其恢复到移动前的位置。
     void undo() override;
+    void collectShapes(QSet<AbstractShape*> *shapes) const override;
 
 private:
     AbstractShape *m_shapeMoved;  ///< 指向被移动的图形对象。命令不拥有此对象。
     QPoint m_offset;              ///< 本次移动操作的净偏移量 (从原始位置到新位置的向量)。
-    ArtboardView *m_artboardView; ///< 指向 ArtboardView 实例的指针，用于可能的视图更新。
+    ArtboardDocument *m_document; ///< 指向 ArtboardDocument 实例的指针，用于通知视图重绘。
 };
 
 #endif // MOVESHAPECOMMAND_H
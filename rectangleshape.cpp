@@ -2,8 +2,7 @@
 #include <QPainter>
 #include <QPen>
 #include <QBrush>
-#include <QPainterPath>
-#include <QPainterPathStroker>
+#include "geometrykernels.h"
 #include <QJsonArray>
 
 
@@ -13,6 +12,11 @@ RectangleShape::RectangleShape(const QRectF &rect, const QColor &borderColor, in
 {
 }
 
+AbstractShape *RectangleShape::clone() const
+{
+    return new RectangleShape(*this);
+}
+
 void RectangleShape::draw(QPainter *painter)
 {
     if (!painter || m_rect.isNull()) return;
@@ -63,53 +67,34 @@ QRect RectangleShape::getBoundingRect() const // "TheShape" 指代 RectangleShap
     return transform.mapRect(m_rect.normalized()).toAlignedRect();
 }
 
-bool RectangleShape::containsPoint(const QPoint &point) const // "TheShape" 指代 RectangleShape 等
+bool RectangleShape::containsPoint(const QPoint &point) const
 {
-    // 如果没有旋转，用最快的方式判断
-    if (m_rotationAngle == 0.0) {
-        // 这里是你原来的 containsPoint 逻辑
-        if (isFilled()) { return m_rect.contains(point); }
-        else { /* ... stroker logic ... */ }
-    }
+    // 1. 用缓存的逆矩阵把点击位置“反向旋转”回未旋转的图形坐标系（与 draw() 中的变换一致）
+    QPointF unrotatedPoint = inverseRotation().map(QPointF(point));
 
-    // 1. 创建与 draw() 方法中完全一样的变换矩阵
-    QTransform transform;
-    transform.translate(m_rect.center().x(), m_rect.center().y());
-    transform.rotate(m_rotationAngle);
-    transform.translate(-m_rect.center().x(), -m_rect.center().y());
-
-    // 2. 获取该变换的“逆矩阵”
-    QTransform inverseTransform = transform.inverted();
-
-    // 3. 将用户点击的点，通过逆矩阵，“反向旋转”回去
-    QPointF unrotatedPoint = inverseTransform.map(QPointF(point));
-
-    // 4. 判断这个“反向旋转”后的点，是否在“未旋转”的原始图形内部
-    //    这里的逻辑就和我们之前写的 containsPoint 完全一样了
+    // 2. 在未旋转的坐标系中判断：填充的图形在整个矩形内命中，未填充的只在边框附近命中
     if (isFilled()) {
         return m_rect.contains(unrotatedPoint);
-    } else {
-        QPainterPath path;
-        path.addRect(m_rect); // 对于椭圆是 addEllipse
-        QPainterPathStroker stroker;
-        stroker.setWidth(this->getPenWidth() + 4.0);
-        return stroker.createStroke(path).contains(unrotatedPoint);
     }
+    return GeometryKernels::rectOutlineNear(m_rect, unrotatedPoint, hitRadius());
 }
 
 void RectangleShape::moveBy(const QPoint &offset)
 {
     m_rect.translate(offset);
+    invalidateCaches();
 }
 
 void RectangleShape::updateShape(const QPoint &point)
 {
     m_rect.setBottomRight(point);
+    invalidateCaches();
 }
 
 void RectangleShape::setGeometry(const QRect &rect)
 {
     m_rect = rect;
+    invalidateCaches();
 }
 
 
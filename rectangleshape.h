@@ -14,6 +14,8 @@ public:
                    bool filled = false,
                    const QColor &fillColor = Qt::transparent);
 
+    AbstractShape *clone() const override;
+
     void draw(QPainter *painter) override;
     QRect getBoundingRect() const override;
     QRectF getCoreGeometry() const override;
@@ -1,19 +1,23 @@
 #include "resizecommand.h"
 #include "abstractshape.h"
-#include "artboardview.h"
+#include "artboarddocument.h"
 
-ResizeCommand::ResizeCommand(AbstractShape *shape, ArtboardView *view, const QRect &oldRect, const QRect &newRect)
-    : m_shape(shape), m_view(view), m_oldRect(oldRect), m_newRect(newRect)
+ResizeCommand::ResizeCommand(AbstractShape *shape, ArtboardDocument *document, const QRect &oldRect, const QRect &newRect)
+    : m_shape(shape), m_document(document), m_oldRect(oldRect), m_newRect(newRect)
 {
 }
 
 void ResizeCommand::execute()
 {
     if (m_shape) {
+        if (m_document) {
+            m_document->updateShapeArea(m_shape); // 旧的区域
+        }
         m_shape->setGeometry(m_newRect);
-        if (m_view) {
+        if (m_document) {
             // 命令执行后，要求视图重绘以显示最新状态
-            m_view->update();
+            m_document->updateShapeArea(m_shape);
+            m_document->markShapeModified(m_shape);
         }
     }
 }
@@ -21,10 +25,19 @@ void ResizeCommand::execute()
 void ResizeCommand::undo()
 {
     if (m_shape) {
+        if (m_document) {
+            m_document->updateShapeArea(m_shape); // 旧的区域
+        }
         m_shape->setGeometry(m_oldRect);
-        if (m_view) {
+        if (m_document) {
             // 撤销后，同样要求视图重绘
-            m_view->update();
+            m_document->updateShapeArea(m_shape);
+            m_document->markShapeModified(m_shape);
         }
     }
 }
+
+void ResizeCommand::collectShapes(QSet<AbstractShape*> *shapes) const
+{
+    shapes->insert(m_shape);
+}
@@ -5,21 +5,22 @@
 #include <QRect>
 
 class AbstractShape;
-class ArtboardView; // 前向声明
+class ArtboardDocument; // 前向声明
 
 class ResizeCommand : public AbstractCommand
 {
 public:
-    // 我们需要 ArtboardView* 以便在命令执行后调用 update()
-    ResizeCommand(AbstractShape *shape, ArtboardView *view, const QRect &oldRect, const QRect &newRect);
+    // 我们需要 ArtboardDocument* 以便在命令执行后调用 update()
+    ResizeCommand(AbstractShape *shape, ArtboardDocument *document, const QRect &oldRect, const QRect &newRect);
     ~ResizeCommand() override {}
 
     void execute() override;
     void undo() override;
+    void collectShapes(QSet<AbstractShape*> *shapes) const override;
 
 private:
     AbstractShape *m_shape;
-    ArtboardView *m_view;
+    ArtboardDocument *m_document;
     QRect m_oldRect;
     QRect m_newRect;
 };
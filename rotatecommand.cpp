@@ -1,10 +1,10 @@
 #include "rotatecommand.h"
 #include "abstractshape.h"
-#include "artboardview.h"
+#include "artboarddocument.h"
 
-RotateCommand::RotateCommand(AbstractShape *shape, ArtboardView *view, qreal oldAngle, qreal newAngle)
+RotateCommand::RotateCommand(AbstractShape *shape, ArtboardDocument *document, qreal oldAngle, qreal newAngle)
     : m_shape(shape),
-    m_view(view),
+    m_document(document),
     m_oldAngle(oldAngle),
     m_newAngle(newAngle)
 {
@@ -14,9 +14,13 @@ RotateCommand::RotateCommand(AbstractShape *shape, ArtboardView *view, qreal old
 void RotateCommand::execute()
 {
     if (m_shape) {
+        if (m_document) {
+            m_document->updateShapeArea(m_shape); // 旧的区域
+        }
         m_shape->setRotationAngle(m_newAngle);
-        if (m_view) {
-            m_view->update();
+        if (m_document) {
+            m_document->updateShapeArea(m_shape);
+            m_document->markShapeModified(m_shape);
         }
     }
 }
@@ -25,9 +29,18 @@ void RotateCommand::execute()
 void RotateCommand::undo()
 {
     if (m_shape) {
+        if (m_document) {
+            m_document->updateShapeArea(m_shape); // 旧的区域
+        }
         m_shape->setRotationAngle(m_oldAngle);
-        if (m_view) {
-            m_view->update();
+        if (m_document) {
+            m_document->updateShapeArea(m_shape);
+            m_document->markShapeModified(m_shape);
         }
     }
 }
+
+void RotateCommand::collectShapes(QSet<AbstractShape*> *shapes) const
+{
+    shapes->insert(m_shape);
+}
@@ -8,22 +8,23 @@
 
 // 前向声明
 class AbstractShape;
-class ArtboardView;
+class ArtboardDocument;
 
 class RotateCommand : public AbstractCommand
 {
 public:
     // 构造函数的声明，需要与.cpp文件中的实现完全匹配
-    RotateCommand(AbstractShape *shape, ArtboardView *view, qreal oldAngle, qreal newAngle);
+    RotateCommand(AbstractShape *shape, ArtboardDocument *document, qreal oldAngle, qreal newAngle);
     ~RotateCommand() override {}
 
     void execute() override;
     void undo() override;
+    void collectShapes(QSet<AbstractShape*> *shapes) const override;
 
 private:
     // 这里是所有成员变量的声明，C++代码将在这里找到它们
     AbstractShape *m_shape;
-    ArtboardView *m_view;
+    ArtboardDocument *m_document;
     qreal m_oldAngle;
     qreal m_newAngle;
 };
@@ -0,0 +1,308 @@
+#include "sceneexporter.h"
+#include "abstractshape.h"
+#include "backgroundpyramid.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QPainter>
+#include <QThread>
+#include <QtConcurrent>
+#include <QtEndian>
+#include <QtMath>
+#include <QDebug>
+
+namespace {
+
+// TIFF 6.0 基线中用到的字段类型和标签
+enum TiffType : quint16 { TiffShort = 3, TiffLong = 4, TiffRational = 5 };
+enum TiffTag : quint16
+{
+    ImageWidth = 256,
+    ImageLength = 257,
+    BitsPerSample = 258,
+    Compression = 259,
+    Photometric = 262,
+    StripOffsets = 273,
+    SamplesPerPixel = 277,
+    RowsPerStrip = 278,
+    StripByteCounts = 279,
+    XResolution = 282,
+    YResolution = 283,
+    PlanarConfiguration = 284,
+    ResolutionUnit = 296
+};
+const quint16 CompressionDeflate = 8;
+const quint16 PhotometricRgb = 2;
+const quint16 ResolutionUnitInch = 2;
+const qreal ScreenDotsPerInch = 96.0;
+
+void appendUInt16(QByteArray &out, quint16 value)
+{
+    char bytes[2];
+    qToLittleEndian(value, bytes);
+    out.append(bytes, 2);
+}
+
+void appendUInt32(QByteArray &out, quint32 value)
+{
+    char bytes[4];
+    qToLittleEndian(value, bytes);
+    out.append(bytes, 4);
+}
+
+struct TiffEntry
+{
+    quint16 tag;
+    quint16 type;
+    quint32 count;
+    quint32 value;  // 值本身（放得下时）或值所在的文件偏移
+};
+
+}
+
+SceneExporter::SceneExporter(const Scene &scene, const Options &options)
+    : m_scene(scene),
+    m_options(options),
+    m_outputSize(qCeil(scene.size.width() * options.scale), qCeil(scene.size.height() * options.scale))
+{
+    // 一条带至少要放得进内存预算
+    const qint64 bytesPerRow = qMax<qint64>(1, qint64(m_outputSize.width()) * 4);
+    m_bandHeight = int(qBound<qint64>(1, options.bandHeight, qMax<qint64>(1, options.memoryBudget / bytesPerRow)));
+}
+
+bool SceneExporter::isStreamingFormat(const QString &filePath)
+{
+    const QString suffix = QFileInfo(filePath).suffix().toLower();
+    return suffix == "tif" || suffix == "tiff";
+}
+
+bool SceneExporter::write(const QString &filePath)
+{
+    if (isStreamingFormat(filePath)) {
+        return writeTiff(filePath);
+    }
+    const QImage image = renderImage();
+    return !image.isNull() && image.save(filePath);
+}
+
+QImage SceneExporter::renderImage()
+{
+    if (m_outputSize.isEmpty()) {
+        return QImage();
+    }
+    if (qint64(m_outputSize.width()) * m_outputSize.height() * 4 > m_options.memoryBudget) {
+        qWarning() << "Error: An export of" << m_outputSize << "does not fit in memory; export it as TIFF instead.";
+        return QImage();
+    }
+    QImage image(m_outputSize, QImage::Format_ARGB32_Premultiplied);
+    QPainter painter(&image);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    renderBands(nullptr, [&painter](Band &band) {
+        painter.drawImage(0, band.y, band.image);
+        return true;
+    });
+    return image;
+}
+
+// 文件布局：文件头 | 各条带压缩后的数据 | 超出字段宽度的值 | IFD。
+// IFD 在所有条带写完后才知道各条带的位置，所以写在最后，再回填文件头中的偏移。
+bool SceneExporter::writeTiff(const QString &filePath)
+{
+    if (m_outputSize.isEmpty()) {
+        return false;
+    }
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Error: Failed to open" << filePath << file.errorString();
+        return false;
+    }
+    QByteArray header("II");
+    appendUInt16(header, 42);
+    appendUInt32(header, 0);
+    file.write(header);
+
+    QVector<quint32> stripOffsets;
+    QVector<quint32> stripByteCounts;
+    quint64 offset = header.size();
+    const int width = m_outputSize.width();
+
+    // 每条带在工作线程中转换为紧凑的 RGB 行并独立压缩（一个 strip 就是一段完整的 zlib 数据）
+    auto compress = [width](Band &band) {
+        const QImage rgb = band.image.convertToFormat(QImage::Format_RGB888);
+        band.image = QImage();
+        const int rowBytes = width * 3;
+        QByteArray raw(rowBytes * band.height, Qt::Uninitialized);
+        for (int row = 0; row < band.height; ++row) {
+            memcpy(raw.data() + row * rowBytes, rgb.constScanLine(row), rowBytes);
+        }
+        band.encoded = qCompress(raw).mid(4); // 去掉 qCompress 在 zlib 数据前加的长度
+    };
+    const bool ok = renderBands(compress, [&](Band &band) {
+        if (offset + band.encoded.size() > 0xFFFFFFFFull) {
+            qWarning() << "Error: The exported TIFF would exceed 4 GB.";
+            return false;
+        }
+        if (file.write(band.encoded) != band.encoded.size()) {
+            qWarning() << "Error: Failed to write" << filePath << file.errorString();
+            return false;
+        }
+        stripOffsets.append(quint32(offset));
+        stripByteCounts.append(quint32(band.encoded.size()));
+        offset += band.encoded.size();
+        return true;
+    });
+    if (!ok) {
+        file.close();
+        file.remove();
+        return false;
+    }
+
+    // 放不进 4 字节的值先写在 IFD 之前
+    QByteArray tail;
+    if (offset % 2) {
+        tail.append('\0'); // IFD 和值都从偶数偏移开始
+    }
+    auto tailOffset = [&offset, &tail]() { return quint32(offset + tail.size()); };
+    const quint32 bitsOffset = tailOffset();
+    for (int i = 0; i < 3; ++i) {
+        appendUInt16(tail, 8);
+    }
+    const quint32 resolutionOffset = tailOffset();
+    const quint32 dpi = quint32(qRound(ScreenDotsPerInch * m_options.scale * 100));
+    appendUInt32(tail, dpi);
+    appendUInt32(tail, 100);
+    const int strips = stripOffsets.size();
+    quint32 offsetsValue = stripOffsets.first();
+    quint32 countsValue = stripByteCounts.first();
+    if (strips > 1) {
+        offsetsValue = tailOffset();
+        for (quint32 value : stripOffsets) appendUInt32(tail, value);
+        countsValue = tailOffset();
+        for (quint32 value : stripByteCounts) appendUInt32(tail, value);
+    }
+
+    const QVector<TiffEntry> entries = {
+        { ImageWidth, TiffLong, 1, quint32(width) },
+        { ImageLength, TiffLong, 1, quint32(m_outputSize.height()) },
+        { BitsPerSample, TiffShort, 3, bitsOffset },
+        { Compression, TiffShort, 1, CompressionDeflate },
+        { Photometric, TiffShort, 1, PhotometricRgb },
+        { StripOffsets, TiffLong, quint32(strips), offsetsValue },
+        { SamplesPerPixel, TiffShort, 1, 3 },
+        { RowsPerStrip, TiffLong, 1, quint32(m_bandHeight) },
+        { StripByteCounts, TiffLong, quint32(strips), countsValue },
+        { XResolution, TiffRational, 1, resolutionOffset },
+        { YResolution, TiffRational, 1, resolutionOffset },
+        { PlanarConfiguration, TiffShort, 1, 1 },
+        { ResolutionUnit, TiffShort, 1, ResolutionUnitInch }
+    };
+    const quint32 ifdOffset = tailOffset();
+    appendUInt16(tail, quint16(entries.size()));
+    for (const TiffEntry &entry : entries) {
+        appendUInt16(tail, entry.tag);
+        appendUInt16(tail, entry.type);
+        appendUInt32(tail, entry.count);
+        if (entry.type == TiffShort && entry.count == 1) {
+            appendUInt16(tail, quint16(entry.value)); // 单个 SHORT 放在值字段的前两个字节
+            appendUInt16(tail, 0);
+        } else {
+            appendUInt32(tail, entry.value);
+        }
+    }
+    appendUInt32(tail, 0); // 没有下一个 IFD
+
+    char ifdBytes[4];
+    qToLittleEndian(ifdOffset, ifdBytes);
+    if (file.write(tail) != tail.size() || !file.seek(4) || file.write(ifdBytes, 4) != 4) {
+        qWarning() << "Error: Failed to write" << filePath << file.errorString();
+        file.close();
+        file.remove();
+        return false;
+    }
+    file.close();
+    qDebug() << "Exported" << m_outputSize << "in" << strips << "bands to" << filePath;
+    return true;
+}
+
+// 主线程准备一批条带（查询图形、读取背景图的相应部分），在线程池中并行栅格化，再按顺序交出。
+// 一批的条带数同时受线程数和内存预算限制。
+bool SceneExporter::renderBands(const std::function<void(Band &)> &process, const std::function<bool(Band &)> &consume)
+{
+    const qint64 bandBytes = qMax<qint64>(1, qint64(m_outputSize.width()) * m_bandHeight * 4);
+    const int batchSize = m_options.parallel
+                              ? int(qBound<qint64>(1, m_options.memoryBudget / bandBytes, QThread::idealThreadCount()))
+                              : 1;
+    auto work = [this, &process](Band &band) {
+        renderBand(&band);
+        if (process) {
+            process(band);
+        }
+    };
+
+    for (int y = 0; y < m_outputSize.height();) {
+        QVector<Band> batch;
+        while (batch.size() < batchSize && y < m_outputSize.height()) {
+            Band band;
+            band.y = y;
+            band.height = qMin(m_bandHeight, m_outputSize.height() - y);
+            prepareBand(&band);
+            batch.append(band);
+            y += band.height;
+        }
+        if (batch.size() > 1) {
+            QtConcurrent::blockingMap(batch, work);
+        } else {
+            work(batch.first());
+        }
+        for (Band &band : batch) {
+            if (!consume(band)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void SceneExporter::prepareBand(Band *band)
+{
+    const qreal scale = m_options.scale;
+    const QRectF area(0, band->y / scale, m_scene.size.width(), band->height / scale);
+    if (m_scene.shapesInArea) {
+        band->shapes = m_scene.shapesInArea(area.toAlignedRect().adjusted(-1, -1, 1, 1));
+    }
+
+    const QRectF backgroundRect = m_scene.backgroundRect;
+    if (!m_scene.background || backgroundRect.isEmpty() || !area.intersects(backgroundRect)) {
+        return;
+    }
+    // 从输出尺寸对应的那一级中只取这条带覆盖的部分
+    BackgroundPyramid *pyramid = m_scene.background;
+    const int level = pyramid->levelFor((backgroundRect.size() * scale).toSize());
+    const QSize levelSize = BackgroundPyramid::levelSize(pyramid->imageSize(), level);
+    const qreal sx = levelSize.width() / backgroundRect.width();
+    const qreal sy = levelSize.height() / backgroundRect.height();
+    const QRectF target = area & backgroundRect;
+    const QRectF source((target.left() - backgroundRect.left()) * sx, (target.top() - backgroundRect.top()) * sy,
+                        target.width() * sx, target.height() * sy);
+    // 多取一圈像素，平滑缩放时条带边缘的插值与相邻条带一致
+    const QRect covered = source.toAlignedRect().adjusted(-1, -1, 1, 1) & QRect(QPoint(0, 0), levelSize);
+    band->background = pyramid->region(level, covered);
+    band->backgroundTarget = QRectF(backgroundRect.left() + covered.left() / sx, backgroundRect.top() + covered.top() / sy,
+                                    covered.width() / sx, covered.height() / sy);
+}
+
+void SceneExporter::renderBand(Band *band) const
+{
+    band->image = QImage(m_outputSize.width(), band->height, QImage::Format_ARGB32_Premultiplied);
+    band->image.fill(m_scene.fillColor);
+    QPainter painter(&band->image);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, true);
+    painter.translate(0, -band->y);
+    painter.scale(m_options.scale, m_options.scale);
+    if (!band->background.isNull()) {
+        painter.drawImage(band->backgroundTarget, band->background);
+    }
+    for (AbstractShape *shape : band->shapes) {
+        shape->draw(&painter);
+    }
+}
@@ -0,0 +1,88 @@
+#ifndef SCENEEXPORTER_H
+#define SCENEEXPORTER_H
+
+// ---------------------------------------------------------------------------
+// 描述: 定义了 SceneExporter 类，按任意倍数把场景导出为图像文件。
+//       输出按水平条带逐条栅格化：每条带只分配自己的像素，绘制与它相交的图形和它覆盖的那部分背景图，
+//       编码后立即写入文件，内存占用与输出的总尺寸无关。几条带可以在线程池中并行栅格化和压缩，
+//       并行的条带数受内存预算限制。
+//
+//       TIFF 输出（.tif/.tiff）逐条带流式写入：每条带是一个 Deflate 压缩的 strip，
+//       整个文件不需要同时在内存中，适合远大于屏幕的打印分辨率导出。
+//       其他格式（PNG、JPEG 等）由 QImageWriter 编码，需要完整的图像，
+//       只有输出不超过内存预算时才能导出。
+// ---------------------------------------------------------------------------
+
+#include <QColor>
+#include <QImage>
+#include <QRectF>
+#include <QSize>
+#include <QString>
+#include <QVector>
+#include <functional>
+
+class AbstractShape;
+class BackgroundPyramid;
+
+class SceneExporter
+{
+public:
+    /// @brief 要导出的场景。所有成员只在调用 write() 的线程中使用。
+    struct Scene
+    {
+        QSize size;                         // 场景的逻辑尺寸
+        QColor fillColor;                   // 画布底色
+        BackgroundPyramid *background = nullptr;
+        QRectF backgroundRect;              // 背景图在场景中的位置（逻辑坐标）
+        /// 返回与 area 相交的图形，按 z 顺序（先画的在前）排列。图形在工作线程中绘制，
+        /// 导出期间不能被修改。
+        std::function<QVector<AbstractShape*>(const QRect &area)> shapesInArea;
+    };
+
+    struct Options
+    {
+        qreal scale = 1.0;                          // 输出像素 / 场景逻辑像素
+        int bandHeight = 256;                       // 每条带的行数（输出像素）
+        bool parallel = true;                       // 是否并行栅格化多条带
+        qint64 memoryBudget = 256 * 1024 * 1024;    // 同时存在的条带像素的字节数上限
+    };
+
+    SceneExporter(const Scene &scene, const Options &options);
+
+    /// 输出图像的像素尺寸。
+    QSize outputSize() const { return m_outputSize; }
+
+    /// @brief 按 filePath 的后缀选择格式写入文件。
+    bool write(const QString &filePath);
+    /// @brief 流式写入 Deflate 压缩的 RGB TIFF。
+    bool writeTiff(const QString &filePath);
+    /// @brief 把整个输出画到一张 QImage 上。输出超过内存预算时返回空图。
+    QImage renderImage();
+
+    static bool isStreamingFormat(const QString &filePath);
+
+private:
+    struct Band
+    {
+        int y;                          // 第一行在输出中的行号
+        int height;
+        QVector<AbstractShape*> shapes;
+        QImage background;              // 背景图中这条带覆盖的部分
+        QRectF backgroundTarget;        // 它在场景中的位置（逻辑坐标）
+        QImage image;
+        QByteArray encoded;
+    };
+
+    /// @brief 逐条带栅格化整个输出。process 在工作线程中对每条带调用一次（可以为空），
+    /// consume 在调用线程中按从上到下的顺序调用；consume 返回 false 时停止。
+    bool renderBands(const std::function<void(Band &)> &process, const std::function<bool(Band &)> &consume);
+    void prepareBand(Band *band);
+    void renderBand(Band *band) const;
+
+    Scene m_scene;
+    Options m_options;
+    QSize m_outputSize;
+    int m_bandHeight;
+};
+
+#endif // SCENEEXPORTER_H
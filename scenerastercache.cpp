@@ -0,0 +1,187 @@
+#include "scenerastercache.h"
+#include "abstractshape.h"
+#include <QPainter>
+#include <QThread>
+
+SceneRasterCache::SceneRasterCache(SceneFunction sceneFunction)
+    : m_sceneFunction(std::move(sceneFunction)),
+    m_columns(0),
+    m_rows(0),
+    m_devicePixelRatio(1.0)
+{
+    m_threadPool.setMaxThreadCount(QThread::idealThreadCount());
+}
+
+SceneRasterCache::~SceneRasterCache()
+{
+    m_threadPool.waitForDone();
+}
+
+void SceneRasterCache::resize(const QSize &size, qreal devicePixelRatio, bool preserveContent)
+{
+    if (size == m_size && qFuzzyCompare(devicePixelRatio, m_devicePixelRatio) && !m_tiles.isEmpty()) {
+        return;
+    }
+
+    int columns = (size.width() + TileSize - 1) / TileSize;
+    int rows = (size.height() + TileSize - 1) / TileSize;
+    QVector<Tile> tiles(columns * rows);
+
+    // 瓦片总是完整地绘制整个 TileSize 区域（包括超出画布边缘的部分），
+    // 所以像素比不变时，旧网格中仍然存在的瓦片可以原样保留。
+    bool canPreserve = preserveContent && qFuzzyCompare(devicePixelRatio, m_devicePixelRatio);
+    if (canPreserve) {
+        for (int row = 0; row < qMin(rows, m_rows); ++row) {
+            for (int column = 0; column < qMin(columns, m_columns); ++column) {
+                tiles[row * columns + column] = m_tiles.at(row * m_columns + column);
+            }
+        }
+    }
+
+    m_tiles = tiles;
+    m_columns = columns;
+    m_rows = rows;
+    m_size = size;
+    m_devicePixelRatio = devicePixelRatio;
+}
+
+void SceneRasterCache::invalidate()
+{
+    for (Tile &tile : m_tiles) {
+        tile.dirty = true;
+    }
+}
+
+void SceneRasterCache::invalidateRect(const QRect &rect)
+{
+    QRect clipped = rect.intersected(QRect(0, 0, m_columns * TileSize, m_rows * TileSize));
+    if (clipped.isEmpty()) {
+        return;
+    }
+    for (int row = clipped.top() / TileSize; row <= clipped.bottom() / TileSize; ++row) {
+        for (int column = clipped.left() / TileSize; column <= clipped.right() / TileSize; ++column) {
+            m_tiles[row * m_columns + column].dirty = true;
+        }
+    }
+}
+
+int SceneRasterCache::dirtyTileCount() const
+{
+    int count = 0;
+    for (const Tile &tile : m_tiles) {
+        if (tile.dirty) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+QRect SceneRasterCache::tileRect(int index) const
+{
+    return QRect((index % m_columns) * TileSize, (index / m_columns) * TileSize, TileSize, TileSize);
+}
+
+void SceneRasterCache::paint(QPainter *painter, const QRegion &region)
+{
+    const QRect area = region.boundingRect();
+    flush(area);
+
+    // painter 在 paintEvent 中已被裁剪到 region，贴图只会触及需要重绘的像素
+    for (int i = 0; i < m_tiles.size(); ++i) {
+        QRect rect = tileRect(i);
+        if (rect.intersects(area) && region.intersects(rect)) {
+            painter->drawImage(rect.topLeft(), m_tiles.at(i).image);
+        }
+    }
+}
+
+// 重新栅格化与 area 相交的所有脏瓦片
+void SceneRasterCache::flush(const QRect &area)
+{
+    if (!m_sceneFunction) {
+        return;
+    }
+
+    // 1. 找出需要重新绘制的瓦片
+    QVector<int> dirtyTiles;
+    QVector<int> binOfTile(m_tiles.size(), -1);
+    QRect dirtyBounds;
+    for (int i = 0; i < m_tiles.size(); ++i) {
+        QRect rect = tileRect(i);
+        if (m_tiles.at(i).dirty && rect.intersects(area)) {
+            binOfTile[i] = dirtyTiles.size();
+            dirtyTiles.append(i);
+            dirtyBounds = dirtyBounds.united(rect);
+        }
+    }
+    if (dirtyTiles.isEmpty()) {
+        return;
+    }
+
+    // 2. 在主线程上取得场景快照，并把相交的图形按 z 顺序分配到各个瓦片
+    const Scene scene = m_sceneFunction();
+    QVector<QVector<AbstractShape*>> bins(dirtyTiles.size());
+    const QVector<AbstractShape*> candidates = scene.shapesInArea ? scene.shapesInArea(dirtyBounds)
+                                                                   : QVector<AbstractShape*>();
+    for (AbstractShape *shape : candidates) {
+        QRect damage = shape->getDamageRect().intersected(dirtyBounds);
+        if (damage.isEmpty()) {
+            continue;
+        }
+        for (int row = damage.top() / TileSize; row <= damage.bottom() / TileSize; ++row) {
+            for (int column = damage.left() / TileSize; column <= damage.right() / TileSize; ++column) {
+                int bin = binOfTile.at(row * m_columns + column);
+                if (bin >= 0) {
+                    bins[bin].append(shape);
+                }
+            }
+        }
+    }
+
+    // 3. 为脏瓦片准备图像（按物理像素分配）
+    for (int index : dirtyTiles) {
+        Tile &tile = m_tiles[index];
+        if (tile.image.isNull()) {
+            tile.image = QImage(QSize(TileSize, TileSize) * m_devicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+            tile.image.setDevicePixelRatio(m_devicePixelRatio);
+        }
+    }
+
+    // 4. 栅格化。只有一个脏瓦片时（最常见的单图形编辑）直接在当前线程绘制，省去调度开销；
+    //    否则每个瓦片使用独立的 QPainter 在线程池中并行绘制。
+    if (dirtyTiles.size() == 1) {
+        int index = dirtyTiles.first();
+        renderTile(&m_tiles[index].image, tileRect(index), scene, bins.first());
+    } else {
+        for (int bin = 0; bin < dirtyTiles.size(); ++bin) {
+            int index = dirtyTiles.at(bin);
+            QImage *image = &m_tiles[index].image;
+            QRect rect = tileRect(index);
+            const QVector<AbstractShape*> &shapes = bins.at(bin);
+            m_threadPool.start([image, rect, &scene, &shapes]() {
+                renderTile(image, rect, scene, shapes);
+            });
+        }
+        m_threadPool.waitForDone();
+    }
+
+    for (int index : dirtyTiles) {
+        m_tiles[index].dirty = false;
+    }
+}
+
+void SceneRasterCache::renderTile(QImage *image, const QRect &tileRect, const Scene &scene,
+                                  const QVector<AbstractShape*> &shapes)
+{
+    QPainter painter(image);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.translate(-tileRect.topLeft());
+
+    painter.fillRect(tileRect, scene.fillColor);
+    if (!scene.background.isNull()) {
+        painter.drawImage(scene.backgroundOffset, scene.background);
+    }
+    for (AbstractShape *shape : shapes) {
+        shape->draw(&painter);
+    }
+}
@@ -0,0 +1,100 @@
+#ifndef SCENERASTERCACHE_H
+#define SCENERASTERCACHE_H
+
+// ---------------------------------------------------------------------------
+// 描述: 定义了场景栅格缓存类 SceneRasterCache。
+//       它把“已经提交的场景”（背景色、背景图、shapesList 中的所有图形）保留为一组
+//       固定大小的 QImage 瓦片。绘制新图形、显示选择框时只需把瓦片贴到屏幕上，
+//       再在上面画正在绘制的图形，绘制延迟不再随画布上的图形数量增长。
+//       某个图形改变时只有它覆盖到的瓦片需要重新栅格化，多个脏瓦片会在线程池中并行绘制。
+// ---------------------------------------------------------------------------
+
+#include <QColor>
+#include <QImage>
+#include <QPointF>
+#include <QRegion>
+#include <QSize>
+#include <QThreadPool>
+#include <QVector>
+#include <functional>
+
+class QPainter;
+class AbstractShape;
+
+/// @brief SceneRasterCache 以瓦片的形式保存已提交场景的栅格化结果。
+///
+/// 画布被划分成 TileSize x TileSize（逻辑像素）的网格，每个瓦片有自己的脏标记。
+/// 命令修改图形后，调用 invalidateRect() 标记受影响的瓦片；下一次 paint() 需要用到
+/// 这些瓦片时才重新栅格化它们，其余瓦片直接复用。
+///
+/// 瓦片在工作线程中绘制，因此 AbstractShape::draw() 必须只读取图形自身的数据。
+/// 场景的其余部分（背景色、已缩放好的背景图、与区域相交的图形列表）在主线程上
+/// 通过 SceneFunction 一次性取得，工作线程只接触这份快照。
+class SceneRasterCache
+{
+public:
+    static const int TileSize = 256; ///< 瓦片边长（逻辑像素）。
+
+    /// @brief 栅格化所需的场景快照，由视图在主线程上提供。
+    struct Scene
+    {
+        QColor fillColor;          ///< 画布底色。
+        QImage background;         ///< 已按画布尺寸缩放好的背景图，可以为空。
+        QPointF backgroundOffset;  ///< 背景图左上角的位置（逻辑坐标）。
+        /// 返回与 area 相交的已提交图形，必须按 z 顺序（先画的在前）排列。
+        std::function<QVector<AbstractShape*>(const QRect &area)> shapesInArea;
+    };
+    using SceneFunction = std::function<Scene()>;
+
+    explicit SceneRasterCache(SceneFunction sceneFunction);
+    ~SceneRasterCache();
+
+    /// @brief 调整缓存尺寸。尺寸和像素比都不变时什么也不做。
+    /// @param size 画布的逻辑尺寸。
+    /// @param devicePixelRatio 设备像素比，瓦片按物理像素分配。
+    /// @param preserveContent 为 true 时保留仍然有效的瓦片，只有新增的瓦片是脏的；
+    ///                        场景内容与画布尺寸相关时（例如居中显示的背景图）应传 false。
+    void resize(const QSize &size, qreal devicePixelRatio, bool preserveContent);
+
+    /// @brief 使所有瓦片失效。
+    void invalidate();
+
+    /// @brief 使与 rect（逻辑坐标）相交的瓦片失效。
+    void invalidateRect(const QRect &rect);
+
+    /// @brief 把缓存绘制到 painter 上。与 region 相交的脏瓦片会先被重新栅格化。
+    /// @param painter 目标画家，通常是 ArtboardView::paintEvent 中的 QPainter。
+    /// @param region 本次需要绘制的区域（逻辑坐标）。
+    void paint(QPainter *painter, const QRegion &region);
+
+    QSize size() const { return m_size; }
+
+    /// @brief 当前脏瓦片的数量，供性能测试观察失效粒度。
+    int dirtyTileCount() const;
+
+    /// @brief 在 image 上绘制场景中 tileRect（逻辑坐标）范围内的内容。
+    /// 这是一个纯函数，可以在任何线程中调用。
+    /// @param shapes 与 tileRect 相交的图形，按 z 顺序排列。
+    static void renderTile(QImage *image, const QRect &tileRect, const Scene &scene,
+                           const QVector<AbstractShape*> &shapes);
+
+private:
+    struct Tile
+    {
+        QImage image;
+        bool dirty = true;
+    };
+
+    QRect tileRect(int index) const;
+    void flush(const QRect &area);
+
+    SceneFunction m_sceneFunction;
+    QVector<Tile> m_tiles;      ///< 按行优先排列的瓦片网格。
+    int m_columns;
+    int m_rows;
+    QSize m_size;               ///< 画布的逻辑尺寸。
+    qreal m_devicePixelRatio;
+    QThreadPool m_threadPool;   ///< 专用线程池，waitForDone() 只等待本缓存的任务。
+};
+
+#endif // SCENERASTERCACHE_H
@@ -0,0 +1,202 @@
+#include "shapecodec.h"
+#include <QCborArray>
+#include <QCborMap>
+#include <QCborValue>
+#include <QJsonArray>
+#include <QtMath>
+
+namespace {
+
+using ShapeCodec::appendVarint;
+using ShapeCodec::readVarint;
+
+// 曲线坐标在 JSON 中保留两位小数，这里按 0.01 像素的定点数存放
+const double CurveScale = 100.0;
+
+// [[x, y], ...] -> 差值字节串
+QByteArray packPoints(const QJsonArray &points)
+{
+    QByteArray out;
+    out.reserve(points.size() * 2);
+    qint64 lastX = 0, lastY = 0;
+    for (const QJsonValue &value : points) {
+        const QJsonArray point = value.toArray();
+        const qint64 x = point.at(0).toInteger();
+        const qint64 y = point.at(1).toInteger();
+        appendVarint(out, x - lastX);
+        appendVarint(out, y - lastY);
+        lastX = x;
+        lastY = y;
+    }
+    return out;
+}
+
+bool unpackPoints(const QByteArray &data, QJsonArray *points)
+{
+    qint64 x = 0, y = 0;
+    int pos = 0;
+    while (pos < data.size()) {
+        qint64 dx = 0, dy = 0;
+        if (!readVarint(data, &pos, &dx) || !readVarint(data, &pos, &dy)) {
+            return false;
+        }
+        x += dx;
+        y += dy;
+        points->append(QJsonArray({ x, y }));
+    }
+    return true;
+}
+
+// [x0, y0, x1, y1, ...] -> 按轴分别做差值的定点数字节串
+QByteArray packCurves(const QJsonArray &coordinates)
+{
+    QByteArray out;
+    out.reserve(coordinates.size() * 2);
+    qint64 last[2] = { 0, 0 };
+    for (int i = 0; i < coordinates.size(); ++i) {
+        const qint64 fixed = qRound64(coordinates.at(i).toDouble() * CurveScale);
+        appendVarint(out, fixed - last[i % 2]);
+        last[i % 2] = fixed;
+    }
+    return out;
+}
+
+bool unpackCurves(const QByteArray &data, QJsonArray *coordinates)
+{
+    qint64 last[2] = { 0, 0 };
+    int pos = 0;
+    for (int i = 0; pos < data.size(); ++i) {
+        qint64 delta = 0;
+        if (!readVarint(data, &pos, &delta)) {
+            return false;
+        }
+        last[i % 2] += delta;
+        coordinates->append(last[i % 2] / CurveScale);
+    }
+    return true;
+}
+
+QCborMap encodeGeometry(const QJsonObject &geometry)
+{
+    QCborMap map;
+    for (auto it = geometry.constBegin(); it != geometry.constEnd(); ++it) {
+        if (it.key() == QLatin1String("points") && it.value().isArray()) {
+            map.insert(it.key(), packPoints(it.value().toArray()));
+        } else if (it.key() == QLatin1String("curves") && it.value().isArray()) {
+            map.insert(it.key(), packCurves(it.value().toArray()));
+        } else {
+            map.insert(it.key(), QCborValue::fromJsonValue(it.value()));
+        }
+    }
+    return map;
+}
+
+QJsonObject decodeGeometry(const QCborMap &map, bool *ok)
+{
+    QJsonObject geometry;
+    for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+        const QString key = it.key().toString();
+        if (it.value().isByteArray() && key == QLatin1String("points")) {
+            QJsonArray points;
+            *ok = unpackPoints(it.value().toByteArray(), &points) && *ok;
+            geometry.insert(key, points);
+        } else if (it.value().isByteArray() && key == QLatin1String("curves")) {
+            QJsonArray coordinates;
+            *ok = unpackCurves(it.value().toByteArray(), &coordinates) && *ok;
+            geometry.insert(key, coordinates);
+        } else {
+            geometry.insert(key, it.value().toJsonValue());
+        }
+    }
+    return geometry;
+}
+
+QCborMap encodeObject(const QJsonObject &json)
+{
+    QCborMap map;
+    for (auto it = json.constBegin(); it != json.constEnd(); ++it) {
+        if (it.key() == QLatin1String("geometry") && it.value().isObject()) {
+            map.insert(it.key(), encodeGeometry(it.value().toObject()));
+        } else if (it.key() == QLatin1String("children") && it.value().isArray()) {
+            // 组的子图形逐个按同样的规则编码
+            QCborArray children;
+            for (const QJsonValue &child : it.value().toArray()) {
+                children.append(encodeObject(child.toObject()));
+            }
+            map.insert(it.key(), children);
+        } else {
+            map.insert(it.key(), QCborValue::fromJsonValue(it.value()));
+        }
+    }
+    return map;
+}
+
+QJsonObject decodeMap(const QCborMap &map, bool *ok)
+{
+    QJsonObject json;
+    for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+        const QString key = it.key().toString();
+        if (key == QLatin1String("geometry") && it.value().isMap()) {
+            json.insert(key, decodeGeometry(it.value().toMap(), ok));
+        } else if (key == QLatin1String("children") && it.value().isArray()) {
+            QJsonArray children;
+            for (const QCborValue &child : it.value().toArray()) {
+                children.append(decodeMap(child.toMap(), ok));
+            }
+            json.insert(key, children);
+        } else {
+            json.insert(key, it.value().toJsonValue());
+        }
+    }
+    return json;
+}
+
+}
+
+QByteArray ShapeCodec::encode(const QJsonObject &shape)
+{
+    return encodeObject(shape).toCborValue().toCbor();
+}
+
+QJsonObject ShapeCodec::decode(const QByteArray &data, bool *ok)
+{
+    QCborParserError error;
+    const QCborValue value = QCborValue::fromCbor(data, &error);
+    bool decoded = (error.error == QCborError::NoError && value.isMap());
+    QJsonObject json;
+    if (decoded) {
+        json = decodeMap(value.toMap(), &decoded);
+    }
+    if (ok) {
+        *ok = decoded;
+    }
+    return decoded ? json : QJsonObject();
+}
+
+void ShapeCodec::appendVarint(QByteArray &out, qint64 value)
+{
+    // zigzag：把小的负数也映射为小的无符号数
+    quint64 v = (quint64(value) << 1) ^ quint64(value >> 63);
+    while (v >= 0x80) {
+        out.append(char((v & 0x7f) | 0x80));
+        v >>= 7;
+    }
+    out.append(char(v));
+}
+
+bool ShapeCodec::readVarint(const QByteArray &in, int *pos, qint64 *value)
+{
+    quint64 v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (*pos >= in.size()) {
+            return false;
+        }
+        const quint8 byte = quint8(in.at((*pos)++));
+        v |= quint64(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            *value = qint64(v >> 1) ^ -qint64(v & 1);
+            return true;
+        }
+    }
+    return false;
+}
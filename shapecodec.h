@@ -0,0 +1,33 @@
+#ifndef SHAPECODEC_H
+#define SHAPECODEC_H
+
+// ---------------------------------------------------------------------------
+// 描述: .fpa 文件中图形记录的二进制编码。
+//       记录的结构与 AbstractShape::toJsonObject() 的结果相同，只是用 CBOR 代替 JSON 文本，
+//       并且把几何数据中最占空间的两类数组压缩为字节串：
+//         geometry.points  整数点集，依次存放每个点相对前一个点的 dx, dy
+//         geometry.curves  曲线坐标（保留两位小数），乘以 100 取整后同样按相对前一个同轴坐标的差值存放
+//       每个差值用 zigzag 变换后按 LEB128 变长整数写出，鼠标采样的相邻点通常只占 1 字节。
+//       解码得到的 QJsonObject 仍交给 AbstractShape::fromJsonObject 创建图形，
+//       JSON 和二进制两种格式共用同一个图形工厂。
+// ---------------------------------------------------------------------------
+
+#include <QByteArray>
+#include <QJsonObject>
+
+namespace ShapeCodec
+{
+/// @brief 把 toJsonObject() 的结果编码为二进制记录。
+QByteArray encode(const QJsonObject &shape);
+
+/// @brief 把二进制记录解码为 JSON 对象。
+/// @param ok 不为空时写入是否解码成功。数据损坏时返回空对象。
+QJsonObject decode(const QByteArray &data, bool *ok = nullptr);
+
+/// @brief 追加一个 zigzag + LEB128 变长整数。绝对值小于 64 的数只占 1 字节。
+void appendVarint(QByteArray &out, qint64 value);
+/// @brief 从 in 的 *pos 处读取一个变长整数并前移 *pos。数据不完整时返回 false。
+bool readVarint(const QByteArray &in, int *pos, qint64 *value);
+}
+
+#endif // SHAPECODEC_H
@@ -0,0 +1,157 @@
+#include "shapespatialindex.h"
+#include <QSet>
+
+namespace {
+// 单个图形最多写入的单元格数量，超过后放入 m_oversized
+const int MaxCellsPerShape = 64;
+
+// 向下取整的整数除法，负坐标也能落在正确的单元格里
+int floorDiv(int value, int divisor)
+{
+    int quotient = value / divisor;
+    if ((value % divisor != 0) && (value < 0)) {
+        --quotient;
+    }
+    return quotient;
+}
+}
+
+ShapeSpatialIndex::ShapeSpatialIndex(int cellSize)
+    : m_cellSize(qMax(1, cellSize))
+{
+}
+
+quint64 ShapeSpatialIndex::cellKey(int column, int row)
+{
+    return (quint64(quint32(column)) << 32) | quint32(row);
+}
+
+ShapeSpatialIndex::CellRange ShapeSpatialIndex::cellRange(const QRect &rect) const
+{
+    CellRange range;
+    range.left = floorDiv(rect.left(), m_cellSize);
+    range.top = floorDiv(rect.top(), m_cellSize);
+    range.right = floorDiv(rect.right(), m_cellSize);
+    range.bottom = floorDiv(rect.bottom(), m_cellSize);
+    return range;
+}
+
+void ShapeSpatialIndex::addToCells(AbstractShape *shape, const QRect &bounds)
+{
+    if (bounds.isEmpty()) {
+        return;
+    }
+    CellRange range = cellRange(bounds);
+    if (range.count() > MaxCellsPerShape) {
+        m_oversized.append(shape);
+        return;
+    }
+    for (int row = range.top; row <= range.bottom; ++row) {
+        for (int column = range.left; column <= range.right; ++column) {
+            m_cells[cellKey(column, row)].append(shape);
+        }
+    }
+}
+
+void ShapeSpatialIndex::removeFromCells(AbstractShape *shape, const QRect &bounds)
+{
+    if (bounds.isEmpty()) {
+        return;
+    }
+    CellRange range = cellRange(bounds);
+    if (range.count() > MaxCellsPerShape) {
+        m_oversized.removeOne(shape);
+        return;
+    }
+    for (int row = range.top; row <= range.bottom; ++row) {
+        for (int column = range.left; column <= range.right; ++column) {
+            auto it = m_cells.find(cellKey(column, row));
+            if (it == m_cells.end()) {
+                continue;
+            }
+            it->removeOne(shape);
+            if (it->isEmpty()) {
+                m_cells.erase(it);
+            }
+        }
+    }
+}
+
+void ShapeSpatialIndex::insert(AbstractShape *shape, const QRect &bounds)
+{
+    if (!shape) {
+        return;
+    }
+    auto it = m_bounds.find(shape);
+    if (it != m_bounds.end()) {
+        if (it.value() == bounds) {
+            return; // 包围矩形没有变化，不必改动网格
+        }
+        removeFromCells(shape, it.value());
+        it.value() = bounds;
+    } else {
+        m_bounds.insert(shape, bounds);
+    }
+    addToCells(shape, bounds);
+}
+
+void ShapeSpatialIndex::remove(AbstractShape *shape)
+{
+    auto it = m_bounds.find(shape);
+    if (it == m_bounds.end()) {
+        return;
+    }
+    removeFromCells(shape, it.value());
+    m_bounds.erase(it);
+}
+
+void ShapeSpatialIndex::clear()
+{
+    m_cells.clear();
+    m_bounds.clear();
+    m_oversized.clear();
+}
+
+QVector<AbstractShape*> ShapeSpatialIndex::query(const QRect &rect) const
+{
+    QVector<AbstractShape*> result;
+    if (rect.isEmpty() || m_bounds.isEmpty()) {
+        return result;
+    }
+
+    CellRange range = cellRange(rect);
+    const bool singleCell = (range.count() == 1);
+    QSet<AbstractShape*> seen;
+    for (int row = range.top; row <= range.bottom; ++row) {
+        for (int column = range.left; column <= range.right; ++column) {
+            auto it = m_cells.constFind(cellKey(column, row));
+            if (it == m_cells.constEnd()) {
+                continue;
+            }
+            for (AbstractShape *shape : it.value()) {
+                // 单个单元格里的图形不会重复，跨单元格查询才需要去重
+                if (!singleCell && seen.contains(shape)) {
+                    continue;
+                }
+                if (m_bounds.value(shape).intersects(rect)) {
+                    result.append(shape);
+                }
+                if (!singleCell) {
+                    seen.insert(shape);
+                }
+            }
+        }
+    }
+
+    for (AbstractShape *shape : m_oversized) {
+        if (m_bounds.value(shape).intersects(rect)) {
+            result.append(shape);
+        }
+    }
+    return result;
+}
+
+QVector<AbstractShape*> ShapeSpatialIndex::query(const QPoint &point) const
+{
+    return query(QRect(point, QSize(1, 1)));
+}
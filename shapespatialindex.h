@@ -0,0 +1,66 @@
+#ifndef SHAPESPATIALINDEX_H
+#define SHAPESPATIALINDEX_H
+
+// ---------------------------------------------------------------------------
+// 描述: 定义了图形空间索引类 ShapeSpatialIndex。
+//       它是一个按固定大小单元格划分画布的均匀网格，记录每个顶层图形的包围矩形。
+//       点击测试、笔画橡皮擦和场景缓存的裁剪只需检查与查询区域落在同一批单元格中的图形，
+//       而不必遍历整个 shapesList。
+// ---------------------------------------------------------------------------
+
+#include <QHash>
+#include <QPoint>
+#include <QRect>
+#include <QVector>
+
+class AbstractShape;
+
+/// @brief ShapeSpatialIndex 是覆盖图形包围矩形的均匀网格索引。
+///
+/// 索引只保存几何信息，不关心绘制顺序；query() 的结果没有顺序，
+/// 需要 z 顺序的调用方（例如 ArtboardDocument）自行排序。
+/// 覆盖单元格过多的巨大图形不进入网格，而是放在单独的列表中，每次查询都会检查它们，
+/// 避免一次插入就要写入成百上千个单元格。
+class ShapeSpatialIndex
+{
+public:
+    explicit ShapeSpatialIndex(int cellSize = 128);
+
+    /// @brief 插入图形，或在图形已存在时更新它的包围矩形。
+    /// @param bounds 图形在屏幕上占据的区域。空矩形的图形会被记录，但任何查询都不会返回它。
+    void insert(AbstractShape *shape, const QRect &bounds);
+
+    /// @brief 移除图形。图形不在索引中时什么也不做。
+    void remove(AbstractShape *shape);
+
+    void clear();
+
+    bool contains(const AbstractShape *shape) const { return m_bounds.contains(const_cast<AbstractShape*>(shape)); }
+    int count() const { return m_bounds.size(); }
+    QRect boundsOf(const AbstractShape *shape) const { return m_bounds.value(const_cast<AbstractShape*>(shape)); }
+
+    /// @brief 返回包围矩形与 rect 相交的所有图形（无序，不重复）。
+    QVector<AbstractShape*> query(const QRect &rect) const;
+
+    /// @brief 返回包围矩形包含 point 的所有图形（无序，不重复）。
+    QVector<AbstractShape*> query(const QPoint &point) const;
+
+private:
+    struct CellRange
+    {
+        int left, top, right, bottom; // 闭区间的单元格坐标
+        int count() const { return (right - left + 1) * (bottom - top + 1); }
+    };
+
+    static quint64 cellKey(int column, int row);
+    CellRange cellRange(const QRect &rect) const;
+    void addToCells(AbstractShape *shape, const QRect &bounds);
+    void removeFromCells(AbstractShape *shape, const QRect &bounds);
+
+    int m_cellSize;
+    QHash<quint64, QVector<AbstractShape*>> m_cells; ///< 单元格 -> 落在其中的图形
+    QHash<AbstractShape*, QRect> m_bounds;            ///< 图形 -> 建立索引时的包围矩形
+    QVector<AbstractShape*> m_oversized;              ///< 覆盖单元格过多、不进入网格的图形
+};
+
+#endif // SHAPESPATIALINDEX_H
@@ -18,6 +18,8 @@ public:
               const QColor &fillColor = Qt::transparent,
               int numPoints = 5);
 
+    AbstractShape *clone() const override;
+
     void draw(QPainter *painter) override;
     QRect getBoundingRect() const override;
     QRectF getCoreGeometry() const override;
@@ -0,0 +1,23 @@
+# ---------------------------------------------------------------------------
+# bench：FishplateArtboard 的基准测试（QtTest 的 QBENCHMARK）。
+# 场景由 SceneGenerator 按固定种子合成；绘制基准需要 ArtboardView，其余只用 fishplatecore。
+# 运行 bench -o results.xml,xml 或 bench -o results.csv,csv 得到机器可读的结果，见 benchartboard.cpp。
+# ---------------------------------------------------------------------------
+
+QT += widgets testlib
+
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+TARGET = bench
+
+include(../../fishplatecore.pri)
+
+SOURCES += \
+    ../../artboardview.cpp \
+    benchartboard.cpp \
+    scenegenerator.cpp
+
+HEADERS += \
+    ../../artboardview.h \
+    scenegenerator.h
@@ -0,0 +1,972 @@
+// ---------------------------------------------------------------------------
+// 描述: FishplateArtboard 的基准测试。用合成场景（见 SceneGenerator）测量绘制、点击测试、
+//       移动/旋转/缩放命令、撤销/重做、命令日志、.fpa 读写和整图渲染的耗时。
+//       除绘制外都直接操作 ArtboardDocument，不需要显示器；绘制在 offscreen 平台上进行。
+//
+//       用法: bench [QtTest 选项] [基准名[:数据行]]...
+//       结果按 QtTest 的格式输出，回归跟踪使用机器可读的格式，例如
+//           bench -o results.xml,xml      或      bench -o results.csv,csv
+//       场景类的基准有 "1k" 和 "10k" 两个数据行（场景中的图形数）；整体保存的吞吐量另外测量
+//       "10k"、"100k" 和 "1M" 三行，并用 saveBaseline 测量改写前的逐行 JSON 保存作为对照。
+//       有对照的基准把两种做法放在同一个基准的不同数据行中，直接比较同一次运行的结果：
+//       paintBackground 的 "cached" / "uncached"（背景图缓存），editShape 的 "tile" / "full"
+//       （单个图形改变后按瓦片失效还是整个场景失效），hitTestOutline 的 "stroker" / "analytic"
+//       （QPainterPathStroker 描边与几何内核的点击测试，按图形类型分行）。
+//       addPoint 按笔画长度分为 "1k"、"10k"、"100k" 三行，每行的总时间应与点数成正比。
+//       笔画类的基准（折线简化、曲线拟合）默认使用合成的笔画；设置环境变量 FISHPLATE_BENCH_RECORDING
+//       为 InputRecorder 的录制文件时另外增加一行 "recorded"，使用录制中真实的鼠标轨迹。
+//       这些基准用 qInfo 额外输出几何数据的变化，例如 "12800 -> 3075 points (24.0%)"。
+//       strokeRender / strokeSave 用同样的笔画组成自由曲线和橡皮擦路径的文档，"raw" 行保留全部采样点，
+//       "simplified" 行按 StrokeTolerance 简化，两行的差即为简化对绘制和保存的加速。
+//       图形记录的编码基准 (recordEncode / recordDecode) 比较 JSON 文本和 ShapeCodec 的 CBOR 记录，
+//       另外用 qInfo 输出两种格式的总字节数；设置环境变量 FISHPLATE_BENCH_DOCUMENT 为一个 .fpa 文件时
+//       另外增加使用其中真实图形的数据行。
+// ---------------------------------------------------------------------------
+
+#include "artboarddocument.h"
+#include "artboardview.h"
+#include "abstractshape.h"
+#include "backgroundcache.h"
+#include "backgroundpyramid.h"
+#include "curvefitter.h"
+#include "eraserpathshape.h"
+#include "fpadatabase.h"
+#include "freehandpathshape.h"
+#include "lineshape.h"
+#include "movemultipleshapescommand.h"
+#include "resizecommand.h"
+#include "rotatecommand.h"
+#include "geometrykernels.h"
+#include "scenegenerator.h"
+#include "shapecodec.h"
+#include "starshape.h"
+#include <QApplication>
+#include <QImage>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLinearGradient>
+#include <QLoggingCategory>
+#include <QPainterPath>
+#include <QPainterPathStroker>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+#include <QtMath>
+#include <QtTest>
+#include <functional>
+
+namespace {
+
+const QSize CanvasSize(1920, 1080);
+const int CommandsPerIteration = 100;
+const int GeneratedStrokeCount = 200;
+const qreal StrokeTolerance = 1.0; // 与 ArtboardView 的默认简化容差相同
+const qreal CurveTolerance = 1.0;  // 与 ArtboardView 的默认拟合容差相同
+const QSize BackgroundImageSize(6000, 4000);
+const int OutlineShapeCount = 200;
+const int PointsPerOutlineShape = 16;
+
+QVector<AbstractShape*> generateScene(int shapeCount)
+{
+    SceneGenerator generator(CanvasSize);
+    return generator.generate(SceneGenerator::mixed(shapeCount));
+}
+
+// 每次都从同一个种子生成，各个基准使用的场景相同
+void populate(ArtboardDocument *document, int shapeCount)
+{
+    document->setCanvasSize(CanvasSize);
+    document->replaceAllShapes(generateScene(shapeCount));
+}
+
+// 从文档中均匀取出 count 个满足条件的图形
+QList<AbstractShape*> sampleShapes(const ArtboardDocument &document, int count,
+                                   const std::function<bool(const AbstractShape*)> &accept = nullptr)
+{
+    QList<AbstractShape*> candidates;
+    for (AbstractShape *shape : document.shapes()) {
+        if (!accept || accept(shape)) {
+            candidates.append(shape);
+        }
+    }
+    QList<AbstractShape*> sample;
+    if (candidates.isEmpty()) {
+        return sample;
+    }
+    const int step = qMax(1, int(candidates.size()) / count);
+    for (int i = 0; i < candidates.size() && sample.size() < count; i += step) {
+        sample.append(candidates.at(i));
+    }
+    return sample;
+}
+
+// 笔画类基准的输入：recording 非空时读取录制文件，否则生成 GeneratedStrokeCount 条 length 个点的笔画
+QVector<QVector<QPoint>> benchStrokes(int length, const QString &recording)
+{
+    if (!recording.isEmpty()) {
+        return SceneGenerator::recordedStrokes(recording);
+    }
+    SceneGenerator generator(CanvasSize, 11);
+    QVector<QVector<QPoint>> strokes;
+    for (int i = 0; i < GeneratedStrokeCount; ++i) {
+        strokes.append(generator.stroke(length));
+    }
+    return strokes;
+}
+
+int totalPoints(const QVector<QVector<QPoint>> &strokes)
+{
+    int total = 0;
+    for (const QVector<QPoint> &stroke : strokes) {
+        total += stroke.size();
+    }
+    return total;
+}
+
+// 笔画组成的文档：自由曲线和橡皮擦路径交替排列；tolerance 大于 0 时与提交笔画时一样先简化
+QVector<AbstractShape*> strokeShapes(const QVector<QVector<QPoint>> &strokes, qreal tolerance)
+{
+    QVector<AbstractShape*> shapes;
+    for (int i = 0; i < strokes.size(); ++i) {
+        const QVector<QPoint> points = tolerance > 0.0 ? GeometryKernels::simplifyPolyline(strokes.at(i), tolerance)
+                                                       : strokes.at(i);
+        if (i % 4 == 3) {
+            shapes.append(new EraserPathShape(points, 16, Qt::white));
+        } else {
+            shapes.append(new FreehandPathShape(points, QColor(40, 40, 40), 2));
+        }
+    }
+    return shapes;
+}
+
+int totalPoints(const QVector<AbstractShape*> &shapes)
+{
+    int total = 0;
+    for (const AbstractShape *shape : shapes) {
+        total += shape->getType() == ShapeType::Freehand
+                     ? static_cast<const FreehandPathShape*>(shape)->getPoints().size()
+                     : static_cast<const EraserPathShape*>(shape)->getPoints().size();
+    }
+    return total;
+}
+
+void reportReduction(int before, int after, const char *unit)
+{
+    qInfo().noquote() << QString("%1: %2 -> %3 %4 (%5%)").arg(QTest::currentDataTag()).arg(before).arg(after)
+                         .arg(unit).arg(before > 0 ? 100.0 * after / before : 0.0, 0, 'f', 1);
+}
+
+// 编码基准的输入：document 非空时读取其中的全部图形记录，否则使用 shapeCount 个图形的合成场景
+QVector<QJsonObject> benchRecords(int shapeCount, const QString &document)
+{
+    QVector<QJsonObject> records;
+    if (!document.isEmpty()) {
+        FpaDatabase db("bench_records");
+        if (db.open(document)) {
+            db.readShapes([&records](const FpaDatabase::ShapeRow &row) {
+                records.append(row.data.isEmpty() ? QJsonDocument::fromJson(row.jsonData.toUtf8()).object()
+                                                  : ShapeCodec::decode(row.data));
+                return true;
+            });
+        }
+        return records;
+    }
+    const QVector<AbstractShape*> shapes = generateScene(shapeCount);
+    for (AbstractShape *shape : shapes) {
+        records.append(shape->toJsonObject());
+        delete shape;
+    }
+    return records;
+}
+
+// 一条记录按 format（"json" 或 "cbor"）编码后的字节，与写入文件的内容相同
+QByteArray encodeRecord(const QJsonObject &record, const QString &format)
+{
+    return format == "json" ? QJsonDocument(record).toJson(QJsonDocument::Compact) : ShapeCodec::encode(record);
+}
+
+QJsonObject decodeRecord(const QByteArray &data, const QString &format)
+{
+    return format == "json" ? QJsonDocument::fromJson(data).object() : ShapeCodec::decode(data);
+}
+
+// 改写前的保存方式：每个图形一条 JSON 文本，每行重新 prepare INSERT，默认的回滚日志。
+// 只用于与 saveFull 对照，不写 z_order、区域索引和文件摘要。
+bool baselineSave(const QVector<AbstractShape*> &shapes, const QString &filePath)
+{
+    bool ok = true;
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "bench_baseline");
+        db.setDatabaseName(filePath);
+        if (!db.open()) {
+            qWarning() << "Error: Failed to connect to database." << db.lastError();
+            ok = false;
+        } else {
+            QSqlQuery query(db);
+            query.exec("CREATE TABLE IF NOT EXISTS shapes (id INTEGER PRIMARY KEY, type TEXT, json_data TEXT)");
+            db.transaction();
+            query.exec("DELETE FROM shapes");
+            for (AbstractShape *shape : shapes) {
+                const QJsonObject json = shape->toJsonObject();
+                query.prepare("INSERT INTO shapes (type, json_data) VALUES (:type, :json)");
+                query.bindValue(":type", json["type"].toString());
+                query.bindValue(":json", QString(QJsonDocument(json).toJson(QJsonDocument::Compact)));
+                if (!query.exec()) {
+                    ok = false;
+                    break;
+                }
+            }
+            if (ok) {
+                ok = db.commit();
+            } else {
+                db.rollback();
+            }
+            db.close();
+        }
+    }
+    QSqlDatabase::removeDatabase("bench_baseline");
+    return ok;
+}
+
+// 有内容的大背景图，缩放的开销与照片相近
+QImage backgroundImage()
+{
+    QImage image(BackgroundImageSize, QImage::Format_ARGB32_Premultiplied);
+    QPainter painter(&image);
+    QLinearGradient gradient(0, 0, image.width(), image.height());
+    gradient.setColorAt(0, QColor(30, 90, 160));
+    gradient.setColorAt(1, QColor(240, 200, 120));
+    painter.fillRect(image.rect(), gradient);
+    SceneGenerator generator(BackgroundImageSize, 5);
+    for (int i = 0; i < 2000; ++i) {
+        painter.fillRect(QRect(generator.point(), QSize(40, 40)), QColor::fromHsv((i * 37) % 360, 160, 220));
+    }
+    return image;
+}
+
+QPolygonF starVertices(const QRectF &rect, int numPoints)
+{
+    const QRectF bounds = rect.normalized();
+    const qreal outerRadius = qMin(bounds.width(), bounds.height()) / 2.0;
+    QPolygonF vertices;
+    for (int i = 0; i < numPoints * 2; ++i) {
+        const qreal radius = i % 2 == 0 ? outerRadius : outerRadius * 0.45;
+        const qreal angle = -M_PI / 2.0 + i * M_PI / numPoints;
+        vertices.append(bounds.center() + QPointF(radius * qCos(angle), radius * qSin(angle)));
+    }
+    return vertices;
+}
+
+// 改写前未填充图形的点击测试：每次都构造轮廓、按线宽 + 4 描边，再对逆旋转后的点求包含
+bool strokerContains(const AbstractShape *shape, const QPoint &point)
+{
+    QPainterPath outline;
+    switch (shape->getType()) {
+    case ShapeType::Line: {
+        const LineShape *line = static_cast<const LineShape*>(shape);
+        outline.moveTo(line->getStartPoint());
+        outline.lineTo(line->getEndPoint());
+        break;
+    }
+    case ShapeType::Rectangle:
+        outline.addRect(shape->getCoreGeometry());
+        break;
+    case ShapeType::Ellipse:
+        outline.addEllipse(shape->getCoreGeometry());
+        break;
+    case ShapeType::Star:
+        outline.addPolygon(starVertices(shape->getCoreGeometry(), static_cast<const StarShape*>(shape)->getNumPoints()));
+        outline.closeSubpath();
+        break;
+    case ShapeType::Freehand: {
+        const QVector<QPoint> &points = static_cast<const FreehandPathShape*>(shape)->getPoints();
+        outline.moveTo(points.first());
+        for (int i = 1; i < points.size(); ++i) {
+            outline.lineTo(points.at(i));
+        }
+        break;
+    }
+    default:
+        return false;
+    }
+    const QPointF center = shape->getCenter();
+    QTransform transform;
+    transform.translate(center.x(), center.y());
+    transform.rotate(shape->getRotationAngle());
+    transform.translate(-center.x(), -center.y());
+    QPainterPathStroker stroker;
+    stroker.setWidth(shape->getPenWidth() + 4.0);
+    return stroker.createStroke(outline).contains(transform.inverted().map(QPointF(point)));
+}
+
+// OutlineShapeCount 个未填充、带旋转的 type 类图形
+QVector<AbstractShape*> outlineShapes(ShapeType type)
+{
+    SceneGenerator generator(CanvasSize, 13);
+    QVector<AbstractShape*> shapes;
+    for (int i = 0; i < OutlineShapeCount; ++i) {
+        AbstractShape *shape = nullptr;
+        switch (type) {
+        case ShapeType::Line: shape = generator.line(); break;
+        case ShapeType::Rectangle: shape = generator.rectangle(); break;
+        case ShapeType::Ellipse: shape = generator.ellipse(); break;
+        case ShapeType::Star: shape = generator.star(); break;
+        default: shape = generator.freehand(64); break;
+        }
+        shape->setFilled(false);
+        shape->setRotationAngle((i * 37) % 360);
+        shapes.append(shape);
+    }
+    return shapes;
+}
+
+// 每个图形包围盒内的若干个点：点击测试在空间索引筛选之后进行，候选点都靠近图形
+QVector<QPair<AbstractShape*, QPoint>> outlineProbes(const QVector<AbstractShape*> &shapes)
+{
+    QRandomGenerator random(17);
+    QVector<QPair<AbstractShape*, QPoint>> probes;
+    for (AbstractShape *shape : shapes) {
+        const QRect bounds = shape->getDamageRect();
+        for (int i = 0; i < PointsPerOutlineShape; ++i) {
+            probes.append(qMakePair(shape, QPoint(bounds.left() + random.bounded(qMax(1, bounds.width())),
+                                                  bounds.top() + random.bounded(qMax(1, bounds.height())))));
+        }
+    }
+    return probes;
+}
+
+bool isResizable(const AbstractShape *shape)
+{
+    const ShapeType type = shape->getType();
+    return type == ShapeType::Rectangle || type == ShapeType::Ellipse || type == ShapeType::Star;
+}
+
+}
+
+class BenchArtboard : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void paintCold_data() { sceneSizes(); }
+    void paintCold();
+    void paintWarm_data() { sceneSizes(); }
+    void paintWarm();
+    void paintBackground_data();
+    void paintBackground();
+    void editShape_data();
+    void editShape();
+
+    void containsPoint_data() { sceneSizes(); }
+    void containsPoint();
+    void hitTest_data() { sceneSizes(); }
+    void hitTest();
+    void hitTestOutline_data();
+    void hitTestOutline();
+
+    void moveCommands_data() { sceneSizes(); }
+    void moveCommands();
+    void rotateCommands_data() { sceneSizes(); }
+    void rotateCommands();
+    void resizeCommands_data() { sceneSizes(); }
+    void resizeCommands();
+    void undoRedo_data() { sceneSizes(); }
+    void undoRedo();
+    void journaledCommands_data() { sceneSizes(); }
+    void journaledCommands();
+
+    void saveFull_data() { saveSizes(); }
+    void saveFull();
+    void saveBaseline_data() { saveSizes(); }
+    void saveBaseline();
+    void saveIncremental_data() { sceneSizes(); }
+    void saveIncremental();
+    void load_data() { sceneSizes(); }
+    void load();
+
+    void renderToImage_data() { sceneSizes(); }
+    void renderToImage();
+
+    void strokeSimplification_data() { strokeSources(); }
+    void strokeSimplification();
+    void strokeRender_data() { strokeDocumentSources(); }
+    void strokeRender();
+    void strokeSave_data() { strokeDocumentSources(); }
+    void strokeSave();
+    void curveFitting_data() { strokeSources(); }
+    void curveFitting();
+    void addPoint_data();
+    void addPoint();
+
+    void recordEncode_data() { recordSources(); }
+    void recordEncode();
+    void recordDecode_data() { recordSources(); }
+    void recordDecode();
+
+private:
+    void sceneSizes();
+    void saveSizes();
+    void strokeSources();
+    void strokeDocumentSources();
+    void recordSources();
+
+    QTemporaryDir m_dir;
+};
+
+void BenchArtboard::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+}
+
+void BenchArtboard::sceneSizes()
+{
+    QTest::addColumn<int>("shapeCount");
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("10k") << 10000;
+}
+
+// 保存吞吐量的场景规模。1M 行需要较多的内存和时间，只运行较小的行时用 "bench saveFull:10k"
+void BenchArtboard::saveSizes()
+{
+    QTest::addColumn<int>("shapeCount");
+    QTest::newRow("10k") << 10000;
+    QTest::newRow("100k") << 100000;
+    QTest::newRow("1M") << 1000000;
+}
+
+void BenchArtboard::strokeSources()
+{
+    QTest::addColumn<int>("strokeLength");
+    QTest::addColumn<QString>("recording");
+    QTest::newRow("64 points") << 64 << QString();
+    QTest::newRow("1k points") << 1000 << QString();
+    const QString recording = qEnvironmentVariable("FISHPLATE_BENCH_RECORDING");
+    if (!recording.isEmpty()) {
+        QTest::newRow("recorded") << 0 << recording;
+    }
+}
+
+// strokeSources 的每个来源各有 "raw"（不简化）和 "simplified"（StrokeTolerance）两行
+void BenchArtboard::strokeDocumentSources()
+{
+    QTest::addColumn<int>("strokeLength");
+    QTest::addColumn<QString>("recording");
+    QTest::addColumn<qreal>("tolerance");
+    for (const qreal tolerance : { 0.0, StrokeTolerance }) {
+        const char *mode = tolerance > 0.0 ? "simplified" : "raw";
+        QTest::addRow("64 points %s", mode) << 64 << QString() << tolerance;
+        QTest::addRow("1k points %s", mode) << 1000 << QString() << tolerance;
+        const QString recording = qEnvironmentVariable("FISHPLATE_BENCH_RECORDING");
+        if (!recording.isEmpty()) {
+            QTest::addRow("recorded %s", mode) << 0 << recording << tolerance;
+        }
+    }
+}
+
+void BenchArtboard::paintBackground_data()
+{
+    QTest::addColumn<bool>("cached");
+    QTest::newRow("cached") << true;
+    QTest::newRow("uncached") << false;
+}
+
+// 大场景中的单个图形改变：tile 只重绘它覆盖的瓦片，full 对照整个场景失效后重绘
+void BenchArtboard::editShape_data()
+{
+    QTest::addColumn<int>("shapeCount");
+    QTest::addColumn<bool>("fullInvalidate");
+    QTest::newRow("10k tile") << 10000 << false;
+    QTest::newRow("10k full") << 10000 << true;
+    QTest::newRow("100k tile") << 100000 << false;
+    QTest::newRow("100k full") << 100000 << true;
+}
+
+void BenchArtboard::hitTestOutline_data()
+{
+    QTest::addColumn<int>("shapeType");
+    QTest::addColumn<bool>("stroker");
+    const QVector<QPair<const char*, ShapeType>> types = {
+        { "line", ShapeType::Line }, { "rectangle", ShapeType::Rectangle }, { "ellipse", ShapeType::Ellipse },
+        { "star", ShapeType::Star }, { "freehand", ShapeType::Freehand } };
+    for (const auto &type : types) {
+        QTest::addRow("%s stroker", type.first) << int(type.second) << true;
+        QTest::addRow("%s analytic", type.first) << int(type.second) << false;
+    }
+}
+
+void BenchArtboard::addPoint_data()
+{
+    QTest::addColumn<int>("strokeLength");
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("10k") << 10000;
+    QTest::newRow("100k") << 100000;
+}
+
+void BenchArtboard::recordSources()
+{
+    QTest::addColumn<int>("shapeCount");
+    QTest::addColumn<QString>("document");
+    QTest::addColumn<QString>("format");
+    for (const char *format : { "json", "cbor" }) {
+        QTest::addRow("1k %s", format) << 1000 << QString() << QString(format);
+        QTest::addRow("10k %s", format) << 10000 << QString() << QString(format);
+    }
+    const QString document = qEnvironmentVariable("FISHPLATE_BENCH_DOCUMENT");
+    if (!document.isEmpty()) {
+        QTest::newRow("document json") << 0 << document << QString("json");
+        QTest::newRow("document cbor") << 0 << document << QString("cbor");
+    }
+}
+
+// 整个画布的场景缓存失效后重绘：栅格化所有瓦片
+void BenchArtboard::paintCold()
+{
+    QFETCH(int, shapeCount);
+    ArtboardView view;
+    view.resize(CanvasSize);
+    view.document()->replaceAllShapes(generateScene(shapeCount));
+    view.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&view));
+    QImage target(CanvasSize, QImage::Format_ARGB32_Premultiplied);
+
+    QBENCHMARK {
+        view.document()->invalidateScene();
+        view.render(&target);
+    }
+}
+
+// 缓存有效时的重绘：贴瓦片和选择装饰，对应拖动时的每一帧
+void BenchArtboard::paintWarm()
+{
+    QFETCH(int, shapeCount);
+    ArtboardView view;
+    view.resize(CanvasSize);
+    view.document()->replaceAllShapes(generateScene(shapeCount));
+    view.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&view));
+    view.document()->setSelectedShapes(sampleShapes(*view.document(), 1));
+    QImage target(CanvasSize, QImage::Format_ARGB32_Premultiplied);
+    view.render(&target);
+
+    QBENCHMARK {
+        view.render(&target);
+    }
+}
+
+// 拖动时的一帧背景：cached 使用 BackgroundCache 中缩放好的结果，uncached 与改写前一样每帧平滑缩放原图
+void BenchArtboard::paintBackground()
+{
+    QFETCH(bool, cached);
+    const QImage image = backgroundImage();
+    BackgroundPyramid pyramid(image);
+    BackgroundCache cache;
+    cache.setPyramid(&pyramid);
+    QImage target(CanvasSize, QImage::Format_ARGB32_Premultiplied);
+
+    QBENCHMARK {
+        QPainter painter(&target);
+        if (cached) {
+            const QImage &scaled = cache.scaledImage(CanvasSize, 1.0, Qt::SmoothTransformation);
+            painter.drawImage(BackgroundCache::centeredOffset(CanvasSize, scaled), scaled);
+        } else {
+            const QImage scaled = image.scaled(CanvasSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+            painter.drawImage(BackgroundCache::centeredOffset(CanvasSize, scaled), scaled);
+        }
+    }
+}
+
+void BenchArtboard::editShape()
+{
+    QFETCH(int, shapeCount);
+    QFETCH(bool, fullInvalidate);
+    ArtboardView view;
+    view.resize(CanvasSize);
+    view.document()->replaceAllShapes(generateScene(shapeCount));
+    view.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&view));
+    const QList<AbstractShape*> shapes = sampleShapes(*view.document(), 1);
+    QVERIFY(!shapes.isEmpty());
+    QImage target(CanvasSize, QImage::Format_ARGB32_Premultiplied);
+    view.render(&target);
+
+    int step = 3;
+    QBENCHMARK {
+        view.document()->executeCommand(new MoveMultipleShapesCommand(shapes, QPoint(step, step), view.document()));
+        if (fullInvalidate) {
+            view.document()->invalidateScene();
+        }
+        view.render(&target);
+        step = -step; // 来回移动，图形留在原处附近
+    }
+}
+
+// 逐个图形做精确的点击测试，不经过空间索引
+void BenchArtboard::containsPoint()
+{
+    QFETCH(int, shapeCount);
+    ArtboardDocument document;
+    populate(&document, shapeCount);
+    SceneGenerator generator(CanvasSize, 7);
+    QVector<QPoint> points;
+    for (int i = 0; i < 100; ++i) {
+        points.append(generator.point());
+    }
+
+    int hits = 0;
+    QBENCHMARK {
+        for (const QPoint &point : points) {
+            for (AbstractShape *shape : document.shapes()) {
+                hits += shape->containsPoint(point) ? 1 : 0;
+            }
+        }
+    }
+    QVERIFY(hits >= 0);
+}
+
+// 经过空间索引的点击测试，与选择工具的点击相同
+void BenchArtboard::hitTest()
+{
+    QFETCH(int, shapeCount);
+    ArtboardDocument document;
+    populate(&document, shapeCount);
+    SceneGenerator generator(CanvasSize, 7);
+    QVector<QPoint> points;
+    for (int i = 0; i < 1000; ++i) {
+        points.append(generator.point());
+    }
+
+    int hits = 0;
+    QBENCHMARK {
+        for (const QPoint &point : points) {
+            hits += document.shapeAt(point) ? 1 : 0;
+        }
+    }
+    QVERIFY(hits >= 0);
+}
+
+// 一类未填充图形的点击测试：stroker 是改写前的描边做法，analytic 是 containsPoint 中的几何内核
+void BenchArtboard::hitTestOutline()
+{
+    QFETCH(int, shapeType);
+    QFETCH(bool, stroker);
+    const QVector<AbstractShape*> shapes = outlineShapes(ShapeType(shapeType));
+    const QVector<QPair<AbstractShape*, QPoint>> probes = outlineProbes(shapes);
+
+    int hits = 0;
+    QBENCHMARK {
+        hits = 0;
+        for (const auto &probe : probes) {
+            hits += (stroker ? strokerContains(probe.first, probe.second) : probe.first->containsPoint(probe.second)) ? 1 : 0;
+        }
+    }
+    qInfo().noquote() << QString("%1: %2 of %3 points hit").arg(QTest::currentDataTag()).arg(hits).arg(probes.size());
+    qDeleteAll(shapes);
+}
+
+void BenchArtboard::moveCommands()
+{
+    QFETCH(int, shapeCount);
+    ArtboardDocument document;
+    populate(&document, shapeCount);
+    const QList<AbstractShape*> shapes = sampleShapes(document, CommandsPerIteration);
+
+    QBENCHMARK {
+        for (AbstractShape *shape : shapes) {
+            document.executeCommand(new MoveMultipleShapesCommand({ shape }, QPoint(3, 2), &document));
+        }
+    }
+}
+
+void BenchArtboard::rotateCommands()
+{
+    QFETCH(int, shapeCount);
+    ArtboardDocument document;
+    populate(&document, shapeCount);
+    const QList<AbstractShape*> shapes = sampleShapes(document, CommandsPerIteration);
+
+    QBENCHMARK {
+        for (AbstractShape *shape : shapes) {
+            const qreal angle = shape->getRotationAngle();
+            document.executeCommand(new RotateCommand(shape, &document, angle, angle + 7.5));
+        }
+    }
+}
+
+void BenchArtboard::resizeCommands()
+{
+    QFETCH(int, shapeCount);
+    ArtboardDocument document;
+    populate(&document, shapeCount);
+    const QList<AbstractShape*> shapes = sampleShapes(document, CommandsPerIteration, isResizable);
+
+    int grow = 1;
+    QBENCHMARK {
+        for (AbstractShape *shape : shapes) {
+            const QRect rect = shape->getCoreGeometry().toRect();
+            document.executeCommand(new ResizeCommand(shape, &document, rect, rect.adjusted(0, 0, grow, grow)));
+        }
+        grow = -grow; // 交替放大和缩小，图形大小保持稳定
+    }
+}
+
+void BenchArtboard::undoRedo()
+{
+    QFETCH(int, shapeCount);
+    ArtboardDocument document;
+    populate(&document, shapeCount);
+    for (AbstractShape *shape : sampleShapes(document, CommandsPerIteration)) {
+        document.executeCommand(new MoveMultipleShapesCommand({ shape }, QPoint(3, 2), &document));
+    }
+
+    QBENCHMARK {
+        for (int i = 0; i < CommandsPerIteration; ++i) {
+            document.undo();
+        }
+        for (int i = 0; i < CommandsPerIteration; ++i) {
+            document.redo();
+        }
+    }
+    QVERIFY(document.canUndo());
+}
+
+// 与 moveCommands 相同，但每个命令都追加到命令日志中
+void BenchArtboard::journaledCommands()
+{
+    QFETCH(int, shapeCount);
+    ArtboardDocument document;
+    populate(&document, shapeCount);
+    document.setRecoveryJournalPath(m_dir.filePath(QString("journal-%1.fpa-journal").arg(shapeCount)), false);
+    const QList<AbstractShape*> shapes = sampleShapes(document, CommandsPerIteration);
+
+    QBENCHMARK {
+        for (AbstractShape *shape : shapes) {
+            document.executeCommand(new MoveMultipleShapesCommand({ shape }, QPoint(3, 2), &document));
+        }
+    }
+}
+
+// 每次保存到新文件，写入全部图形
+void BenchArtboard::saveFull()
+{
+    QFETCH(int, shapeCount);
+    ArtboardDocument document;
+    populate(&document, shapeCount);
+
+    int run = 0;
+    QBENCHMARK {
+        QVERIFY(document.saveToDatabase(m_dir.filePath(QString("full-%1-%2.fpa").arg(shapeCount).arg(run++))));
+    }
+}
+
+// 与 saveFull 相同的场景，用改写前的方式保存
+void BenchArtboard::saveBaseline()
+{
+    QFETCH(int, shapeCount);
+    ArtboardDocument document;
+    populate(&document, shapeCount);
+
+    int run = 0;
+    QBENCHMARK {
+        QVERIFY(baselineSave(document.shapes(), m_dir.filePath(QString("baseline-%1-%2.fpa").arg(shapeCount).arg(run++))));
+    }
+}
+
+// 保存过一次之后移动少量图形再保存，只写入变化的部分
+void BenchArtboard::saveIncremental()
+{
+    QFETCH(int, shapeCount);
+    ArtboardDocument document;
+    populate(&document, shapeCount);
+    const QString filePath = m_dir.filePath(QString("incremental-%1.fpa").arg(shapeCount));
+    QVERIFY(document.saveToDatabase(filePath));
+    const QList<AbstractShape*> shapes = sampleShapes(document, 10);
+
+    QBENCHMARK {
+        for (AbstractShape *shape : shapes) {
+            document.executeCommand(new MoveMultipleShapesCommand({ shape }, QPoint(3, 2), &document));
+        }
+        QVERIFY(document.saveToDatabase(filePath));
+    }
+}
+
+void BenchArtboard::load()
+{
+    QFETCH(int, shapeCount);
+    const QString filePath = m_dir.filePath(QString("load-%1.fpa").arg(shapeCount));
+    {
+        ArtboardDocument document;
+        populate(&document, shapeCount);
+        QVERIFY(document.saveToDatabase(filePath));
+    }
+
+    ArtboardDocument document;
+    QBENCHMARK {
+        QVERIFY(document.loadFromDatabase(filePath));
+    }
+    QCOMPARE(int(document.shapes().size()), SceneGenerator::mixed(shapeCount).total());
+}
+
+void BenchArtboard::renderToImage()
+{
+    QFETCH(int, shapeCount);
+    ArtboardDocument document;
+    populate(&document, shapeCount);
+
+    QBENCHMARK {
+        const QImage image = document.renderToImage();
+        QVERIFY(!image.isNull());
+    }
+}
+
+// 提交笔画时的 Ramer–Douglas–Peucker 简化（ArtboardView::simplifyCommittedStroke）
+void BenchArtboard::strokeSimplification()
+{
+    QFETCH(int, strokeLength);
+    QFETCH(QString, recording);
+    const QVector<QVector<QPoint>> strokes = benchStrokes(strokeLength, recording);
+    QVERIFY2(!strokes.isEmpty(), "no strokes in the recording");
+
+    int simplifiedPoints = 0;
+    QBENCHMARK {
+        simplifiedPoints = 0;
+        for (const QVector<QPoint> &stroke : strokes) {
+            simplifiedPoints += GeometryKernels::simplifyPolyline(stroke, StrokeTolerance).size();
+        }
+    }
+    reportReduction(totalPoints(strokes), simplifiedPoints, "points");
+}
+
+// 绘制笔画组成的整个文档
+void BenchArtboard::strokeRender()
+{
+    QFETCH(int, strokeLength);
+    QFETCH(QString, recording);
+    QFETCH(qreal, tolerance);
+    const QVector<QVector<QPoint>> strokes = benchStrokes(strokeLength, recording);
+    QVERIFY2(!strokes.isEmpty(), "no strokes in the recording");
+    ArtboardDocument document;
+    document.setCanvasSize(CanvasSize);
+    document.replaceAllShapes(strokeShapes(strokes, tolerance));
+
+    QBENCHMARK {
+        const QImage image = document.renderToImage();
+        QVERIFY(!image.isNull());
+    }
+    reportReduction(totalPoints(strokes), totalPoints(document.shapes()), "points");
+}
+
+// 与 saveFull 相同，保存笔画组成的文档
+void BenchArtboard::strokeSave()
+{
+    QFETCH(int, strokeLength);
+    QFETCH(QString, recording);
+    QFETCH(qreal, tolerance);
+    const QVector<QVector<QPoint>> strokes = benchStrokes(strokeLength, recording);
+    QVERIFY2(!strokes.isEmpty(), "no strokes in the recording");
+    ArtboardDocument document;
+    document.setCanvasSize(CanvasSize);
+    document.replaceAllShapes(strokeShapes(strokes, tolerance));
+    const QString name = QString(QTest::currentDataTag()).replace(' ', '-');
+
+    int run = 0;
+    QBENCHMARK {
+        QVERIFY(document.saveToDatabase(m_dir.filePath(QString("strokes-%1-%2.fpa").arg(name).arg(run++))));
+    }
+}
+
+// 提交笔画时的曲线拟合（FreehandPathShape::fitCurves）。每段曲线记 3 个点（两个控制点和终点），再加上起点
+void BenchArtboard::curveFitting()
+{
+    QFETCH(int, strokeLength);
+    QFETCH(QString, recording);
+    const QVector<QVector<QPoint>> strokes = benchStrokes(strokeLength, recording);
+    QVERIFY2(!strokes.isEmpty(), "no strokes in the recording");
+
+    int curvePoints = 0;
+    QBENCHMARK {
+        curvePoints = 0;
+        for (const QVector<QPoint> &stroke : strokes) {
+            const int segments = CurveFitter::fit(stroke, CurveTolerance).size();
+            curvePoints += segments > 0 ? 3 * segments + 1 : 0;
+        }
+    }
+    reportReduction(totalPoints(strokes), curvePoints, "curve points");
+}
+
+// 绘制笔画时逐点添加，每个点之后视图取一次重绘区域；与点数成正比说明 addPoint 是均摊 O(1)
+void BenchArtboard::addPoint()
+{
+    QFETCH(int, strokeLength);
+    SceneGenerator generator(CanvasSize, 11);
+    const QVector<QPoint> stroke = generator.stroke(strokeLength);
+
+    QRect damage;
+    QBENCHMARK {
+        FreehandPathShape shape({ stroke.first() }, Qt::black, 2);
+        for (int i = 1; i < stroke.size(); ++i) {
+            shape.addPoint(stroke.at(i));
+            damage = shape.getDamageRect();
+        }
+    }
+    QVERIFY(!damage.isEmpty());
+}
+
+// 保存时把图形记录编码为文件中的格式；输出编码后的总字节数
+void BenchArtboard::recordEncode()
+{
+    QFETCH(int, shapeCount);
+    QFETCH(QString, document);
+    QFETCH(QString, format);
+    const QVector<QJsonObject> records = benchRecords(shapeCount, document);
+    QVERIFY2(!records.isEmpty(), "no shape records");
+
+    qint64 bytes = 0;
+    QBENCHMARK {
+        bytes = 0;
+        for (const QJsonObject &record : records) {
+            bytes += encodeRecord(record, format).size();
+        }
+    }
+    qInfo().noquote() << QString("%1: %2 records, %3 bytes (%4 bytes per record)").arg(QTest::currentDataTag())
+                         .arg(records.size()).arg(bytes).arg(double(bytes) / records.size(), 0, 'f', 1);
+}
+
+// 载入时把文件中的记录解码为 JSON 对象，不包括随后创建图形的部分
+void BenchArtboard::recordDecode()
+{
+    QFETCH(int, shapeCount);
+    QFETCH(QString, document);
+    QFETCH(QString, format);
+    QVector<QByteArray> encoded;
+    for (const QJsonObject &record : benchRecords(shapeCount, document)) {
+        encoded.append(encodeRecord(record, format));
+    }
+    QVERIFY2(!encoded.isEmpty(), "no shape records");
+
+    int decoded = 0;
+    QBENCHMARK {
+        decoded = 0;
+        for (const QByteArray &data : encoded) {
+            decoded += decodeRecord(data, format).isEmpty() ? 0 : 1;
+        }
+    }
+    QCOMPARE(decoded, int(encoded.size()));
+}
+
+int main(int argc, char *argv[])
+{
+    // 不连接任何显示服务器
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+    // 保存和命令的调试输出会淹没测量结果
+    QLoggingCategory::setFilterRules("default.debug=false");
+    BenchArtboard bench;
+    return QTest::qExec(&bench, argc, argv);
+}
+
+#include "benchartboard.moc"
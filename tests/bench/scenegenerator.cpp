@@ -0,0 +1,204 @@
+#include "scenegenerator.h"
+#include "ellipseshape.h"
+#include "eraserpathshape.h"
+#include "freehandpathshape.h"
+#include "groupshape.h"
+#include "lineshape.h"
+#include "rectangleshape.h"
+#include "starshape.h"
+#include <QColor>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QtMath>
+#include <algorithm>
+
+namespace {
+
+enum Kind { Line, Rectangle, Ellipse, Star, Freehand, Eraser, Group };
+
+}
+
+int SceneGenerator::Spec::total() const
+{
+    return lines + rectangles + ellipses + stars + freehands + erasers + groups;
+}
+
+SceneGenerator::Spec SceneGenerator::mixed(int shapeCount, int strokeLength)
+{
+    // 自由曲线最多，其次是基本图形；编组和橡皮擦较少
+    Spec spec;
+    spec.freehands = shapeCount * 40 / 100;
+    spec.lines = shapeCount * 15 / 100;
+    spec.rectangles = shapeCount * 12 / 100;
+    spec.ellipses = shapeCount * 12 / 100;
+    spec.stars = shapeCount * 6 / 100;
+    spec.erasers = shapeCount * 10 / 100;
+    spec.groups = qMax(1, shapeCount * 5 / 100);
+    spec.strokeLength = strokeLength;
+    return spec;
+}
+
+SceneGenerator::SceneGenerator(const QSize &canvasSize, quint32 seed)
+    : m_canvasSize(canvasSize),
+    m_random(seed)
+{
+}
+
+QVector<AbstractShape*> SceneGenerator::generate(const Spec &spec)
+{
+    QVector<int> kinds;
+    kinds.reserve(spec.total());
+    kinds.insert(kinds.end(), spec.lines, Line);
+    kinds.insert(kinds.end(), spec.rectangles, Rectangle);
+    kinds.insert(kinds.end(), spec.ellipses, Ellipse);
+    kinds.insert(kinds.end(), spec.stars, Star);
+    kinds.insert(kinds.end(), spec.freehands, Freehand);
+    kinds.insert(kinds.end(), spec.erasers, Eraser);
+    kinds.insert(kinds.end(), spec.groups, Group);
+    // 打乱顺序，使各类图形在 z 顺序中交错
+    for (int i = kinds.size() - 1; i > 0; --i) {
+        std::swap(kinds[i], kinds[m_random.bounded(i + 1)]);
+    }
+
+    QVector<AbstractShape*> shapes;
+    shapes.reserve(kinds.size());
+    for (int kind : kinds) {
+        switch (kind) {
+        case Line: shapes.append(line()); break;
+        case Rectangle: shapes.append(rectangle()); break;
+        case Ellipse: shapes.append(ellipse()); break;
+        case Star: shapes.append(star()); break;
+        case Freehand: shapes.append(freehand(spec.strokeLength)); break;
+        case Eraser: shapes.append(eraser(spec.strokeLength)); break;
+        case Group: shapes.append(group(spec.groupDepth, spec.groupFanout)); break;
+        }
+    }
+    return shapes;
+}
+
+AbstractShape *SceneGenerator::line()
+{
+    const QRectF rect = randomRect(8, 300);
+    return new LineShape(rect.topLeft().toPoint(), rect.bottomRight().toPoint(), randomColor(), randomPenWidth());
+}
+
+AbstractShape *SceneGenerator::rectangle()
+{
+    const bool filled = m_random.bounded(2) == 0;
+    return new RectangleShape(randomRect(8, 240), randomColor(), randomPenWidth(), filled, randomColor());
+}
+
+AbstractShape *SceneGenerator::ellipse()
+{
+    const bool filled = m_random.bounded(2) == 0;
+    return new EllipseShape(randomRect(8, 240), randomColor(), randomPenWidth(), filled, randomColor());
+}
+
+AbstractShape *SceneGenerator::star()
+{
+    const bool filled = m_random.bounded(2) == 0;
+    return new StarShape(randomRect(16, 200), randomColor(), randomPenWidth(), filled, randomColor(),
+                         5 + m_random.bounded(4));
+}
+
+AbstractShape *SceneGenerator::freehand(int length)
+{
+    return new FreehandPathShape(stroke(length), randomColor(), randomPenWidth());
+}
+
+AbstractShape *SceneGenerator::eraser(int length)
+{
+    return new EraserPathShape(stroke(length), 8 + m_random.bounded(24), Qt::white);
+}
+
+AbstractShape *SceneGenerator::group(int depth, int fanout)
+{
+    QList<AbstractShape*> children;
+    for (int i = 0; i < fanout; ++i) {
+        if (depth > 1) {
+            children.append(group(depth - 1, fanout));
+            continue;
+        }
+        switch (m_random.bounded(4)) {
+        case 0: children.append(line()); break;
+        case 1: children.append(rectangle()); break;
+        case 2: children.append(ellipse()); break;
+        default: children.append(star()); break;
+        }
+    }
+    return new GroupShape(children);
+}
+
+QPoint SceneGenerator::point()
+{
+    return QPoint(m_random.bounded(qMax(1, m_canvasSize.width())), m_random.bounded(qMax(1, m_canvasSize.height())));
+}
+
+QRectF SceneGenerator::randomRect(int minSide, int maxSide)
+{
+    const int width = minSide + m_random.bounded(maxSide - minSide + 1);
+    const int height = minSide + m_random.bounded(maxSide - minSide + 1);
+    const int x = m_random.bounded(qMax(1, m_canvasSize.width() - width));
+    const int y = m_random.bounded(qMax(1, m_canvasSize.height() - height));
+    return QRectF(x, y, width, height);
+}
+
+// 随机游走的笔画：方向缓慢变化，步长与真实的鼠标采样间隔相近
+QVector<QPoint> SceneGenerator::stroke(int length)
+{
+    QVector<QPoint> points;
+    points.reserve(qMax(2, length));
+    QPointF position = point();
+    qreal heading = m_random.bounded(2.0 * M_PI);
+    for (int i = 0; i < qMax(2, length); ++i) {
+        points.append(position.toPoint());
+        heading += m_random.bounded(0.6) - 0.3;
+        const qreal step = 2.0 + m_random.bounded(6.0);
+        position += QPointF(qCos(heading) * step, qSin(heading) * step);
+        position.setX(qBound<qreal>(0, position.x(), m_canvasSize.width() - 1));
+        position.setY(qBound<qreal>(0, position.y(), m_canvasSize.height() - 1));
+    }
+    return points;
+}
+
+QVector<QVector<QPoint>> SceneGenerator::recordedStrokes(const QString &filePath)
+{
+    QVector<QVector<QPoint>> strokes;
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return strokes;
+    }
+    file.readLine(); // 文件头
+
+    QVector<QPoint> current;
+    bool pressed = false;
+    while (!file.atEnd()) {
+        const QJsonObject event = QJsonDocument::fromJson(file.readLine()).object();
+        const QString type = event.value("type").toString();
+        const QPoint position = QPointF(event.value("x").toDouble(), event.value("y").toDouble()).toPoint();
+        if (type == "press" && event.value("button").toInt() == Qt::LeftButton) {
+            current = { position };
+            pressed = true;
+        } else if (type == "move" && pressed) {
+            current.append(position);
+        } else if (type == "release" && pressed && event.value("button").toInt() == Qt::LeftButton) {
+            current.append(position);
+            pressed = false;
+            if (current.size() > 2) {
+                strokes.append(current);
+            }
+        }
+    }
+    return strokes;
+}
+
+QColor SceneGenerator::randomColor()
+{
+    return QColor::fromRgb(m_random.bounded(256), m_random.bounded(256), m_random.bounded(256));
+}
+
+int SceneGenerator::randomPenWidth()
+{
+    return 1 + m_random.bounded(8);
+}
@@ -0,0 +1,72 @@
+#ifndef SCENEGENERATOR_H
+#define SCENEGENERATOR_H
+
+// ---------------------------------------------------------------------------
+// 描述: 定义了基准测试使用的合成场景生成器 SceneGenerator。
+//       按给定数量生成直线、矩形、椭圆、星形、自由曲线、橡皮擦路径和多层嵌套的编组，
+//       位置、大小和颜色来自固定种子的随机数，同样的参数总是得到同样的场景，
+//       不同版本之间的测量结果可以直接比较。
+// ---------------------------------------------------------------------------
+
+#include <QRandomGenerator>
+#include <QSize>
+#include <QString>
+#include <QVector>
+
+class AbstractShape;
+
+class SceneGenerator
+{
+public:
+    /// @brief 场景的组成。各类图形的数量彼此独立，编组内的图形另外计算。
+    struct Spec {
+        int lines = 0;
+        int rectangles = 0;
+        int ellipses = 0;
+        int stars = 0;
+        int freehands = 0;
+        int strokeLength = 64;  ///< 每条自由曲线和橡皮擦路径的点数。
+        int erasers = 0;
+        int groups = 0;
+        int groupDepth = 2;     ///< 编组的嵌套层数，1 表示编组内只有普通图形。
+        int groupFanout = 4;    ///< 每层编组包含的子项数。
+
+        int total() const;
+    };
+
+    /// @brief 总数约为 shapeCount 的混合场景，各类图形的比例接近手绘的画布。
+    static Spec mixed(int shapeCount, int strokeLength = 64);
+
+    explicit SceneGenerator(const QSize &canvasSize, quint32 seed = 20240611);
+
+    /// @brief 按 spec 生成图形，调用方获得所有权。顺序即 z 顺序，各类图形交错排列。
+    QVector<AbstractShape*> generate(const Spec &spec);
+
+    AbstractShape *line();
+    AbstractShape *rectangle();
+    AbstractShape *ellipse();
+    AbstractShape *star();
+    AbstractShape *freehand(int length);
+    AbstractShape *eraser(int length);
+    /// @brief depth 层嵌套的编组，每层 fanout 个子项，最内层是普通图形。
+    AbstractShape *group(int depth, int fanout);
+
+    /// @brief 画布内的一个随机点，用于点击测试。
+    QPoint point();
+    /// @brief length 个采样点的随机笔画，相邻两点相距 2～8 像素，方向缓慢变化，与手绘时的鼠标采样相近。
+    QVector<QPoint> stroke(int length);
+
+    /// @brief 从 InputRecorder 的录制文件（格式见 inputrecorder.h）中取出每次左键按下到松开之间的鼠标轨迹，
+    /// 不区分录制时使用的工具。文件无法读取时返回空列表。
+    static QVector<QVector<QPoint>> recordedStrokes(const QString &filePath);
+
+private:
+    QRectF randomRect(int minSide, int maxSide);
+    QColor randomColor();
+    int randomPenWidth();
+
+    QSize m_canvasSize;
+    QRandomGenerator m_random;
+};
+
+#endif // SCENEGENERATOR_H
@@ -0,0 +1,21 @@
+#include "unittests.h"
+#include <QApplication>
+#include <QLoggingCategory>
+
+int main(int argc, char *argv[])
+{
+    // 不连接任何显示服务器
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+    // 保存和命令的调试输出会淹没测试结果
+    QLoggingCategory::setFilterRules("default.debug=false");
+
+    int failures = 0;
+    failures += runHitTests(argc, argv);
+    failures += runFreehandTests(argc, argv);
+    failures += runFpaDatabaseTests(argc, argv);
+    failures += runDocumentTests(argc, argv);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,262 @@
+// ---------------------------------------------------------------------------
+// 描述: ArtboardDocument 的保存和命令日志。
+//       后台保存写入的是请求保存那一刻的内容，之后的编辑不影响正在进行的写入；
+//       写入进行中再次请求的保存排在它之后，两次都通过 saveFinished 报告。
+//       程序意外退出（这里在文档仍然打开时复制日志和文件来模拟）之后，
+//       重放日志得到与退出前相同的画布，Put、Translate 和 Remove 按发生的顺序生效。
+//       分页打开的文件只载入一部分图形，新图形的 ID 不能与没有载入的行冲突。
+// ---------------------------------------------------------------------------
+
+#include "unittests.h"
+#include "abstractshape.h"
+#include "addshapecommand.h"
+#include "artboarddocument.h"
+#include "deleteshapecommand.h"
+#include "fpadatabase.h"
+#include "movemultipleshapescommand.h"
+#include "rectangleshape.h"
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QtTest>
+
+namespace {
+
+AbstractShape *addRectangle(ArtboardDocument *document, int x, int y = 10)
+{
+    AbstractShape *shape = new RectangleShape(QRectF(x, y, 40, 30), Qt::black, 2);
+    document->executeCommand(new AddShapeCommand(shape, document));
+    return shape;
+}
+
+void moveShape(ArtboardDocument *document, AbstractShape *shape, const QPoint &offset)
+{
+    document->executeCommand(new MoveMultipleShapesCommand({ shape }, offset, document));
+}
+
+void deleteShape(ArtboardDocument *document, AbstractShape *shape)
+{
+    document->executeCommand(new DeleteShapeCommand(shape, document, document->zOrderOf(shape)));
+}
+
+// 按 z 顺序列出每个图形的 ID 和位置，用于比较两个文档的内容
+QStringList describe(const ArtboardDocument &document)
+{
+    QStringList shapes;
+    for (const AbstractShape *shape : document.shapes()) {
+        const QRect rect = shape->getBoundingRect();
+        shapes.append(QString("%1@%2,%3").arg(shape->getId()).arg(rect.x()).arg(rect.y()));
+    }
+    return shapes;
+}
+
+// 依次产生 Put、Translate、Remove，其中有对同一个图形先放置再移动、先移动再删除的情况，
+// 重放时顺序错了就会得到不同的结果
+void editWithEveryOp(ArtboardDocument *document)
+{
+    AbstractShape *first = addRectangle(document, 10);
+    AbstractShape *second = addRectangle(document, 60);
+    moveShape(document, first, QPoint(5, 7));
+    AbstractShape *third = addRectangle(document, 110);
+    deleteShape(document, second);
+    moveShape(document, third, QPoint(-3, 20));
+    moveShape(document, first, QPoint(1, 1));
+    addRectangle(document, 160);
+}
+
+bool copyFile(const QString &from, const QString &to)
+{
+    QFile::remove(to);
+    return QFile::copy(from, to);
+}
+
+int rowsIn(const QString &filePath)
+{
+    FpaDatabase db("row_count");
+    return db.open(filePath) ? db.shapeCount() : -1;
+}
+
+}
+
+class TestDocument : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void asyncSaveWritesSnapshot();
+    void asyncSaveQueuesWhileWriting();
+    void replayUnsavedJournal();
+    void replayJournalOnSavedFile();
+    void checkpointOnlyForExistingFile();
+    void pagedSaveAddsRow();
+
+private:
+    QTemporaryDir m_dir;
+};
+
+void TestDocument::asyncSaveWritesSnapshot()
+{
+    const QString filePath = m_dir.filePath("snapshot.fpa");
+    ArtboardDocument document;
+    addRectangle(&document, 10);
+    addRectangle(&document, 60);
+    QSignalSpy finished(&document, &ArtboardDocument::saveFinished);
+
+    QVERIFY(document.saveToDatabaseAsync(filePath));
+    // 快照之后的编辑不属于这次保存
+    addRectangle(&document, 110);
+    QVERIFY(finished.wait());
+    QCOMPARE(finished.count(), 1);
+    QCOMPARE(finished.at(0).at(0).toBool(), true);
+    QCOMPARE(rowsIn(filePath), 2);
+
+    QVERIFY(document.saveToDatabaseAsync(filePath));
+    QVERIFY(finished.wait());
+    QCOMPARE(rowsIn(filePath), 3);
+    // 完成信号只发出一次
+    QTest::qWait(50);
+    QCOMPARE(finished.count(), 2);
+}
+
+void TestDocument::asyncSaveQueuesWhileWriting()
+{
+    const QString filePath = m_dir.filePath("queued.fpa");
+    ArtboardDocument document;
+    for (int i = 0; i < 200; ++i) {
+        addRectangle(&document, i * 5);
+    }
+    QSignalSpy finished(&document, &ArtboardDocument::saveFinished);
+
+    QVERIFY(document.saveToDatabaseAsync(filePath));
+    addRectangle(&document, 0);
+    // 第一次写入还在进行：不等待，排队
+    QVERIFY(document.saveToDatabaseAsync(filePath));
+    QVERIFY(document.isSaving());
+    QTRY_COMPARE(finished.count(), 2);
+    QVERIFY(!document.isSaving());
+    QCOMPARE(finished.at(1).at(0).toBool(), true);
+    QCOMPARE(rowsIn(filePath), 201);
+}
+
+// 从未保存过的画布：恢复日志中包含全部编辑
+void TestDocument::replayUnsavedJournal()
+{
+    const QString journalPath = m_dir.filePath("unsaved-journal");
+    const QString crashedPath = m_dir.filePath("unsaved-crashed-journal");
+    ArtboardDocument document;
+    QCOMPARE(document.setRecoveryJournalPath(journalPath, false), 0);
+    editWithEveryOp(&document);
+    // 文档没有关闭，日志停在最后一个命令之后：相当于程序在这里被强行结束
+    QVERIFY(copyFile(journalPath, crashedPath));
+
+    ArtboardDocument recovered;
+    QSignalSpy replayed(&recovered, &ArtboardDocument::journalReplayed);
+    QVERIFY(recovered.setRecoveryJournalPath(crashedPath, true) > 0);
+    QCOMPARE(replayed.count(), 1);
+    QCOMPARE(describe(recovered), describe(document));
+}
+
+// 保存过的文件：只重放检查点之后的记录
+void TestDocument::replayJournalOnSavedFile()
+{
+    const QString filePath = m_dir.filePath("saved.fpa");
+    const QString crashedPath = m_dir.filePath("saved-crashed.fpa");
+    ArtboardDocument document;
+    document.setCheckpointInterval(0);
+    AbstractShape *base = addRectangle(&document, 300);
+    addRectangle(&document, 350);
+    QVERIFY(document.saveToDatabase(filePath));
+
+    editWithEveryOp(&document);
+    moveShape(&document, base, QPoint(0, 40));
+    deleteShape(&document, base);
+    QVERIFY(copyFile(filePath, crashedPath));
+    QVERIFY(copyFile(ArtboardDocument::journalPathFor(filePath), ArtboardDocument::journalPathFor(crashedPath)));
+
+    ArtboardDocument recovered;
+    QSignalSpy replayed(&recovered, &ArtboardDocument::journalReplayed);
+    QVERIFY(recovered.loadFromDatabase(crashedPath));
+    QCOMPARE(replayed.count(), 1);
+    QCOMPARE(describe(recovered), describe(document));
+
+    // 重放之后再保存，文件本身就包含了这些编辑
+    QVERIFY(recovered.saveToDatabase(crashedPath));
+    ArtboardDocument reopened;
+    QVERIFY(reopened.loadFromDatabase(crashedPath));
+    QCOMPARE(describe(reopened), describe(document));
+}
+
+void TestDocument::checkpointOnlyForExistingFile()
+{
+    ArtboardDocument unsaved;
+    unsaved.setRecoveryJournalPath(m_dir.filePath("checkpoint-journal"), false);
+    unsaved.setCheckpointInterval(3);
+    for (int i = 0; i < 5; ++i) {
+        addRectangle(&unsaved, i * 50);
+    }
+    QVERIFY(!unsaved.isSaving());
+
+    const QString filePath = m_dir.filePath("checkpoint.fpa");
+    ArtboardDocument document;
+    document.setCheckpointInterval(3);
+    addRectangle(&document, 0);
+    QVERIFY(document.saveToDatabase(filePath));
+    QSignalSpy finished(&document, &ArtboardDocument::saveFinished);
+    for (int i = 1; i <= 3; ++i) {
+        addRectangle(&document, i * 50);
+    }
+    QVERIFY(document.isSaving());
+    QVERIFY(finished.wait());
+    QCOMPARE(rowsIn(filePath), 4);
+
+    // 文件被删除后不再自动保存：检查点不会变成全量写入
+    QVERIFY(QFile::remove(filePath));
+    for (int i = 4; i <= 6; ++i) {
+        addRectangle(&document, i * 50);
+    }
+    QVERIFY(!document.isSaving());
+    QVERIFY(!QFile::exists(filePath));
+}
+
+void TestDocument::pagedSaveAddsRow()
+{
+    const QString filePath = m_dir.filePath("paged.fpa");
+    const QSize canvasSize(400, 300);
+    {
+        ArtboardDocument document;
+        document.setCanvasSize(canvasSize);
+        for (int i = 0; i < 20; ++i) {
+            addRectangle(&document, i * 20, 10);
+            addRectangle(&document, 5000 + i * 20, 5000); // 远离画布，分页打开时不载入
+        }
+        QVERIFY(document.saveToDatabase(filePath));
+    }
+
+    ArtboardDocument paged;
+    paged.setPagedMode(true);
+    paged.setCanvasSize(canvasSize);
+    QVERIFY(paged.loadFromDatabase(filePath));
+    QVERIFY(paged.isPagedDocument());
+    QCOMPARE(int(paged.shapes().size()), 20);
+
+    AbstractShape *added = addRectangle(&paged, 100, 100);
+    QVERIFY(paged.saveToDatabase(filePath));
+    QCOMPARE(rowsIn(filePath), 41);
+
+    // 保存之后载入的图形可以释放；撤销栈中的命令引用的新图形保留
+    paged.evictPagedShapes(QRect(-10000, -10000, 1, 1));
+    QCOMPARE(int(paged.shapes().size()), 1);
+    QCOMPARE(paged.shapes().first(), added);
+
+    ArtboardDocument reopened;
+    QVERIFY(reopened.loadFromDatabase(filePath));
+    QCOMPARE(int(reopened.shapes().size()), 41);
+}
+
+int runDocumentTests(int argc, char *argv[])
+{
+    TestDocument test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_document.moc"
@@ -0,0 +1,143 @@
+// ---------------------------------------------------------------------------
+// 描述: .fpa 文件的表结构升级。
+//       版本 1 的文件（只有 id、type、json_data 三列）在第一次写入时升级；
+//       升级与写入在同一个事务中，回滚后文件保持原来的版本和表结构。
+//       增量写入后的内容摘要与完整写入同样内容的摘要相同。
+// ---------------------------------------------------------------------------
+
+#include "unittests.h"
+#include "artboarddocument.h"
+#include "fpadatabase.h"
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+#include <QtTest>
+
+namespace {
+
+// 按版本 1 的格式写一个只有一个矩形的文件
+bool writeVersion1File(const QString &filePath)
+{
+    bool ok = false;
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "version1_writer");
+        db.setDatabaseName(filePath);
+        if (db.open()) {
+            QSqlQuery query(db);
+            ok = query.exec("CREATE TABLE shapes (id INTEGER PRIMARY KEY, type TEXT, json_data TEXT)")
+                 && query.exec("INSERT INTO shapes (type, json_data) VALUES ('Rectangle', "
+                               "'{\"type\":\"Rectangle\",\"pen_width\":2,\"border_color\":\"#000000\","
+                               "\"geometry\":{\"x\":10,\"y\":10,\"width\":50,\"height\":30}}')");
+            db.close();
+        }
+    }
+    QSqlDatabase::removeDatabase("version1_writer");
+    return ok;
+}
+
+}
+
+class TestFpaDatabase : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void rolledBackUpgradeKeepsVersion();
+    void saveUpgradesVersion();
+    void incrementalHashMatchesFull();
+
+private:
+    QTemporaryDir m_dir;
+};
+
+void TestFpaDatabase::rolledBackUpgradeKeepsVersion()
+{
+    const QString filePath = m_dir.filePath("rollback.fpa");
+    QVERIFY(writeVersion1File(filePath));
+
+    {
+        FpaDatabase db("rollback_test");
+        QVERIFY(db.open(filePath));
+        QCOMPARE(db.schemaVersion(), 0);
+        QVERIFY(db.prepareForWriting());
+        // 模拟写入途中失败
+        db.rollback();
+        QCOMPARE(db.schemaVersion(), 0);
+    }
+
+    FpaDatabase db("rollback_check");
+    QVERIFY(db.open(filePath));
+    QCOMPARE(db.schemaVersion(), 0);
+    QCOMPARE(db.shapeCount(), 1);
+    QSqlQuery query(QSqlDatabase::database("rollback_check"));
+    QVERIFY(!query.exec("SELECT z_order FROM shapes"));
+}
+
+void TestFpaDatabase::saveUpgradesVersion()
+{
+    const QString filePath = m_dir.filePath("upgrade.fpa");
+    QVERIFY(writeVersion1File(filePath));
+
+    ArtboardDocument document;
+    QVERIFY(document.loadFromDatabase(filePath));
+    QCOMPARE(int(document.shapes().size()), 1);
+    QVERIFY(document.saveToDatabase(filePath));
+
+    FpaDatabase db("upgrade_check");
+    QVERIFY(db.open(filePath));
+    QCOMPARE(db.schemaVersion(), int(FpaDatabase::SchemaVersion));
+    QCOMPARE(db.documentInfo().schemaVersion, int(FpaDatabase::SchemaVersion));
+    QCOMPARE(db.shapeCount(), 1);
+}
+
+void TestFpaDatabase::incrementalHashMatchesFull()
+{
+    const QString incrementalPath = m_dir.filePath("incremental.fpa");
+    const QString fullPath = m_dir.filePath("full.fpa");
+    const QRect bounds(0, 0, 10, 10);
+
+    {
+        FpaDatabase db("hash_first");
+        QVERIFY(db.open(incrementalPath));
+        QVERIFY(db.prepareForWriting());
+        QVERIFY(db.deleteAllShapes());
+        QVERIFY(db.upsertShape(1, 100, "Rectangle", "one", bounds));
+        QVERIFY(db.upsertShape(2, 200, "Rectangle", "two", bounds));
+        QVERIFY(db.upsertShape(3, 300, "Rectangle", "three", bounds));
+        QVERIFY(db.commit());
+    }
+    {
+        // 增量写入：改写、删除、调整顺序都要先减去旧行的摘要
+        FpaDatabase db("hash_second");
+        QVERIFY(db.open(incrementalPath));
+        QVERIFY(db.prepareForWriting());
+        QVERIFY(db.upsertShape(2, 200, "Rectangle", "two, edited", bounds));
+        QVERIFY(db.deleteShape(3));
+        QVERIFY(db.updateZOrder(1, 400));
+        QVERIFY(db.commit());
+    }
+    {
+        FpaDatabase db("hash_full");
+        QVERIFY(db.open(fullPath));
+        QVERIFY(db.prepareForWriting());
+        QVERIFY(db.deleteAllShapes());
+        QVERIFY(db.upsertShape(2, 200, "Rectangle", "two, edited", bounds));
+        QVERIFY(db.upsertShape(1, 400, "Rectangle", "one", bounds));
+        QVERIFY(db.commit());
+    }
+
+    FpaDatabase incremental("hash_incremental_check");
+    QVERIFY(incremental.open(incrementalPath));
+    FpaDatabase full("hash_full_check");
+    QVERIFY(full.open(fullPath));
+    QVERIFY(!full.documentInfo().contentHash.isEmpty());
+    QCOMPARE(incremental.documentInfo().contentHash, full.documentInfo().contentHash);
+}
+
+int runFpaDatabaseTests(int argc, char *argv[])
+{
+    TestFpaDatabase test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_fpadatabase.moc"
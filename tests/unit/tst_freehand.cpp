@@ -0,0 +1,145 @@
+// ---------------------------------------------------------------------------
+// 描述: 自由曲线的提交和曲线拟合。
+//       笔画通过 ArtboardView 的鼠标事件绘制，与交互时走同一条路径：
+//       开启拟合时松开鼠标后笔画被拟合为少量贝塞尔曲线段；拟合默认关闭，只做折线简化。
+// ---------------------------------------------------------------------------
+
+#include "unittests.h"
+#include "artboardview.h"
+#include "freehandpathshape.h"
+#include <QMouseEvent>
+#include <QtMath>
+#include <QtTest>
+#include <memory>
+
+namespace {
+
+const QPointF ArcCenter(300, 300);
+const qreal ArcRadius = 150;
+
+void sendMouse(ArtboardView *view, QEvent::Type type, const QPoint &position, Qt::MouseButtons buttons)
+{
+    QMouseEvent event(type, QPointF(position), view->mapToGlobal(QPointF(position)), Qt::LeftButton, buttons, Qt::NoModifier);
+    QCoreApplication::sendEvent(view, &event);
+}
+
+// 沿半圆弧拖动鼠标画一笔，采样间隔约 2.4 像素，与快速拖动时的鼠标采样相近
+void drawArc(ArtboardView *view, int samples)
+{
+    QVector<QPoint> points;
+    for (int i = 0; i <= samples; ++i) {
+        const qreal angle = M_PI * i / samples;
+        points.append((ArcCenter + QPointF(qCos(angle), -qSin(angle)) * ArcRadius).toPoint());
+    }
+    sendMouse(view, QEvent::MouseButtonPress, points.first(), Qt::LeftButton);
+    for (int i = 1; i < points.size(); ++i) {
+        sendMouse(view, QEvent::MouseMove, points.at(i), Qt::LeftButton);
+    }
+    sendMouse(view, QEvent::MouseButtonRelease, points.last(), Qt::NoButton);
+}
+
+FreehandPathShape *committedStroke(ArtboardView *view)
+{
+    const auto &shapes = view->document()->shapes();
+    if (shapes.size() != 1 || shapes.first()->getType() != ShapeType::Freehand) {
+        return nullptr;
+    }
+    return static_cast<FreehandPathShape*>(shapes.first());
+}
+
+}
+
+class TestFreehand : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void commitFitsCurves();
+    void commitWithoutFitting();
+    void curveHitTest();
+    void curveJsonRoundTrip();
+};
+
+void TestFreehand::commitFitsCurves()
+{
+    ArtboardView view;
+    view.resize(800, 600);
+    view.setCurveFittingTolerance(ArtboardView::DefaultCurveFittingTolerance);
+    view.setCurrentShape(ShapeType::Freehand);
+    drawArc(&view, 200);
+
+    FreehandPathShape *stroke = committedStroke(&view);
+    QVERIFY(stroke);
+    QVERIFY(stroke->hasCurves());
+    QVERIFY(stroke->getPoints().isEmpty());
+    // 半圆用 1 像素的容差拟合，几段三次曲线就足够；远少于 200 个采样点
+    QVERIFY2(stroke->getCurves().size() >= 1 && stroke->getCurves().size() <= 8,
+             qPrintable(QString("%1 curves").arg(stroke->getCurves().size())));
+
+    // 曲线的包围盒与圆弧一致，不包含伸出去的控制点
+    const QRect bounds = stroke->getBoundingRect();
+    QVERIFY(qAbs(bounds.top() - (ArcCenter.y() - ArcRadius)) <= 2);
+    QVERIFY(qAbs(bounds.left() - (ArcCenter.x() - ArcRadius)) <= 2);
+    QVERIFY(qAbs(bounds.right() - (ArcCenter.x() + ArcRadius)) <= 2);
+}
+
+void TestFreehand::commitWithoutFitting()
+{
+    ArtboardView view;
+    view.resize(800, 600);
+    QCOMPARE(view.curveFittingTolerance(), 0.0);
+    view.setCurrentShape(ShapeType::Freehand);
+    drawArc(&view, 200);
+
+    FreehandPathShape *stroke = committedStroke(&view);
+    QVERIFY(stroke);
+    QVERIFY(!stroke->hasCurves());
+    QVERIFY(stroke->getPoints().size() > 2);
+    QVERIFY(stroke->getPoints().size() < 200);
+}
+
+void TestFreehand::curveHitTest()
+{
+    ArtboardView view;
+    view.resize(800, 600);
+    view.setCurveFittingTolerance(ArtboardView::DefaultCurveFittingTolerance);
+    view.setCurrentShape(ShapeType::Freehand);
+    drawArc(&view, 200);
+    FreehandPathShape *stroke = committedStroke(&view);
+    QVERIFY(stroke && stroke->hasCurves());
+
+    const QPoint top = QPointF(ArcCenter.x(), ArcCenter.y() - ArcRadius).toPoint();
+    QVERIFY(stroke->containsPoint(top));
+    QVERIFY(!stroke->containsPoint(ArcCenter.toPoint()));
+
+    // 平移后展平的折线重新计算
+    stroke->moveBy(QPoint(40, 0));
+    QVERIFY(stroke->containsPoint(top + QPoint(40, 0)));
+    QVERIFY(!stroke->containsPoint(top + QPoint(0, 20)));
+}
+
+void TestFreehand::curveJsonRoundTrip()
+{
+    ArtboardView view;
+    view.resize(800, 600);
+    view.setCurveFittingTolerance(ArtboardView::DefaultCurveFittingTolerance);
+    view.setCurrentShape(ShapeType::Freehand);
+    drawArc(&view, 200);
+    FreehandPathShape *stroke = committedStroke(&view);
+    QVERIFY(stroke && stroke->hasCurves());
+
+    std::unique_ptr<AbstractShape> copy(AbstractShape::fromJsonObject(stroke->toJsonObject()));
+    QVERIFY(copy && copy->getType() == ShapeType::Freehand);
+    FreehandPathShape *freehand = static_cast<FreehandPathShape*>(copy.get());
+    QCOMPARE(freehand->getCurves().size(), stroke->getCurves().size());
+    // 坐标保留两位小数，包围盒最多相差一个像素
+    QVERIFY(stroke->getBoundingRect().adjusted(-1, -1, 1, 1).contains(freehand->getBoundingRect()));
+}
+
+int runFreehandTests(int argc, char *argv[])
+{
+    TestFreehand test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_freehand.moc"
@@ -0,0 +1,132 @@
+// ---------------------------------------------------------------------------
+// 描述: 图形的点击测试 (containsPoint)。
+//       填充的矩形、椭圆和星形在整个外接矩形内命中；未填充的只在轮廓附近
+//       (线宽/2 + 2 像素) 命中，内部和远处的点都不命中。旋转后的图形按旋转后的位置判断。
+// ---------------------------------------------------------------------------
+
+#include "unittests.h"
+#include "ellipseshape.h"
+#include "lineshape.h"
+#include "rectangleshape.h"
+#include "starshape.h"
+#include <QtTest>
+#include <memory>
+
+namespace {
+
+const QRectF ShapeRect(100, 100, 200, 100);
+
+AbstractShape *createShape(ShapeType type, bool filled)
+{
+    switch (type) {
+    case ShapeType::Rectangle:
+        return new RectangleShape(ShapeRect, Qt::black, 4, filled, Qt::red);
+    case ShapeType::Ellipse:
+        return new EllipseShape(ShapeRect, Qt::black, 4, filled, Qt::red);
+    case ShapeType::Star:
+        return new StarShape(ShapeRect, Qt::black, 4, filled, Qt::red);
+    default:
+        return nullptr;
+    }
+}
+
+}
+
+class TestHitTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void filledShapes_data();
+    void filledShapes();
+    void unfilledShapes_data();
+    void unfilledShapes();
+    void rotatedRectangle();
+    void line();
+};
+
+void TestHitTest::filledShapes_data()
+{
+    QTest::addColumn<int>("type");
+    QTest::addColumn<QPoint>("point");
+    QTest::addColumn<bool>("hit");
+
+    const QList<QPair<const char*, ShapeType>> types = {
+        { "rectangle", ShapeType::Rectangle },
+        { "ellipse", ShapeType::Ellipse },
+        { "star", ShapeType::Star },
+    };
+    for (const auto &type : types) {
+        const QByteArray name(type.first);
+        QTest::newRow(name + " center") << int(type.second) << QPoint(200, 150) << true;
+        // 外接矩形的角落不在椭圆和星形的内部，但填充的图形按外接矩形命中
+        QTest::newRow(name + " corner") << int(type.second) << QPoint(103, 103) << true;
+        QTest::newRow(name + " outside") << int(type.second) << QPoint(50, 50) << false;
+        QTest::newRow(name + " just outside") << int(type.second) << QPoint(200, 205) << false;
+    }
+}
+
+void TestHitTest::filledShapes()
+{
+    QFETCH(int, type);
+    QFETCH(QPoint, point);
+    QFETCH(bool, hit);
+    std::unique_ptr<AbstractShape> shape(createShape(ShapeType(type), true));
+    QVERIFY(shape);
+    QCOMPARE(shape->containsPoint(point), hit);
+}
+
+void TestHitTest::unfilledShapes_data()
+{
+    QTest::addColumn<int>("type");
+    QTest::addColumn<QPoint>("point");
+    QTest::addColumn<bool>("hit");
+
+    // 矩形和椭圆的轮廓都经过外接矩形各边的中点；星形的第一个顶点在顶边中点
+    QTest::newRow("rectangle edge") << int(ShapeType::Rectangle) << QPoint(200, 101) << true;
+    QTest::newRow("rectangle near edge") << int(ShapeType::Rectangle) << QPoint(299, 150) << true;
+    QTest::newRow("rectangle inside") << int(ShapeType::Rectangle) << QPoint(200, 150) << false;
+    QTest::newRow("rectangle interior off edge") << int(ShapeType::Rectangle) << QPoint(200, 110) << false;
+    QTest::newRow("ellipse top") << int(ShapeType::Ellipse) << QPoint(200, 101) << true;
+    QTest::newRow("ellipse right") << int(ShapeType::Ellipse) << QPoint(298, 150) << true;
+    QTest::newRow("ellipse inside") << int(ShapeType::Ellipse) << QPoint(200, 150) << false;
+    QTest::newRow("ellipse corner") << int(ShapeType::Ellipse) << QPoint(103, 103) << false;
+    QTest::newRow("star tip") << int(ShapeType::Star) << QPoint(200, 101) << true;
+    QTest::newRow("star inside") << int(ShapeType::Star) << QPoint(200, 150) << false;
+    QTest::newRow("star corner") << int(ShapeType::Star) << QPoint(103, 103) << false;
+}
+
+void TestHitTest::unfilledShapes()
+{
+    QFETCH(int, type);
+    QFETCH(QPoint, point);
+    QFETCH(bool, hit);
+    std::unique_ptr<AbstractShape> shape(createShape(ShapeType(type), false));
+    QVERIFY(shape);
+    QCOMPARE(shape->containsPoint(point), hit);
+}
+
+void TestHitTest::rotatedRectangle()
+{
+    RectangleShape shape(ShapeRect, Qt::black, 4, true, Qt::red);
+    shape.setRotationAngle(90);
+    // 绕中心 (200, 150) 旋转 90 度后，外接矩形变为 (150, 50) - (250, 250)
+    QVERIFY(shape.containsPoint(QPoint(200, 60)));
+    QVERIFY(!shape.containsPoint(QPoint(120, 150)));
+}
+
+void TestHitTest::line()
+{
+    LineShape shape(QPoint(0, 0), QPoint(100, 0), Qt::black, 4);
+    QVERIFY(shape.containsPoint(QPoint(50, 3)));
+    QVERIFY(!shape.containsPoint(QPoint(50, 10)));
+    QVERIFY(!shape.containsPoint(QPoint(120, 0)));
+}
+
+int runHitTests(int argc, char *argv[])
+{
+    TestHitTest test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_hittest.moc"
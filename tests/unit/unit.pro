@@ -0,0 +1,26 @@
+# ---------------------------------------------------------------------------
+# unit：FishplateArtboard 的单元测试（QtTest）。
+# 每个 tst_*.cpp 测试一个方面，main.cpp 依次运行它们，任何一项失败时退出码非零。
+# 需要 ArtboardView 的测试（鼠标绘制）在 offscreen 平台上进行，其余只用 fishplatecore。
+# ---------------------------------------------------------------------------
+
+QT += widgets testlib
+
+CONFIG += console c++17 testcase
+CONFIG -= app_bundle
+
+TARGET = unit
+
+include(../../fishplatecore.pri)
+
+SOURCES += \
+    ../../artboardview.cpp \
+    main.cpp \
+    tst_document.cpp \
+    tst_fpadatabase.cpp \
+    tst_freehand.cpp \
+    tst_hittest.cpp
+
+HEADERS += \
+    ../../artboardview.h \
+    unittests.h
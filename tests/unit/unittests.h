@@ -0,0 +1,13 @@
+#ifndef UNITTESTS_H
+#define UNITTESTS_H
+
+// ---------------------------------------------------------------------------
+// 描述: 各个 tst_*.cpp 的入口。每个函数运行一个 QtTest 测试类，返回失败的测试数。
+// ---------------------------------------------------------------------------
+
+int runDocumentTests(int argc, char *argv[]);
+int runFpaDatabaseTests(int argc, char *argv[]);
+int runFreehandTests(int argc, char *argv[]);
+int runHitTests(int argc, char *argv[]);
+
+#endif // UNITTESTS_H
@@ -0,0 +1,133 @@
+#include "batchrenderer.h"
+#include "abstractshape.h"
+#include "backgroundpyramid.h"
+#include "documentloader.h"
+#include "fpadatabase.h"
+#include "sceneexporter.h"
+#include "shapespatialindex.h"
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <algorithm>
+
+BatchRenderer::BatchRenderer(const Options &options)
+    : m_options(options)
+{
+}
+
+QVector<BatchRenderer::Result> BatchRenderer::renderAll(const QStringList &files,
+                                                        const std::function<void(const Result &)> &finished) const
+{
+    QThreadPool pool;
+    pool.setMaxThreadCount(qMax(1, m_options.jobs));
+    // 文件足够多时核心已经被文件占满，条带不再并行
+    const bool parallelBands = files.size() == 1;
+    QMutex mutex;
+    return QtConcurrent::blockingMapped<QVector<Result>>(&pool, files, [&](const QString &filePath) {
+        const Result result = renderFile(filePath, parallelBands);
+        if (finished) {
+            QMutexLocker locker(&mutex);
+            finished(result);
+        }
+        return result;
+    });
+}
+
+QString BatchRenderer::outputPathFor(const QString &filePath) const
+{
+    const QFileInfo input(filePath);
+    const QDir dir(m_options.outputDir.isEmpty() ? input.absolutePath() : m_options.outputDir);
+    return dir.filePath(input.completeBaseName() + "." + m_options.format);
+}
+
+BatchRenderer::Result BatchRenderer::renderFile(const QString &filePath, bool parallelBands) const
+{
+    Result result;
+    result.inputPath = filePath;
+    result.outputPath = outputPathFor(filePath);
+    QElapsedTimer timer;
+    timer.start();
+
+    // 1. 读取并解码所有图形。连接名按线程区分，各线程同时打开不同的文件
+    QVector<AbstractShape*> shapes;
+    {
+        if (!QFileInfo::exists(filePath)) {
+            result.error = "file not found";
+            return result;
+        }
+        FpaDatabase db(QString("fparender_%1").arg(quintptr(QThread::currentThreadId())));
+        if (!db.open(filePath)) {
+            result.error = "cannot open the file";
+            return result;
+        }
+        const int version = db.schemaVersion();
+        if (!FpaDatabase::isSupportedVersion(version)) {
+            result.error = QString("unsupported schema version %1").arg(version);
+            return result;
+        }
+        db.readShapes([&shapes](const FpaDatabase::ShapeRow &row) {
+            if (AbstractShape *shape = DocumentLoader::decodeShape(row)) {
+                shapes.append(shape);
+            }
+            return true;
+        });
+    }
+    BackgroundPyramid *background = BackgroundPyramid::open(filePath);
+    result.shapeCount = shapes.size();
+
+    ShapeSpatialIndex index;
+    QHash<const AbstractShape*, int> zOrder;
+    QRect bounds;
+    for (int i = 0; i < shapes.size(); ++i) {
+        const QRect damage = shapes.at(i)->getDamageRect();
+        index.insert(shapes.at(i), damage);
+        zOrder.insert(shapes.at(i), i);
+        bounds |= damage;
+    }
+    result.loadMs = timer.restart();
+
+    // 2. 画布尺寸与背景图位置
+    QSize canvas = m_options.canvasSize;
+    if (canvas.isEmpty() && !bounds.isEmpty()) {
+        canvas = QSize(qMax(1, bounds.right() + 1), qMax(1, bounds.bottom() + 1));
+    }
+    if (canvas.isEmpty() && background) {
+        canvas = background->imageSize();
+    }
+    if (canvas.isEmpty()) {
+        result.error = "empty document";
+    } else {
+        SceneExporter::Scene scene;
+        scene.size = canvas;
+        scene.fillColor = Qt::white;
+        if (background) {
+            const QSizeF fitted = QSizeF(background->imageSize()).scaled(QSizeF(canvas), Qt::KeepAspectRatio);
+            scene.background = background;
+            scene.backgroundRect = QRectF(QPointF((canvas.width() - fitted.width()) / 2.0,
+                                                  (canvas.height() - fitted.height()) / 2.0), fitted);
+        }
+        scene.shapesInArea = [&index, &zOrder](const QRect &area) {
+            QVector<AbstractShape*> found = index.query(area);
+            std::sort(found.begin(), found.end(), [&zOrder](const AbstractShape *a, const AbstractShape *b) {
+                return zOrder.value(a) < zOrder.value(b);
+            });
+            return found;
+        };
+        SceneExporter::Options options;
+        options.scale = m_options.scale;
+        options.parallel = parallelBands;
+        if (!SceneExporter(scene, options).write(result.outputPath)) {
+            result.error = "failed to write " + result.outputPath;
+        }
+    }
+    result.renderMs = timer.elapsed();
+
+    qDeleteAll(shapes);
+    delete background;
+    return result;
+}
@@ -0,0 +1,61 @@
+#ifndef BATCHRENDERER_H
+#define BATCHRENDERER_H
+
+// ---------------------------------------------------------------------------
+// 描述: 定义了 BatchRenderer 类，fparender 工具的核心。
+//       每个文件用自己的 SQLite 连接读出全部图形，经 AbstractShape::fromJsonObject 工厂解码，
+//       再由 SceneExporter 画到图像文件中，全程不创建任何窗口。
+//       多个文件在线程池中并行处理；只有一个文件时改为并行栅格化它的各条带。
+//
+//       .fpa 文件不记录画布尺寸。未指定尺寸时画布从原点延伸到所有图形区域的右下角，
+//       与图形界面中窗口足够大时看到的范围一致；背景图与界面中一样按比例适配画布并居中。
+// ---------------------------------------------------------------------------
+
+#include <QSize>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+#include <QVector>
+#include <functional>
+
+class BatchRenderer
+{
+public:
+    struct Options
+    {
+        QString outputDir;                          // 为空时写在输入文件旁边
+        QString format = "png";                     // 输出文件的后缀，决定格式（见 SceneExporter）
+        qreal scale = 1.0;
+        QSize canvasSize;                           // 为空时由图形区域决定
+        int jobs = QThread::idealThreadCount();     // 同时处理的文件数
+    };
+
+    struct Result
+    {
+        QString inputPath;
+        QString outputPath;
+        int shapeCount = 0;
+        qint64 loadMs = 0;      // 读取并解码所有图形
+        qint64 renderMs = 0;    // 栅格化、编码并写入图像
+        QString error;          // 为空表示成功
+
+        bool ok() const { return error.isEmpty(); }
+    };
+
+    explicit BatchRenderer(const Options &options);
+
+    /// @brief 并行处理 files，返回的结果与 files 顺序相同。
+    /// @param finished 每个文件处理完时调用一次（在工作线程中，调用之间互斥），可以为空。
+    QVector<Result> renderAll(const QStringList &files, const std::function<void(const Result &)> &finished = nullptr) const;
+
+    /// @brief 处理一个文件。可以在任何线程中调用。
+    /// @param parallelBands 是否在线程池中并行栅格化各条带。
+    Result renderFile(const QString &filePath, bool parallelBands) const;
+
+    QString outputPathFor(const QString &filePath) const;
+
+private:
+    Options m_options;
+};
+
+#endif // BATCHRENDERER_H
@@ -0,0 +1,20 @@
+# ---------------------------------------------------------------------------
+# fparender：在没有窗口的情况下把 .fpa 文件批量渲染为图像，多个文件在各个核心上并行处理，
+# 并报告每个文件的耗时。用法见 main.cpp 或 fparender --help。
+# ---------------------------------------------------------------------------
+
+QT -= widgets
+
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+TARGET = fparender
+
+include(../../fishplatecore.pri)
+
+SOURCES += \
+    batchrenderer.cpp \
+    main.cpp
+
+HEADERS += \
+    batchrenderer.h
@@ -0,0 +1,145 @@
+// ---------------------------------------------------------------------------
+// 描述: fparender 的入口点。把一个或多个 .fpa 文件渲染成图像文件，不需要显示器。
+//
+//       用法: fparender [选项] <文件或目录>...
+//       目录中的所有 .fpa 文件（不含子目录）都会被渲染。
+//       每个文件输出一行以制表符分隔的计时：文件、图形数、读取毫秒数、渲染毫秒数、结果；
+//       使用 --json 时改为在最后输出一个 JSON 数组。汇总信息写到标准错误。
+//       所有文件都成功时返回 0，有文件失败时返回 1，参数错误时返回 2。
+// ---------------------------------------------------------------------------
+
+#include "batchrenderer.h"
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QGuiApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <cstdio>
+
+namespace {
+
+QStringList collectInputs(const QStringList &arguments)
+{
+    QStringList files;
+    for (const QString &argument : arguments) {
+        const QFileInfo info(argument);
+        if (info.isDir()) {
+            const QDir dir(argument);
+            for (const QString &name : dir.entryList({ "*.fpa" }, QDir::Files, QDir::Name)) {
+                files.append(dir.filePath(name));
+            }
+        } else {
+            files.append(argument);
+        }
+    }
+    return files;
+}
+
+QJsonObject toJson(const BatchRenderer::Result &result)
+{
+    QJsonObject object;
+    object["file"] = result.inputPath;
+    object["output"] = result.outputPath;
+    object["shapes"] = result.shapeCount;
+    object["load_ms"] = result.loadMs;
+    object["render_ms"] = result.renderMs;
+    object["ok"] = result.ok();
+    if (!result.ok()) {
+        object["error"] = result.error;
+    }
+    return object;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    // 不连接任何显示服务器
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QGuiApplication app(argc, argv);
+    QCoreApplication::setApplicationName("fparender");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Render FishplateArtboard documents (.fpa) to image files.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("inputs", ".fpa files or directories containing them.", "<file|dir>...");
+    const QCommandLineOption outputOption({ "o", "output" }, "Write images into <dir> instead of next to the inputs.", "dir");
+    const QCommandLineOption formatOption({ "f", "format" }, "Output format: png, jpg, bmp, tif (default png).", "format", "png");
+    const QCommandLineOption scaleOption({ "s", "scale" }, "Output pixels per document pixel (default 1).", "factor", "1");
+    const QCommandLineOption sizeOption("size", "Canvas size in document pixels, e.g. 1920x1080 (default: fit all shapes).", "WxH");
+    const QCommandLineOption jobsOption({ "j", "jobs" }, "Number of files rendered at the same time.", "n",
+                                        QString::number(QThread::idealThreadCount()));
+    const QCommandLineOption jsonOption("json", "Print the results as one JSON array.");
+    parser.addOptions({ outputOption, formatOption, scaleOption, sizeOption, jobsOption, jsonOption });
+    parser.process(app);
+
+    BatchRenderer::Options options;
+    bool ok = true;
+    options.format = parser.value(formatOption).toLower();
+    options.scale = parser.value(scaleOption).toDouble(&ok);
+    if (!ok || options.scale <= 0) {
+        fprintf(stderr, "fparender: invalid scale '%s'\n", qPrintable(parser.value(scaleOption)));
+        return 2;
+    }
+    options.jobs = parser.value(jobsOption).toInt(&ok);
+    if (!ok || options.jobs < 1) {
+        fprintf(stderr, "fparender: invalid job count '%s'\n", qPrintable(parser.value(jobsOption)));
+        return 2;
+    }
+    if (parser.isSet(sizeOption)) {
+        const QRegularExpressionMatch match = QRegularExpression("^(\\d+)[xX](\\d+)$").match(parser.value(sizeOption));
+        options.canvasSize = match.hasMatch() ? QSize(match.captured(1).toInt(), match.captured(2).toInt()) : QSize();
+        if (options.canvasSize.isEmpty()) {
+            fprintf(stderr, "fparender: invalid size '%s'\n", qPrintable(parser.value(sizeOption)));
+            return 2;
+        }
+    }
+    if (parser.isSet(outputOption)) {
+        options.outputDir = parser.value(outputOption);
+        if (!QDir().mkpath(options.outputDir)) {
+            fprintf(stderr, "fparender: cannot create '%s'\n", qPrintable(options.outputDir));
+            return 2;
+        }
+    }
+    const QStringList files = collectInputs(parser.positionalArguments());
+    if (files.isEmpty()) {
+        parser.showHelp(2);
+    }
+
+    const bool json = parser.isSet(jsonOption);
+    if (!json) {
+        printf("file\tshapes\tload_ms\trender_ms\tresult\n");
+        fflush(stdout);
+    }
+    QElapsedTimer wallClock;
+    wallClock.start();
+    const QVector<BatchRenderer::Result> results = BatchRenderer(options).renderAll(files, [json](const BatchRenderer::Result &result) {
+        if (!json) {
+            printf("%s\t%d\t%lld\t%lld\t%s\n", qPrintable(result.inputPath), result.shapeCount, result.loadMs, result.renderMs,
+                   result.ok() ? "ok" : qPrintable(result.error));
+            fflush(stdout);
+        }
+    });
+    const qint64 elapsed = wallClock.elapsed();
+
+    int failed = 0;
+    qint64 shapes = 0;
+    QJsonArray array;
+    for (const BatchRenderer::Result &result : results) {
+        failed += result.ok() ? 0 : 1;
+        shapes += result.shapeCount;
+        array.append(toJson(result));
+    }
+    if (json) {
+        printf("%s\n", QJsonDocument(array).toJson(QJsonDocument::Indented).constData());
+    }
+    fprintf(stderr, "fparender: %lld file(s), %lld shape(s), %d failed, %lld ms with %d job(s)\n",
+            qint64(results.size()), shapes, failed, elapsed, options.jobs);
+    return failed ? 1 : 0;
+}
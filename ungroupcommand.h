@@ -6,19 +6,20 @@
 
 class AbstractShape;
 class GroupShape;
-class ArtboardView;
+class ArtboardDocument;
 
 class UngroupCommand : public AbstractCommand
 {
 public:
-    UngroupCommand(GroupShape *group, ArtboardView *view);
+    UngroupCommand(GroupShape *group, ArtboardDocument *document);
     ~UngroupCommand() override;
 
     void execute() override;
     void undo() override;
+    void collectShapes(QSet<AbstractShape*> *shapes) const override;
 
 private:
-    ArtboardView *m_view;
+    ArtboardDocument *m_document;
     GroupShape *m_group; // 要取消编组的组对象
     QList<AbstractShape*> m_children; // 用于撤销时恢复
     int m_originalGroupIndex;